@@ -4,6 +4,7 @@
 #include "basesolver.hpp"
 
 #include <complex>
+#include <fstream>
 #include <mfem.hpp>
 #include <nlohmann/json.hpp>
 #include "fem/domainpostoperator.hpp"
@@ -11,6 +12,7 @@
 #include "fem/surfacepostoperator.hpp"
 #include "utils/communication.hpp"
 #include "utils/filesystem.hpp"
+#include "utils/geodata.hpp"
 #include "utils/iodata.hpp"
 #include "utils/timer.hpp"
 
@@ -82,6 +84,128 @@ BaseSolver::BaseSolver(const IoData &iodata_, bool root_, int size, int num_thre
   }
 }
 
+void BaseSolver::SolveEstimateMarkRefine(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+                                         Timer &timer) const
+{
+  const auto &refinement = iodata.model.refinement;
+  int it = 0;
+  while (true)
+  {
+    // Solve the problem on the current mesh.
+    auto [indicator, ndof] = Solve(mesh, timer);
+    if (refinement.max_it == 0)
+    {
+      break;
+    }
+    if (indicator.Empty())
+    {
+      Mpi::Warning("Adaptive mesh refinement is not supported for this problem type!\n");
+      break;
+    }
+
+    // Check for convergence, otherwise mark and refine the mesh. The discretization and
+    // geometric multigrid hierarchy are reconstructed on the refined mesh hierarchy.
+    MPI_Comm comm = mesh.back()->GetComm();
+    const double err = indicator.GetGlobalErrorEstimate(comm);
+    Mpi::Print(comm,
+               "\nAdaptive mesh refinement iteration {:d}: Error estimate = {:.3e}, "
+               "problem size = {:d}\n",
+               it, err, ndof);
+    if (err <= refinement.tol)
+    {
+      Mpi::Print(comm, " Error estimate tolerance reached\n");
+      break;
+    }
+    if (it >= refinement.max_it)
+    {
+      Mpi::Print(comm, " Maximum number of iterations reached\n");
+      break;
+    }
+    if (refinement.max_size > 0 && ndof >= refinement.max_size)
+    {
+      Mpi::Print(comm, " Maximum problem size reached\n");
+      break;
+    }
+    timer.Lap();
+    if (!mesh::AdaptMesh(iodata, indicator.GetLocalErrorIndicators(), mesh,
+                         [this, &mesh]() { UpdateSolution(*mesh.back()); }))
+    {
+      break;
+    }
+    mesh::PrintMeshInfo(iodata, mesh);
+    timer.init_time += timer.Lap();
+    it++;
+  }
+}
+
+void BaseSolver::SaveSolution(const mfem::ParFiniteElementSpace &fespace,
+                              const std::vector<mfem::Vector> &x) const
+{
+  if (iodata.model.refinement.max_it == 0)
+  {
+    return;
+  }
+  amr_sol.clear();
+  amr_fespace.reset();
+  amr_fec.reset(mfem::FiniteElementCollection::New(fespace.FEColl()->Name()));
+  amr_fespace =
+      std::make_unique<mfem::ParFiniteElementSpace>(fespace.GetParMesh(), amr_fec.get());
+  for (const auto &v : x)
+  {
+    amr_sol.push_back(std::make_unique<mfem::ParGridFunction>(amr_fespace.get()));
+    amr_sol.back()->SetFromTrueDofs(v);
+  }
+}
+
+void BaseSolver::UpdateSolution(mfem::ParMesh &mesh) const
+{
+  if (!amr_fespace)
+  {
+    return;
+  }
+  if (amr_fespace->GetParMesh() != &mesh)
+  {
+    // The finest mesh is a new level copied from the previous finest mesh, which has the
+    // same degrees of freedom.
+    auto fespace = std::make_unique<mfem::ParFiniteElementSpace>(&mesh, amr_fec.get());
+    for (auto &sol : amr_sol)
+    {
+      auto new_sol = std::make_unique<mfem::ParGridFunction>(fespace.get());
+      static_cast<mfem::Vector &>(*new_sol) = *sol;
+      sol = std::move(new_sol);
+    }
+    amr_fespace = std::move(fespace);
+    return;
+  }
+
+  // Interpolate the solution to the refined mesh, or redistribute it after rebalancing,
+  // using the transfer operator of the updated finite element space.
+  amr_fespace->Update();
+  for (auto &sol : amr_sol)
+  {
+    sol->Update();
+  }
+}
+
+bool BaseSolver::GetInitialGuess(int i, const mfem::Array<int> &dbc_tdof_list,
+                                 mfem::Vector &x) const
+{
+  if (i >= static_cast<int>(amr_sol.size()))
+  {
+    return false;
+  }
+  mfem::Vector x0;
+  amr_sol[i]->GetTrueDofs(x0);
+  MFEM_VERIFY(x0.Size() == x.Size(),
+              "Initial guess from the previous mesh does not match the solution size!");
+  for (auto tdof : dbc_tdof_list)
+  {
+    x0(tdof) = x(tdof);
+  }
+  x = x0;
+  return true;
+}
+
 void BaseSolver::SaveMetadata(const mfem::ParFiniteElementSpace &fespace) const
 {
   if (post_dir.length() == 0)
@@ -203,12 +327,13 @@ void BaseSolver::PostprocessDomains(const PostOperator &postop, const std::strin
 
   // Write the Q-factors due to bulk dielectric loss.
   std::vector<EpsData> eps_data;
-  eps_data.reserve(postop.GetDomainPostOp().GetEps().size());
-  for (const auto &[idx, data] : postop.GetDomainPostOp().GetEps())
+  if (postop.GetDomainPostOp().SizeEps() > 0)
   {
-    const double pl = postop.GetBulkParticipation(idx, E_elec + E_cap);
-    const double Ql = postop.GetBulkQualityFactor(idx, E_elec + E_cap);
-    eps_data.push_back({idx, pl, Ql});
+    eps_data.reserve(postop.GetDomainPostOp().SizeEps());
+    for (const auto &[idx, pQ] : postop.GetBulkParticipations(E_elec + E_cap))
+    {
+      eps_data.push_back({idx, pQ.first, pQ.second});
+    }
   }
   if (root && !eps_data.empty())
   {
@@ -259,14 +384,16 @@ void BaseSolver::PostprocessSurfaces(const PostOperator &postop, const std::stri
 
   // Write the Q-factors due to interface dielectric loss.
   std::vector<EpsData> eps_data;
-  eps_data.reserve(postop.GetSurfacePostOp().GetEps().size());
-  for (const auto &[idx, data] : postop.GetSurfacePostOp().GetEps())
+  if (postop.GetSurfacePostOp().SizeEps() > 0)
   {
-    const double pl = postop.GetInterfaceParticipation(idx, E_elec);
-    const double tandelta = postop.GetSurfacePostOp().GetInterfaceLossTangent(idx);
-    const double Ql =
-        (pl == 0.0 || tandelta == 0.0) ? mfem::infinity() : 1.0 / (tandelta * pl);
-    eps_data.push_back({idx, pl, Ql});
+    eps_data.reserve(postop.GetSurfacePostOp().SizeEps());
+    for (const auto &[idx, pl] : postop.GetInterfaceParticipations(E_elec))
+    {
+      const double tandelta = postop.GetSurfacePostOp().GetInterfaceLossTangent(idx);
+      const double Ql =
+          (pl == 0.0 || tandelta == 0.0) ? mfem::infinity() : 1.0 / (tandelta * pl);
+      eps_data.push_back({idx, pl, Ql});
+    }
   }
   if (root && !eps_data.empty())
   {
@@ -301,12 +428,15 @@ void BaseSolver::PostprocessSurfaces(const PostOperator &postop, const std::stri
 
   // Write the surface capacitance (integrated charge).
   std::vector<CapData> cap_data;
-  cap_data.reserve(postop.GetSurfacePostOp().GetCap().size());
-  for (const auto &[idx, data] : postop.GetSurfacePostOp().GetCap())
+  if (postop.GetSurfacePostOp().SizeCap() > 0)
   {
-    const double Cij = (std::abs(Vinc) > 0.0) ? postop.GetSurfaceCharge(idx) / Vinc : 0.0;
-    cap_data.push_back(
-        {idx, iodata.DimensionalizeValue(IoData::ValueType::CAPACITANCE, Cij)});
+    cap_data.reserve(postop.GetSurfacePostOp().SizeCap());
+    for (const auto &[idx, Q] : postop.GetSurfaceCharges())
+    {
+      const double Cij = (std::abs(Vinc) > 0.0) ? Q / Vinc : 0.0;
+      cap_data.push_back(
+          {idx, iodata.DimensionalizeValue(IoData::ValueType::CAPACITANCE, Cij)});
+    }
   }
   if (root && !cap_data.empty())
   {
@@ -339,12 +469,15 @@ void BaseSolver::PostprocessSurfaces(const PostOperator &postop, const std::stri
 
   // Write the surface inductance (integrated flux).
   std::vector<IndData> ind_data;
-  ind_data.reserve(postop.GetSurfacePostOp().GetInd().size());
-  for (const auto &[idx, data] : postop.GetSurfacePostOp().GetInd())
+  if (postop.GetSurfacePostOp().SizeInd() > 0)
   {
-    const double Mij = (std::abs(Iinc) > 0.0) ? postop.GetSurfaceFlux(idx) / Iinc : 0.0;
-    ind_data.push_back(
-        {idx, iodata.DimensionalizeValue(IoData::ValueType::INDUCTANCE, Mij)});
+    ind_data.reserve(postop.GetSurfacePostOp().SizeInd());
+    for (const auto &[idx, Phi] : postop.GetSurfaceFluxes())
+    {
+      const double Mij = (std::abs(Iinc) > 0.0) ? Phi / Iinc : 0.0;
+      ind_data.push_back(
+          {idx, iodata.DimensionalizeValue(IoData::ValueType::INDUCTANCE, Mij)});
+    }
   }
   if (root && !ind_data.empty())
   {
@@ -393,6 +526,8 @@ void BaseSolver::PostprocessProbes(const PostOperator &postop, const std::string
     return;
   }
   const bool has_imaginary = postop.HasImaginary();
+  std::vector<std::complex<double>> vE, vB;
+  postop.ProbeFields(vE, vB);
   for (int f = 0; f < 2; f++)
   {
     // Probe data is ordered as [Fx1, Fy1, Fz1, Fx2, Fy2, Fz2, ...].
@@ -406,8 +541,7 @@ void BaseSolver::PostprocessProbes(const PostOperator &postop, const std::string
     }
     std::vector<ProbeData> probe_data;
     probe_data.reserve(postop.GetProbes().size());
-    const std::vector<std::complex<double>> vF =
-        (f == 0) ? postop.ProbeEField() : postop.ProbeBField();
+    const std::vector<std::complex<double>> &vF = (f == 0) ? vE : vB;
     const int dim = vF.size() / postop.GetProbes().size();
     int i = 0;
     for (const auto &idx : postop.GetProbes())
@@ -543,6 +677,68 @@ void BaseSolver::PostprocessProbes(const PostOperator &postop, const std::string
 #endif
 }
 
+void BaseSolver::PostprocessSamples(const PostOperator &postop, int step,
+                                    double time) const
+{
+  // If sampling regions have been specified for postprocessing, sample the fields on the
+  // grids of points and write out to disk. Each region writes its point coordinates once,
+  // in mesh length units, and then appends a record for each step to a binary file for
+  // each field. Each record contains the time (or frequency, mode, or terminal index)
+  // followed by the columns of values for each vector component, with real and imaginary
+  // parts in separate columns. All values are written as 64-bit floating point numbers.
+  if (post_dir.length() == 0 || postop.GetSamplingRegions().empty())
+  {
+    return;
+  }
+  std::vector<std::vector<double>> vE, vB;
+  postop.SampleFields(vE, vB);
+  if (!root)
+  {
+    return;
+  }
+  const int npts = postop.GetNumSamplingPoints();
+  auto WriteColumn = [](std::ofstream &fo, const double *data, int n)
+  { fo.write(reinterpret_cast<const char *>(data), n * sizeof(double)); };
+  for (const auto &region : postop.GetSamplingRegions())
+  {
+    const std::string prefix = post_dir + "sample-" + std::to_string(region.idx);
+    if (step == 0)
+    {
+      const double mesh_Lc0 =
+          iodata.DimensionalizeValue(IoData::ValueType::LENGTH, 1.0 / iodata.model.L0);
+      std::vector<double> xyz(3 * region.npts);
+      for (int i = 0; i < region.npts; i++)
+      {
+        const std::array<double, 3> x = region.GetPoint(i);
+        for (int d = 0; d < 3; d++)
+        {
+          xyz[d * region.npts + i] = x[d] * mesh_Lc0;
+        }
+      }
+      std::ofstream fo(prefix + "-xyz.bin", std::ios::binary | std::ios::trunc);
+      WriteColumn(fo, xyz.data(), 3 * region.npts);
+    }
+    for (const auto &[F, vF] : {std::make_pair("E", &vE), std::make_pair("B", &vB)})
+    {
+      if (vF->empty())
+      {
+        continue;
+      }
+      std::ofstream fo(prefix + "-" + F + ".bin",
+                       std::ios::binary | ((step > 0) ? std::ios::app : std::ios::trunc));
+      WriteColumn(fo, &time, 1);
+      const int dim = static_cast<int>(vF->front().size()) / npts;
+      for (int d = 0; d < dim; d++)
+      {
+        for (const auto &v : *vF)
+        {
+          WriteColumn(fo, v.data() + d * npts + region.offset, region.npts);
+        }
+      }
+    }
+  }
+}
+
 void BaseSolver::PostprocessFields(const PostOperator &postop, int step, double time) const
 {
   // Save the computed fields in parallel in format for viewing with ParaView.
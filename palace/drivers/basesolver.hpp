@@ -6,14 +6,21 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <fmt/os.h>
+#include "fem/errorestimator.hpp"
 
 namespace mfem
 {
 
+template <typename T>
+class Array;
+class FiniteElementCollection;
 class ParFiniteElementSpace;
+class ParGridFunction;
 class ParMesh;
+class Vector;
 
 }  // namespace mfem
 
@@ -51,6 +58,16 @@ protected:
   };
   const Table table;
 
+  // Solution vectors from the previous adaptive mesh refinement iteration, stored as grid
+  // functions on the finest mesh and transferred to the refined mesh for use as initial
+  // guesses in the next iteration.
+  mutable std::unique_ptr<mfem::FiniteElementCollection> amr_fec;
+  mutable std::unique_ptr<mfem::ParFiniteElementSpace> amr_fespace;
+  mutable std::vector<std::unique_ptr<mfem::ParGridFunction>> amr_sol;
+
+  // Update the stored solution vectors after a change to the finest mesh.
+  void UpdateSolution(mfem::ParMesh &mesh) const;
+
   // Helper method for creating/appending to output files.
   fmt::ostream OutputFile(const std::string &path, bool append) const
   {
@@ -68,15 +85,34 @@ protected:
                            double Iinc) const;
   void PostprocessProbes(const PostOperator &postop, const std::string &name, int step,
                          double time) const;
+  void PostprocessSamples(const PostOperator &postop, int step, double time) const;
   void PostprocessFields(const PostOperator &postop, int step, double time) const;
 
+  // Save the solution vectors (true dofs) on the given space for the next adaptive mesh
+  // refinement iteration, and get the transferred solution vector with the given index as
+  // an initial guess, keeping the values of the given vector for the essential true dofs.
+  // Returns false if there is no solution vector with the index.
+  void SaveSolution(const mfem::ParFiniteElementSpace &fespace,
+                    const std::vector<mfem::Vector> &x) const;
+  bool GetInitialGuess(int i, const mfem::Array<int> &dbc_tdof_list, mfem::Vector &x) const;
+
+  // Solve the problem on the given mesh hierarchy, returning the element-wise error
+  // indicators (empty when adaptive mesh refinement is not enabled or supported) and the
+  // global number of degrees of freedom.
+  virtual std::pair<ErrorIndicator, long long int>
+  Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const = 0;
+
 public:
   BaseSolver(const IoData &iodata_, bool root_, int size = 0, int num_thread = 0,
              const char *git_tag = nullptr);
   virtual ~BaseSolver() = default;
 
-  virtual void Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-                     Timer &timer) const = 0;
+  // Solve the problem, with optional adaptive mesh refinement: solve, estimate the error,
+  // mark the elements with the largest errors, and refine the mesh, until the error
+  // estimate tolerance, the maximum number of iterations, or the maximum problem size is
+  // reached.
+  void SolveEstimateMarkRefine(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+                               Timer &timer) const;
 
   // These methods write different simulation metadata to a JSON file in post_dir.
   void SaveMetadata(const mfem::ParFiniteElementSpace &fespace) const;
@@ -22,12 +22,13 @@
 namespace palace
 {
 
-void DrivenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-                         Timer &timer) const
+std::pair<ErrorIndicator, long long int>
+DrivenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const
 {
   // Set up the spatial discretization and frequency sweep.
   timer.Lap();
   SpaceOperator spaceop(iodata, mesh);
+  spaceop.SetReuseAssembly(true);
   int nstep = GetNumSteps(iodata.solver.driven.min_f, iodata.solver.driven.max_f,
                           iodata.solver.driven.delta_f);
   int step0 = (iodata.solver.driven.rst > 0) ? iodata.solver.driven.rst - 1 : 0;
@@ -93,20 +94,25 @@ void DrivenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
   }
   Mpi::Print("\n");
 
-  // Main frequency sweep loop.
+  // Main frequency sweep loop. Error indicators for adaptive mesh refinement are
+  // accumulated over all frequency samples.
+  ErrorIndicator indicator;
   if (adaptive)
   {
-    SweepAdaptive(spaceop, postop, nstep, step0, omega0, delta_omega, timer);
+    SweepAdaptive(spaceop, postop, nstep, step0, omega0, delta_omega, indicator, timer);
   }
   else
   {
-    SweepUniform(spaceop, postop, nstep, step0, omega0, delta_omega, timer);
+    SweepUniform(spaceop, postop, nstep, step0, omega0, delta_omega, indicator, timer);
   }
+  postop.FlushFields();
+  timer.io_time += timer.Lap();
+  return {indicator, spaceop.GetNDSpace().GlobalTrueVSize()};
 }
 
 void DrivenSolver::SweepUniform(SpaceOperator &spaceop, PostOperator &postop, int nstep,
                                 int step0, double omega0, double delta_omega,
-                                Timer &timer) const
+                                ErrorIndicator &indicator, Timer &timer) const
 {
   // Construct the system matrices defining the linear operator. PEC boundaries are handled
   // simply by setting diagonal entries of the system matrix for the corresponding dofs.
@@ -136,6 +142,21 @@ void DrivenSolver::SweepUniform(SpaceOperator &spaceop, PostOperator &postop, in
   petsc::PetscParVector RHS(*NegCurl), E(*NegCurl), B(*NegCurl, true);
   E.SetZero();
   B.SetZero();
+
+  // With adaptive mesh refinement, start the first frequency step from the solution on the
+  // previous mesh.
+  std::vector<mfem::Vector> x(2);
+  for (auto &v : x)
+  {
+    v.SetSize(spaceop.GetNDSpace().GetTrueVSize());
+    v = 0.0;
+  }
+  if (GetInitialGuess(0, spaceop.GetDbcTDofList(), x[0]) &&
+      GetInitialGuess(1, spaceop.GetDbcTDofList(), x[1]))
+  {
+    E.SetFromVectors(x[0], x[1]);
+    ksp.SetNonzeroInitialGuess(true);
+  }
   timer.construct_time += timer.Lap();
 
   // Main frequency sweep loop.
@@ -163,6 +184,14 @@ void DrivenSolver::SweepUniform(SpaceOperator &spaceop, PostOperator &postop, in
 
     Mpi::Print("\n");
     ksp.Mult(RHS, E);
+    if (step == step0)
+    {
+      // Save the solution at the first frequency for the next adaptive mesh refinement
+      // iteration, and use the configured initial guess for the remaining steps.
+      E.GetToVectors(x[0], x[1]);
+      SaveSolution(spaceop.GetNDSpace(), x);
+      ksp.SetNonzeroInitialGuess(iodata.solver.linear.ksp_initial_guess);
+    }
     timer.solve_time += timer.Lap();
 
     double E_elec = 0.0, E_mag = 0.0;
@@ -170,6 +199,10 @@ void DrivenSolver::SweepUniform(SpaceOperator &spaceop, PostOperator &postop, in
     postop.SetEGridFunction(E);
     postop.SetBGridFunction(B);
     postop.UpdatePorts(spaceop.GetLumpedPortOp(), spaceop.GetWavePortOp(), omega);
+    if (iodata.model.refinement.max_it > 0)
+    {
+      postop.AddErrorIndicator(indicator);
+    }
     // E.Print();
     Mpi::Print(" Sol. ||E|| = {:.6e} (||RHS|| = {:.6e})\n", E.Norml2(), RHS.Norml2());
     if (!iodata.solver.driven.only_port_post)
@@ -196,7 +229,7 @@ void DrivenSolver::SweepUniform(SpaceOperator &spaceop, PostOperator &postop, in
 
 void DrivenSolver::SweepAdaptive(SpaceOperator &spaceop, PostOperator &postop, int nstep,
                                  int step0, double omega0, double delta_omega,
-                                 Timer &timer) const
+                                 ErrorIndicator &indicator, Timer &timer) const
 {
   // Configure default parameters if not specified.
   double offline_tol = iodata.solver.driven.adaptive_tol;
@@ -327,6 +360,10 @@ void DrivenSolver::SweepAdaptive(SpaceOperator &spaceop, PostOperator &postop, i
     postop.SetEGridFunction(E);
     postop.SetBGridFunction(B);
     postop.UpdatePorts(spaceop.GetLumpedPortOp(), spaceop.GetWavePortOp(), omega);
+    if (iodata.model.refinement.max_it > 0)
+    {
+      postop.AddErrorIndicator(indicator);
+    }
     // E.Print();
     Mpi::Print(" Sol. ||E|| = {:.6e}\n", E.Norml2());
     if (!iodata.solver.driven.only_port_post)
@@ -385,6 +422,7 @@ void DrivenSolver::Postprocess(const PostOperator &postop,
     PostprocessSurfaces(postop, "f (GHz)", step, freq, E_elec + E_cap, E_mag + E_ind, 1.0,
                         1.0);
     PostprocessProbes(postop, "f (GHz)", step, freq);
+    PostprocessSamples(postop, step, freq);
   }
   if (iodata.solver.driven.delta_post > 0 && step % iodata.solver.driven.delta_post == 0)
   {
@@ -35,9 +35,11 @@ private:
   int GetNumSteps(double start, double end, double delta) const;
 
   void SweepUniform(SpaceOperator &spaceop, PostOperator &postop, int nstep, int step0,
-                    double omega0, double delta_omega, Timer &timer) const;
+                    double omega0, double delta_omega, ErrorIndicator &indicator,
+                    Timer &timer) const;
   void SweepAdaptive(SpaceOperator &spaceop, PostOperator &postop, int nstep, int step0,
-                     double omega0, double delta_omega, Timer &timer) const;
+                     double omega0, double delta_omega, ErrorIndicator &indicator,
+                     Timer &timer) const;
 
   void Postprocess(const PostOperator &postop, const LumpedPortOperator &lumped_port_op,
                    const WavePortOperator &wave_port_op,
@@ -55,15 +57,15 @@ private:
                               const WavePortOperator &wave_port_op, int step,
                               double omega) const;
 
+  std::pair<ErrorIndicator, long long int>
+  Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const override;
+
 public:
   DrivenSolver(const IoData &iodata, bool root, int size = 0, int num_thread = 0,
                const char *git_tag = nullptr)
     : BaseSolver(iodata, root, size, num_thread, git_tag)
   {
   }
-
-  void Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-             Timer &timer) const override;
 };
 
 }  // namespace palace
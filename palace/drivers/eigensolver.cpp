@@ -25,8 +25,8 @@ namespace palace
 
 using namespace std::complex_literals;
 
-void EigenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-                        Timer &timer) const
+std::pair<ErrorIndicator, long long int>
+EigenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const
 {
   // Construct and extract the system matrices defining the eigenvalue problem. The diagonal
   // values for the mass matrix PEC dof shift the Dirichlet eigenvalues out of the
@@ -303,11 +303,25 @@ void EigenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
   }
 
   // Set up the initial space for the eigenvalue solve. Satisfies boundary conditions and is
-  // projected appropriately.
-  if (iodata.solver.eigenmode.init_v0)
+  // projected appropriately. With adaptive mesh refinement, the first eigenvector on the
+  // previous mesh is used.
+  std::vector<mfem::Vector> x(2);
+  for (auto &v : x)
+  {
+    v.SetSize(spaceop.GetNDSpace().GetTrueVSize());
+    v = 0.0;
+  }
+  const bool init_guess = GetInitialGuess(0, spaceop.GetDbcTDofList(), x[0]) &&
+                          GetInitialGuess(1, spaceop.GetDbcTDofList(), x[1]);
+  if (iodata.solver.eigenmode.init_v0 || init_guess)
   {
     petsc::PetscParVector v0(*K);
-    if (iodata.solver.eigenmode.init_v0_const)
+    if (init_guess)
+    {
+      Mpi::Print(" Using eigenvector from previous mesh as starting vector\n");
+      v0.SetFromVectors(x[0], x[1]);
+    }
+    else if (iodata.solver.eigenmode.init_v0_const)
     {
       Mpi::Print(" Using constant starting vector\n");
       v0 = 1.0;
@@ -349,8 +363,10 @@ void EigenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
   }
   timer.solve_time += timer.Lap();
 
-  // Postprocess the results.
+  // Postprocess the results. Error indicators for adaptive mesh refinement are accumulated
+  // over the requested number of eigenmodes.
   const auto io_time_prev = timer.io_time;
+  ErrorIndicator indicator;
   for (int i = 0; i < num_conv; i++)
   {
     // Get the eigenvalue and relative error.
@@ -380,16 +396,28 @@ void EigenSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
 
     // Set the internal GridFunctions in PostOperator for all postprocessing operations.
     eigen->GetEigenvector(i, E);
+    if (i == 0)
+    {
+      E.GetToVectors(x[0], x[1]);
+      SaveSolution(spaceop.GetNDSpace(), x);
+    }
     PostOperator::GetBField(omega, *NegCurl, E, B);
     postop.SetEGridFunction(E);
     postop.SetBGridFunction(B);
     postop.UpdatePorts(spaceop.GetLumpedPortOp(), omega.real());
+    if (iodata.model.refinement.max_it > 0 && i < iodata.solver.eigenmode.n)
+    {
+      postop.AddErrorIndicator(indicator);
+    }
 
     // Postprocess the mode.
     Postprocess(postop, spaceop.GetLumpedPortOp(), i, omega, error1, error2, num_conv,
                 timer);
   }
   timer.postpro_time += timer.Lap() - (timer.io_time - io_time_prev);
+  postop.FlushFields();
+  timer.io_time += timer.Lap();
+  return {indicator, spaceop.GetNDSpace().GlobalTrueVSize()};
 }
 
 void EigenSolver::Postprocess(const PostOperator &postop,
@@ -411,6 +439,7 @@ void EigenSolver::Postprocess(const PostOperator &postop,
   PostprocessDomains(postop, "m", i, i + 1, E_elec, E_mag, E_cap, E_ind);
   PostprocessSurfaces(postop, "m", i, i + 1, E_elec + E_cap, E_mag + E_ind, 1.0, 1.0);
   PostprocessProbes(postop, "m", i, i + 1);
+  PostprocessSamples(postop, i, i + 1);
   if (i < iodata.solver.eigenmode.n_post)
   {
     auto t0 = timer.Now();
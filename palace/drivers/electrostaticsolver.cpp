@@ -15,8 +15,9 @@
 namespace palace
 {
 
-void ElectrostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-                                Timer &timer) const
+std::pair<ErrorIndicator, long long int>
+ElectrostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+                           Timer &timer) const
 {
   // Construct the system matrix defining the linear operator. Dirichlet boundaries are
   // handled eliminating the rows and columns of the system matrix for the corresponding
@@ -93,6 +94,10 @@ void ElectrostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mes
     Mpi::Print("\n");
     V[step].SetSize(RHS.Size());
     laplaceop.GetExcitationVector(idx, *K.back(), *Ke.back(), V[step], RHS);
+
+    // With adaptive mesh refinement, start from the solution on the previous mesh, keeping
+    // the prescribed values on the Dirichlet boundaries.
+    pcg.iterative_mode = GetInitialGuess(step, laplaceop.GetDbcTDofList(), V[step]);
     timer.construct_time += timer.Lap();
 
     pcg.Mult(RHS, V[step]);
@@ -117,13 +122,18 @@ void ElectrostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mes
   // Postprocess the capacitance matrix from the computed field solutions.
   const auto io_time_prev = timer.io_time;
   SaveMetadata(nstep, ksp_it);
-  Postprocess(laplaceop, postop, V, timer);
+  SaveSolution(laplaceop.GetH1Space(), V);
+  ErrorIndicator indicator;
+  Postprocess(laplaceop, postop, V, indicator, timer);
   timer.postpro_time += timer.Lap() - (timer.io_time - io_time_prev);
+  postop.FlushFields();
+  timer.io_time += timer.Lap();
+  return {indicator, laplaceop.GetH1Space().GlobalTrueVSize()};
 }
 
 void ElectrostaticSolver::Postprocess(LaplaceOperator &laplaceop, PostOperator &postop,
                                       const std::vector<mfem::Vector> &V,
-                                      Timer &timer) const
+                                      ErrorIndicator &indicator, Timer &timer) const
 {
   // Postprocess the Maxwell capacitance matrix. See p. 97 of the COMSOL AC/DC Module manual
   // for the associated formulas based on the electric field energy based on a unit voltage
@@ -147,10 +157,15 @@ void ElectrostaticSolver::Postprocess(LaplaceOperator &laplaceop, PostOperator &
     PostOperator::GetEField(*NegGrad, V[i], E);
     postop.SetEGridFunction(E);
     postop.SetVGridFunction(V[i]);
+    if (iodata.model.refinement.max_it > 0)
+    {
+      postop.AddErrorIndicator(indicator);
+    }
     double Ue = postop.GetEFieldEnergy();
     PostprocessDomains(postop, "i", i, idx, Ue, 0.0, 0.0, 0.0);
     PostprocessSurfaces(postop, "i", i, idx, Ue, 0.0, 1.0, 0.0);
     PostprocessProbes(postop, "i", i, idx);
+    PostprocessSamples(postop, i, idx);
     if (i < iodata.solver.electrostatic.n_post)
     {
       auto t0 = timer.Now();
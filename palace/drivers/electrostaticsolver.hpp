@@ -35,21 +35,22 @@ class ElectrostaticSolver : public BaseSolver
 {
 private:
   void Postprocess(LaplaceOperator &laplaceop, PostOperator &postop,
-                   const std::vector<mfem::Vector> &V, Timer &timer) const;
+                   const std::vector<mfem::Vector> &V, ErrorIndicator &indicator,
+                   Timer &timer) const;
 
   void PostprocessTerminals(const std::map<int, mfem::Array<int>> &terminal_sources,
                             const mfem::DenseMatrix &C, const mfem::DenseMatrix &Cinv,
                             const mfem::DenseMatrix &Cm) const;
 
+  std::pair<ErrorIndicator, long long int>
+  Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const override;
+
 public:
   ElectrostaticSolver(const IoData &iodata, bool root, int size = 0, int num_thread = 0,
                       const char *git_tag = nullptr)
     : BaseSolver(iodata, root, size, num_thread, git_tag)
   {
   }
-
-  void Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-             Timer &timer) const override;
 };
 
 }  // namespace palace
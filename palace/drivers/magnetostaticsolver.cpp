@@ -16,8 +16,9 @@
 namespace palace
 {
 
-void MagnetostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-                                Timer &timer) const
+std::pair<ErrorIndicator, long long int>
+MagnetostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+                           Timer &timer) const
 {
   // Construct the system matrix defining the linear operator. Dirichlet boundaries are
   // handled eliminating the rows and columns of the system matrix for the corresponding
@@ -93,6 +94,9 @@ void MagnetostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mes
     A[step].SetSize(RHS.Size());
     A[step] = 0.0;
     curlcurlop.GetExcitationVector(idx, RHS);
+
+    // With adaptive mesh refinement, start from the solution on the previous mesh.
+    pcg.iterative_mode = GetInitialGuess(step, curlcurlop.GetDbcTDofList(), A[step]);
     timer.construct_time += timer.Lap();
 
     pcg.Mult(RHS, A[step]);
@@ -117,13 +121,18 @@ void MagnetostaticSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mes
   // Postprocess the capacitance matrix from the computed field solutions.
   const auto io_time_prev = timer.io_time;
   SaveMetadata(nstep, ksp_it);
-  Postprocess(curlcurlop, postop, A, timer);
+  SaveSolution(curlcurlop.GetNDSpace(), A);
+  ErrorIndicator indicator;
+  Postprocess(curlcurlop, postop, A, indicator, timer);
   timer.postpro_time += timer.Lap() - (timer.io_time - io_time_prev);
+  postop.FlushFields();
+  timer.io_time += timer.Lap();
+  return {indicator, curlcurlop.GetNDSpace().GlobalTrueVSize()};
 }
 
 void MagnetostaticSolver::Postprocess(CurlCurlOperator &curlcurlop, PostOperator &postop,
                                       const std::vector<mfem::Vector> &A,
-                                      Timer &timer) const
+                                      ErrorIndicator &indicator, Timer &timer) const
 {
   // Postprocess the Maxwell inductance matrix. See p. 97 of the COMSOL AC/DC Module manual
   // for the associated formulas based on the magnetic field energy based on a current
@@ -154,10 +163,15 @@ void MagnetostaticSolver::Postprocess(CurlCurlOperator &curlcurlop, PostOperator
     PostOperator::GetBField(*Curl, A[i], B);
     postop.SetBGridFunction(B);
     postop.SetAGridFunction(A[i]);
+    if (iodata.model.refinement.max_it > 0)
+    {
+      postop.AddErrorIndicator(indicator);
+    }
     double Um = postop.GetHFieldEnergy();
     PostprocessDomains(postop, "i", i, idx, 0.0, Um, 0.0, 0.0);
     PostprocessSurfaces(postop, "i", i, idx, 0.0, Um, 0.0, Iinc(i));
     PostprocessProbes(postop, "i", i, idx);
+    PostprocessSamples(postop, i, idx);
     if (i < iodata.solver.magnetostatic.n_post)
     {
       auto t0 = timer.Now();
@@ -33,21 +33,22 @@ class MagnetostaticSolver : public BaseSolver
 {
 private:
   void Postprocess(CurlCurlOperator &curlcurlop, PostOperator &postop,
-                   const std::vector<mfem::Vector> &A, Timer &timer) const;
+                   const std::vector<mfem::Vector> &A, ErrorIndicator &indicator,
+                   Timer &timer) const;
 
   void PostprocessTerminals(const SurfaceCurrentOperator &surf_j_op,
                             const mfem::DenseMatrix &M, const mfem::DenseMatrix &Minv,
                             const mfem::DenseMatrix &Mm) const;
 
+  std::pair<ErrorIndicator, long long int>
+  Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const override;
+
 public:
   MagnetostaticSolver(const IoData &iodata, bool root, int size = 0, int num_thread = 0,
                       const char *git_tag = nullptr)
     : BaseSolver(iodata, root, size, num_thread, git_tag)
   {
   }
-
-  void Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-             Timer &timer) const override;
 };
 
 }  // namespace palace
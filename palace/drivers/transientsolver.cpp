@@ -17,14 +17,16 @@
 namespace palace
 {
 
-void TransientSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-                            Timer &timer) const
+std::pair<ErrorIndicator, long long int>
+TransientSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+                       Timer &timer) const
 {
   // Set up the spatial discretization and time integrators for the E and B fields.
   timer.Lap();
   std::function<double(double)> J_coef = GetTimeExcitation(false);
   std::function<double(double)> dJdt_coef = GetTimeExcitation(true);
   SpaceOperator spaceop(iodata, mesh);
+  spaceop.SetReuseAssembly(true);
   TimeOperator timeop(iodata, spaceop, dJdt_coef);
   double delta_t = iodata.solver.transient.delta_t;
   if (timeop.isExplicit())
@@ -125,6 +127,9 @@ void TransientSolver::Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
     step++;
   }
   SaveMetadata(timeop.GetTotalKspMult(), timeop.GetTotalKspIter());
+  postop.FlushFields();
+  timer.io_time += timer.Lap();
+  return {ErrorIndicator(), spaceop.GetNDSpace().GlobalTrueVSize()};
 }
 
 std::function<double(double)> TransientSolver::GetTimeExcitation(bool dot) const
@@ -253,6 +258,7 @@ void TransientSolver::Postprocess(const PostOperator &postop,
     PostprocessSurfaces(postop, "t (ns)", step, ts, E_elec + E_cap, E_mag + E_ind, 1.0,
                         1.0);
     PostprocessProbes(postop, "t (ns)", step, ts);
+    PostprocessSamples(postop, step, ts);
   }
   if (iodata.solver.transient.delta_post > 0 &&
       step % iodata.solver.transient.delta_post == 0)
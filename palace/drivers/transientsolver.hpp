@@ -47,15 +47,15 @@ private:
                         const LumpedPortOperator &lumped_port_op, int step, double t,
                         double J_coef) const;
 
+  std::pair<ErrorIndicator, long long int>
+  Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const override;
+
 public:
   TransientSolver(const IoData &iodata, bool root, int size = 0, int num_thread = 0,
                   const char *git_tag = nullptr)
     : BaseSolver(iodata, root, size, num_thread, git_tag)
   {
   }
-
-  void Solve(std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
-             Timer &timer) const override;
 };
 
 }  // namespace palace
@@ -3,6 +3,8 @@
 
 #include "domainpostoperator.hpp"
 
+#include <algorithm>
+#include <tuple>
 #include "fem/materialoperator.hpp"
 #include "utils/communication.hpp"
 #include "utils/iodata.hpp"
@@ -165,38 +167,73 @@ DomainPostOperator::DomainPostOperator(const IoData &iodata, const MaterialOpera
     m0ND->Finalize();
 
     // Use the provided domain postprocessing indices to group for postprocessing bulk
-    // dielectric loss.
-    int attr_max = nd_fespace->GetParMesh()->attributes.Max();
+    // dielectric loss. The mass matrices for each domain are assembled only over its
+    // elements, with the DOFs numbered in the order they are encountered.
+    MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_IMAG> epsilon_func_i(
+        mat_op, -1.0);
+    mfem::MixedVectorMassIntegrator m0r_integ(epsilon_func),
+        m0i_integ(epsilon_func_i);
+    mfem::ParMesh &mesh = *nd_fespace->GetParMesh();
+    std::vector<int> dof_map(nd_fespace->GetVSize());
+    mfem::Array<int> vdofs, rows;
+    mfem::DenseMatrix elmat_r, elmat_i;
     for (const auto &[idx, data] : iodata.domains.postpro.dielectric)
     {
-      mfem::Array<int> attr_marker(attr_max);
+      mfem::Array<int> attr_marker(mesh.attributes.Max());
       attr_marker = 0;
       for (auto attr : data.attributes)
       {
         attr_marker[attr - 1] = 1;
       }
-      SumMatrixCoefficient epsilon_func_r(nd_fespace->GetParMesh()->SpaceDimension());
-      SumMatrixCoefficient epsilon_func_i(nd_fespace->GetParMesh()->SpaceDimension());
-      epsilon_func_r.AddCoefficient(
-          std::make_unique<
-              MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_REAL>>(mat_op),
-          attr_marker);
-      epsilon_func_i.AddCoefficient(
-          std::make_unique<
-              MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_IMAG>>(mat_op,
-                                                                                    -1.0),
-          attr_marker);
-      auto &m0 = m0NDi.emplace(idx, std::make_pair(nd_fespace, nd_fespace)).first->second;
-      mfem::ParBilinearForm &m0r = m0.first;
-      mfem::ParBilinearForm &m0i = m0.second;
-      m0r.AddDomainIntegrator(new mfem::MixedVectorMassIntegrator(epsilon_func_r));
-      m0i.AddDomainIntegrator(new mfem::MixedVectorMassIntegrator(epsilon_func_i));
-      // m0r.SetAssemblyLevel(mfem::AssemblyLevel::FULL);
-      // m0i.SetAssemblyLevel(mfem::AssemblyLevel::FULL);
-      m0r.Assemble();
-      m0i.Assemble();
-      m0r.Finalize();
-      m0i.Finalize();
+      DomainData &m0 = m0NDi[idx];
+      std::fill(dof_map.begin(), dof_map.end(), -1);
+      std::vector<std::tuple<int, int, double, double>> entries;
+      for (int e = 0; e < mesh.GetNE(); e++)
+      {
+        if (!attr_marker[mesh.GetAttribute(e) - 1])
+        {
+          continue;
+        }
+        const mfem::FiniteElement &fe = *nd_fespace->GetFE(e);
+        mfem::ElementTransformation &T = *nd_fespace->GetElementTransformation(e);
+        mfem::DofTransformation *doftrans = nd_fespace->GetElementVDofs(e, vdofs);
+        m0r_integ.AssembleElementMatrix2(fe, fe, T, elmat_r);
+        m0i_integ.AssembleElementMatrix2(fe, fe, T, elmat_i);
+        if (doftrans)
+        {
+          doftrans->TransformDual(elmat_r);
+          doftrans->TransformDual(elmat_i);
+        }
+        rows.SetSize(vdofs.Size());
+        for (int i = 0; i < vdofs.Size(); i++)
+        {
+          const int vdof = (vdofs[i] >= 0) ? vdofs[i] : -1 - vdofs[i];
+          if (dof_map[vdof] < 0)
+          {
+            dof_map[vdof] = m0.dofs.Size();
+            m0.dofs.Append(vdof);
+          }
+          rows[i] = dof_map[vdof];
+        }
+        for (int j = 0; j < vdofs.Size(); j++)
+        {
+          for (int i = 0; i < vdofs.Size(); i++)
+          {
+            const double sgn = ((vdofs[i] >= 0) == (vdofs[j] >= 0)) ? 1.0 : -1.0;
+            entries.emplace_back(rows[i], rows[j], sgn * elmat_r(i, j),
+                                 sgn * elmat_i(i, j));
+          }
+        }
+      }
+      m0.m0r = std::make_unique<mfem::SparseMatrix>(m0.dofs.Size(), m0.dofs.Size());
+      m0.m0i = std::make_unique<mfem::SparseMatrix>(m0.dofs.Size(), m0.dofs.Size());
+      for (const auto &[i, j, ar, ai] : entries)
+      {
+        m0.m0r->Add(i, j, ar);
+        m0.m0i->Add(i, j, ai);
+      }
+      m0.m0r->Finalize();
+      m0.m0i->Finalize();
     }
   }
 
@@ -268,54 +305,39 @@ double DomainPostOperator::GetMagneticFieldEnergy(const mfem::ParGridFunction &B
   return 0.0;
 }
 
-double DomainPostOperator::GetDomainElectricFieldEnergy(
-    int idx, const mfem::ParComplexGridFunction &E) const
-{
-  // Compute the electric field energy integral for only a portion of the domain.
-  auto it = m0NDi.find(idx);
-  MFEM_VERIFY(it != m0NDi.end(),
-              "Invalid domain index when postprocessing bulk dielectric loss!");
-  double res = it->second.first.InnerProduct(E.real(), E.real());
-  res += it->second.first.InnerProduct(E.imag(), E.imag());
-  Mpi::GlobalSum(1, &res, E.ParFESpace()->GetComm());
-  return 0.5 * res;
-}
-
-double
-DomainPostOperator::GetDomainElectricFieldEnergy(int idx,
-                                                 const mfem::ParGridFunction &E) const
-{
-  auto it = m0NDi.find(idx);
-  MFEM_VERIFY(it != m0NDi.end(),
-              "Invalid domain index when postprocessing bulk dielectric loss!");
-  double res = it->second.first.InnerProduct(E, E);
-  Mpi::GlobalSum(1, &res, E.ParFESpace()->GetComm());
-  return 0.5 * res;
-}
-
-double DomainPostOperator::GetDomainElectricFieldEnergyLoss(
-    int idx, const mfem::ParComplexGridFunction &E) const
+std::vector<double> DomainPostOperator::GetDomainElectricFieldEnergies(
+    const mfem::ParComplexGridFunction &E) const
 {
-  // Compute the electric field energy integral for only a portion of the domain.
-  auto it = m0NDi.find(idx);
-  MFEM_VERIFY(it != m0NDi.end(),
-              "Invalid domain index when postprocessing bulk dielectric loss!");
-  double res = it->second.second.InnerProduct(E.real(), E.real());
-  res += it->second.second.InnerProduct(E.imag(), E.imag());
-  Mpi::GlobalSum(1, &res, E.ParFESpace()->GetComm());
-  return 0.5 * res;
+  // Compute the electric field energy integral and energy loss for only a portion of the
+  // domain, for all domains, by gathering the field at the DOFs of each domain.
+  std::vector<double> res;
+  res.reserve(2 * m0NDi.size());
+  mfem::Vector er, ei;
+  for (const auto &[idx, m0] : m0NDi)
+  {
+    E.real().GetSubVector(m0.dofs, er);
+    E.imag().GetSubVector(m0.dofs, ei);
+    res.push_back(0.5 * (m0.m0r->InnerProduct(er, er) + m0.m0r->InnerProduct(ei, ei)));
+    res.push_back(0.5 * (m0.m0i->InnerProduct(er, er) + m0.m0i->InnerProduct(ei, ei)));
+  }
+  Mpi::GlobalSum(static_cast<int>(res.size()), res.data(), E.ParFESpace()->GetComm());
+  return res;
 }
 
-double
-DomainPostOperator::GetDomainElectricFieldEnergyLoss(int idx,
-                                                     const mfem::ParGridFunction &E) const
+std::vector<double>
+DomainPostOperator::GetDomainElectricFieldEnergies(const mfem::ParGridFunction &E) const
 {
-  auto it = m0NDi.find(idx);
-  MFEM_VERIFY(it != m0NDi.end(),
-              "Invalid domain index when postprocessing bulk dielectric loss!");
-  double res = it->second.second.InnerProduct(E, E);
-  Mpi::GlobalSum(1, &res, E.ParFESpace()->GetComm());
-  return 0.5 * res;
+  std::vector<double> res;
+  res.reserve(2 * m0NDi.size());
+  mfem::Vector e;
+  for (const auto &[idx, m0] : m0NDi)
+  {
+    E.GetSubVector(m0.dofs, e);
+    res.push_back(0.5 * m0.m0r->InnerProduct(e, e));
+    res.push_back(0.5 * m0.m0i->InnerProduct(e, e));
+  }
+  Mpi::GlobalSum(static_cast<int>(res.size()), res.data(), E.ParFESpace()->GetComm());
+  return res;
 }
 
 }  // namespace palace
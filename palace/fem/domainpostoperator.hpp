@@ -5,8 +5,9 @@
 #define PALACE_DOMAIN_POST_OPERATOR_HPP
 
 #include <map>
+#include <memory>
 #include <optional>
-#include <utility>
+#include <vector>
 #include <mfem.hpp>
 
 namespace palace
@@ -62,7 +63,16 @@ class DomainPostOperator
 private:
   // Bilinear forms for computing field energy integrals over domains.
   std::optional<mfem::ParBilinearForm> m0ND, m0RT;
-  std::map<int, std::pair<mfem::ParBilinearForm, mfem::ParBilinearForm>> m0NDi;
+
+  // Mass matrices for the real and imaginary parts of the permittivity for computing bulk
+  // dielectric loss, assembled over only the elements of each domain and stored on the
+  // local ND space DOFs of these elements.
+  struct DomainData
+  {
+    mfem::Array<int> dofs;
+    std::unique_ptr<mfem::SparseMatrix> m0r, m0i;
+  };
+  std::map<int, DomainData> m0NDi;
 
 public:
   DomainPostOperator(const IoData &iodata, const MaterialOperator &mat_op,
@@ -78,11 +88,13 @@ public:
   double GetElectricFieldEnergy(const mfem::ParGridFunction &E) const;
   double GetMagneticFieldEnergy(const mfem::ParComplexGridFunction &B) const;
   double GetMagneticFieldEnergy(const mfem::ParGridFunction &B) const;
-  double GetDomainElectricFieldEnergy(int idx, const mfem::ParComplexGridFunction &E) const;
-  double GetDomainElectricFieldEnergy(int idx, const mfem::ParGridFunction &E) const;
-  double GetDomainElectricFieldEnergyLoss(int idx,
-                                          const mfem::ParComplexGridFunction &E) const;
-  double GetDomainElectricFieldEnergyLoss(int idx, const mfem::ParGridFunction &E) const;
+
+  // Get volume integrals computing the electric field energy and energy loss for all bulk
+  // dielectric loss domains at once, with a single global reduction. Values are ordered by
+  // domain index, that is [E_elec,1, E_loss,1, E_elec,2, E_loss,2, ...].
+  std::vector<double>
+  GetDomainElectricFieldEnergies(const mfem::ParComplexGridFunction &E) const;
+  std::vector<double> GetDomainElectricFieldEnergies(const mfem::ParGridFunction &E) const;
 };
 
 }  // namespace palace
@@ -0,0 +1,99 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "errorestimator.hpp"
+
+#include "utils/communication.hpp"
+
+namespace palace
+{
+
+void ErrorIndicator::AddIndicator(const mfem::Vector &err2, double norm2)
+{
+  // Update the running average of the normalized squared indicators.
+  if (n == 0)
+  {
+    local.SetSize(err2.Size());
+    local = 0.0;
+  }
+  MFEM_VERIFY(local.Size() == err2.Size(),
+              "Mismatch in size of element-wise error indicators!");
+  const double scale = (norm2 > 0.0) ? 1.0 / norm2 : 0.0;
+  for (int e = 0; e < local.Size(); e++)
+  {
+    local(e) = (n * local(e) + scale * err2(e)) / (n + 1);
+  }
+  n++;
+}
+
+double ErrorIndicator::GetGlobalErrorEstimate(MPI_Comm comm) const
+{
+  double sum = local.Sum();
+  Mpi::GlobalSum(1, &sum, comm);
+  return std::sqrt(sum);
+}
+
+FluxErrorEstimator::FluxErrorEstimator(mfem::ParMesh &mesh, int order)
+  : fec(order, mesh.Dimension()), fespace(&mesh, &fec, mesh.SpaceDimension()),
+    ksp(mesh.GetComm()), flux(&fespace)
+{
+  // The mass matrix for the projection is well conditioned, so a Jacobi preconditioned CG
+  // solver is sufficient.
+  mfem::ParBilinearForm m(&fespace);
+  m.AddDomainIntegrator(new mfem::VectorMassIntegrator);
+  m.Assemble();
+  m.Finalize();
+  M.reset(m.ParallelAssemble());
+  pc = std::make_unique<mfem::HypreDiagScale>(*M);
+  ksp.SetRelTol(1.0e-8);
+  ksp.SetMaxIter(500);
+  ksp.SetPrintLevel(0);
+  ksp.SetOperator(*M);
+  ksp.SetPreconditioner(*pc);
+  B.SetSize(M->Height());
+  X.SetSize(M->Height());
+}
+
+double FluxErrorEstimator::AddErrorIndicator(mfem::VectorCoefficient &F,
+                                             mfem::Vector &err2) const
+{
+  // Compute the element-wise norms of the flux.
+  mfem::Vector norm;
+  flux = 0.0;
+  flux.ComputeElementL2Errors(F, norm);
+
+  // Project the flux onto the continuous space and compute the element-wise errors.
+  {
+    mfem::ParLinearForm b(const_cast<mfem::ParFiniteElementSpace *>(&fespace));
+    b.AddDomainIntegrator(new mfem::VectorDomainLFIntegrator(F));
+    b.Assemble();
+    b.ParallelAssemble(B);
+  }
+  X = 0.0;
+  ksp.Mult(B, X);
+  if (!ksp.GetConverged())
+  {
+    Mpi::Warning("Flux recovery for error estimation did not converge in {:d} iterations!\n",
+                 ksp.GetNumIterations());
+  }
+  flux.SetFromTrueDofs(X);
+  mfem::Vector err;
+  flux.ComputeElementL2Errors(F, err);
+
+  // Accumulate the results.
+  if (err2.Size() == 0)
+  {
+    err2.SetSize(err.Size());
+    err2 = 0.0;
+  }
+  double norm2 = 0.0;
+  for (int e = 0; e < err.Size(); e++)
+  {
+    err2(e) += err(e) * err(e);
+    norm2 += norm(e) * norm(e);
+  }
+  Mpi::GlobalSum(1, &norm2, fespace.GetComm());
+  return norm2;
+}
+
+}  // namespace palace
@@ -0,0 +1,78 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PALACE_ERROR_ESTIMATOR_HPP
+#define PALACE_ERROR_ESTIMATOR_HPP
+
+#include <memory>
+#include <mfem.hpp>
+
+namespace palace
+{
+
+//
+// Element-wise error indicators for adaptive mesh refinement, averaged over the solutions
+// (for example frequency samples, eigenmodes, or terminal excitations) which contribute to
+// them. Each solution contributes the squared element errors relative to the squared norm
+// of its flux over the entire domain, so that solutions of different magnitudes are
+// weighted equally.
+//
+class ErrorIndicator
+{
+private:
+  // Squared element-wise error indicators and the number of contributing solutions.
+  mfem::Vector local;
+  int n;
+
+public:
+  ErrorIndicator() : n(0) {}
+
+  // Add the squared element-wise errors for a solution, normalized by the squared global
+  // norm of its flux.
+  void AddIndicator(const mfem::Vector &err2, double norm2);
+
+  // Return true if no solutions have contributed to the indicators.
+  bool Empty() const { return (n == 0); }
+
+  // Return the squared element-wise error indicators on this process.
+  const mfem::Vector &GetLocalErrorIndicators() const { return local; }
+
+  // Return the global (relative) error estimate, the square root of the sum of the squared
+  // element-wise indicators.
+  double GetGlobalErrorEstimate(MPI_Comm comm) const;
+};
+
+//
+// A Zienkiewicz-Zhu type error estimator based on flux recovery. The discontinuous flux
+// of the finite element solution is projected onto a continuous vector H1 space of the
+// same order using a global L² projection, and the element-wise error indicator is the L²
+// norm of the difference between the flux and its smooth recovery.
+//
+class FluxErrorEstimator
+{
+private:
+  // Finite element space for the smooth flux recovery.
+  mfem::H1_FECollection fec;
+  mfem::ParFiniteElementSpace fespace;
+
+  // Mass matrix and solver for the L² projection.
+  std::unique_ptr<mfem::HypreParMatrix> M;
+  std::unique_ptr<mfem::HypreDiagScale> pc;
+  mfem::CGSolver ksp;
+
+  // Temporary storage for the projection.
+  mutable mfem::ParGridFunction flux;
+  mutable mfem::Vector B, X;
+
+public:
+  FluxErrorEstimator(mfem::ParMesh &mesh, int order);
+
+  // Add the squared element-wise L² errors between the given flux and its smooth recovery
+  // to the provided vector, and return the squared L² norm of the flux over the entire
+  // domain.
+  double AddErrorIndicator(mfem::VectorCoefficient &F, mfem::Vector &err2) const;
+};
+
+}  // namespace palace
+
+#endif  // PALACE_ERROR_ESTIMATOR_HPP
@@ -0,0 +1,176 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "interpolationoperator.hpp"
+
+#include "utils/communication.hpp"
+#include "utils/iodata.hpp"
+
+namespace palace
+{
+
+InterpolationOperator::InterpolationOperator(const IoData &iodata, mfem::ParMesh &mesh)
+  : comm(mesh.GetComm())
+{
+#if defined(MFEM_USE_GSLIB)
+  // Set up probes interpolation. The root process searches for all points, and the owning
+  // process, element, and reference coordinates of each point are then broadcast so that
+  // the owning processes can evaluate the fields directly.
+  if (iodata.domains.postpro.probe.empty())
+  {
+    return;
+  }
+  const double bb_t = 0.1;  // MFEM defaults
+  const double newton_tol = 1.0e-12;
+  const int npts = static_cast<int>(iodata.domains.postpro.probe.size());
+  const int dim = mesh.SpaceDimension();
+  MFEM_VERIFY(
+      mesh.Dimension() == dim,
+      "Probe postprocessing functionality requires mesh dimension == space dimension!");
+  const bool root = Mpi::Root(comm);
+  mfem::Vector xyz(root ? npts * dim : 0);
+  op_idx.resize(npts);
+  int i = 0;
+  for (const auto &[idx, data] : iodata.domains.postpro.probe)
+  {
+    // Use default ordering byNODES.
+    if (root)
+    {
+      xyz(i) = data.x;
+      xyz(npts + i) = data.y;
+      if (dim == 3)
+      {
+        xyz(2 * npts + i) = data.z;
+      }
+    }
+    op_idx[i++] = idx;
+  }
+  std::vector<int> code(npts), proc(npts), elem(npts);
+  std::vector<double> ref(npts * dim);
+  {
+    mfem::FindPointsGSLIB op(comm);
+    op.Setup(mesh, bb_t, newton_tol, npts);
+    op.FindPoints(xyz, mfem::Ordering::byNODES);
+    if (root)
+    {
+      for (i = 0; i < npts; i++)
+      {
+        code[i] = op.GetCode()[i];
+        proc[i] = op.GetProc()[i];
+        elem[i] = op.GetElem()[i];
+        for (int d = 0; d < dim; d++)
+        {
+          ref[i * dim + d] = op.GetReferencePosition()(i * dim + d);
+        }
+      }
+    }
+  }
+  Mpi::Broadcast(npts, code.data(), 0, comm);
+  Mpi::Broadcast(npts, proc.data(), 0, comm);
+  Mpi::Broadcast(npts, elem.data(), 0, comm);
+  Mpi::Broadcast(npts * dim, ref.data(), 0, comm);
+  const int rank = Mpi::Rank(comm);
+  i = 0;
+  for (const auto &[idx, data] : iodata.domains.postpro.probe)
+  {
+    if (code[i] == 2)
+    {
+      Mpi::Warning(comm,
+                   "Probe {:d} at ({:.3e}, {:.3e}, {:.3e}) m could not be found!\n"
+                   "Using default value 0.0!\n",
+                   idx, iodata.DimensionalizeValue(IoData::ValueType::LENGTH, data.x),
+                   iodata.DimensionalizeValue(IoData::ValueType::LENGTH, data.y),
+                   iodata.DimensionalizeValue(IoData::ValueType::LENGTH, data.z));
+    }
+    else if (proc[i] == rank)
+    {
+      loc_pts.push_back(i);
+      loc_elems.push_back(elem[i]);
+      loc_ips.emplace_back();
+      if (dim == 3)
+      {
+        loc_ips.back().Set3(&ref[i * dim]);
+      }
+      else
+      {
+        loc_ips.back().Set2(&ref[i * dim]);
+      }
+    }
+    i++;
+  }
+#else
+  MFEM_VERIFY(iodata.domains.postpro.probe.empty(),
+              "InterpolationOperator class requires MFEM_USE_GSLIB!");
+#endif
+}
+
+std::vector<std::vector<double>>
+InterpolationOperator::ProbeFields(const std::vector<const mfem::ParGridFunction *> &U) const
+{
+#if defined(MFEM_USE_GSLIB)
+  // Each process evaluates the fields at the points in its local elements, and the values
+  // of all fields are summed over the processes at once (points which were not found keep
+  // the default value of zero).
+  const int npts = static_cast<int>(op_idx.size());
+  std::vector<int> offsets(U.size() + 1, 0);
+  for (std::size_t k = 0; k < U.size(); k++)
+  {
+    offsets[k + 1] = offsets[k] + npts * U[k]->VectorDim();
+  }
+  std::vector<double> vals(offsets.back(), 0.0);
+  mfem::Vector v;
+  for (std::size_t k = 0; k < U.size(); k++)
+  {
+    const int vdim = U[k]->VectorDim();
+    for (std::size_t j = 0; j < loc_pts.size(); j++)
+    {
+      U[k]->GetVectorValue(loc_elems[j], loc_ips[j], v);
+      for (int d = 0; d < vdim; d++)
+      {
+        vals[offsets[k] + loc_pts[j] * vdim + d] = v(d);
+      }
+    }
+  }
+  Mpi::GlobalSum(static_cast<int>(vals.size()), vals.data(), comm);
+  std::vector<std::vector<double>> F(U.size());
+  for (std::size_t k = 0; k < U.size(); k++)
+  {
+    F[k].assign(vals.begin() + offsets[k], vals.begin() + offsets[k + 1]);
+  }
+  return F;
+#else
+  MFEM_ABORT("InterpolationOperator class requires MFEM_USE_GSLIB!");
+  return {};
+#endif
+}
+
+std::vector<std::vector<std::complex<double>>>
+InterpolationOperator::ProbeFields(const std::vector<const mfem::ParComplexGridFunction *> &U,
+                                   bool has_imaginary) const
+{
+  // Interpolate the real and imaginary parts of all fields together.
+  std::vector<const mfem::ParGridFunction *> V;
+  V.reserve(2 * U.size());
+  for (const auto *u : U)
+  {
+    V.push_back(&u->real());
+    if (has_imaginary)
+    {
+      V.push_back(&u->imag());
+    }
+  }
+  const std::vector<std::vector<double>> vals = ProbeFields(V);
+  std::vector<std::vector<std::complex<double>>> F(U.size());
+  for (std::size_t k = 0; k < U.size(); k++)
+  {
+    const std::vector<double> &vr = vals[has_imaginary ? 2 * k : k];
+    F[k].resize(vr.size());
+    for (std::size_t i = 0; i < vr.size(); i++)
+    {
+      F[k][i] = has_imaginary ? std::complex<double>(vr[i], vals[2 * k + 1][i]) : vr[i];
+    }
+  }
+  return F;
+}
+
+}  // namespace palace
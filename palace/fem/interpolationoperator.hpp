@@ -4,121 +4,52 @@
 #ifndef PALACE_INTERPOLATION_OPERATOR_HPP
 #define PALACE_INTERPOLATION_OPERATOR_HPP
 
-#include <algorithm>
 #include <complex>
 #include <vector>
 #include <mfem.hpp>
-#include "utils/communication.hpp"
-#include "utils/iodata.hpp"
 
 namespace palace
 {
 
+class IoData;
+
 //
-// A class which wraps MFEM's GSLIB interface for high-order field interpolation.
+// A class which uses MFEM's GSLIB interface to locate probe points for high-order field
+// interpolation. The points are located once on construction, after which each process
+// evaluates the fields at the points inside its local elements and the values for all
+// requested fields are combined with a single reduction.
 //
 class InterpolationOperator
 {
 private:
-#if defined(MFEM_USE_GSLIB)
-  mfem::FindPointsGSLIB op;
-#endif
+  MPI_Comm comm;
+
+  // Probe indices from the configuration file.
   std::vector<int> op_idx;
 
+  // Points located in the local elements, with their element and reference coordinates.
+  std::vector<int> loc_pts, loc_elems;
+  std::vector<mfem::IntegrationPoint> loc_ips;
+
 public:
-#if defined(MFEM_USE_GSLIB)
-  InterpolationOperator(const IoData &iodata, mfem::ParMesh &mesh) : op(mesh.GetComm())
-#else
-  InterpolationOperator(const IoData &iodata, mfem::ParMesh &mesh)
-#endif
-  {
-#if defined(MFEM_USE_GSLIB)
-    // Set up probes interpolation. All processes search for all points.
-    if (iodata.domains.postpro.probe.empty())
-    {
-      return;
-    }
-    const double bb_t = 0.1;  // MFEM defaults
-    const double newton_tol = 1.0e-12;
-    const int npts = static_cast<int>(iodata.domains.postpro.probe.size());
-    MFEM_VERIFY(
-        mesh.Dimension() == mesh.SpaceDimension(),
-        "Probe postprocessing functionality requires mesh dimension == space dimension!");
-    mfem::Vector xyz(npts * mesh.SpaceDimension());
-    op_idx.resize(npts);
-    int i = 0;
-    for (const auto &[idx, data] : iodata.domains.postpro.probe)
-    {
-      // Use default ordering byNODES.
-      xyz(i) = data.x;
-      xyz(npts + i) = data.y;
-      if (mesh.SpaceDimension() == 3)
-      {
-        xyz(2 * npts + i) = data.z;
-      }
-      op_idx[i++] = idx;
-    }
-    op.Setup(mesh, bb_t, newton_tol, npts);
-    op.FindPoints(xyz, mfem::Ordering::byNODES);
-    op.SetDefaultInterpolationValue(0.0);
-    i = 0;
-    for (const auto &[idx, data] : iodata.domains.postpro.probe)
-    {
-      if (op.GetCode()[i++] == 2)
-      {
-        Mpi::Warning("Probe {:d} at ({:.3e}, {:.3e}, {:.3e}) m could not be found!\n"
-                     "Using default value 0.0!\n",
-                     idx, iodata.DimensionalizeValue(IoData::ValueType::LENGTH, data.x),
-                     iodata.DimensionalizeValue(IoData::ValueType::LENGTH, data.y),
-                     iodata.DimensionalizeValue(IoData::ValueType::LENGTH, data.z));
-      }
-    }
-#else
-    MFEM_VERIFY(iodata.domains.postpro.probe.empty(),
-                "InterpolationOperator class requires MFEM_USE_GSLIB!");
-#endif
-  }
+  InterpolationOperator(const IoData &iodata, mfem::ParMesh &mesh);
+
+  // Interpolate the given fields at the probe locations. Values for each field are ordered
+  // by vector dimension, that is [v1x, v1y, v1z, v2x, v2y, v2z, ...].
+  std::vector<std::vector<double>>
+  ProbeFields(const std::vector<const mfem::ParGridFunction *> &U) const;
+  std::vector<std::vector<std::complex<double>>>
+  ProbeFields(const std::vector<const mfem::ParComplexGridFunction *> &U,
+              bool has_imaginary) const;
 
-  std::vector<double> ProbeField(const mfem::ParGridFunction &U)
+  std::vector<double> ProbeField(const mfem::ParGridFunction &U) const
   {
-#if defined(MFEM_USE_GSLIB)
-    // Interpolated vector values are returned from GSLIB interpolator byNODES, which we
-    // transform to byVDIM for output.
-    const int npts = op.GetCode().Size();
-    const int dim = U.VectorDim();
-    std::vector<double> vals(npts * dim);
-    mfem::Vector v(npts * dim);
-    op.Interpolate(U, v);
-    for (int d = 0; d < dim; d++)
-    {
-      for (int i = 0; i < npts; i++)
-      {
-        vals[i * dim + d] = v(d * npts + i);
-      }
-    }
-    return vals;
-#else
-    MFEM_ABORT("InterpolationOperator class requires MFEM_USE_GSLIB!");
-    return {};
-#endif
+    return ProbeFields({&U})[0];
   }
-
   std::vector<std::complex<double>> ProbeField(const mfem::ParComplexGridFunction &U,
-                                               bool has_imaginary)
+                                               bool has_imaginary) const
   {
-    std::vector<double> vr = ProbeField(U.real());
-    if (has_imaginary)
-    {
-      std::vector<double> vi = ProbeField(U.imag());
-      std::vector<std::complex<double>> vals(vr.size());
-      std::transform(vr.begin(), vr.end(), vi.begin(), vals.begin(),
-                     [](double xr, double xi) { return std::complex<double>(xr, xi); });
-      return vals;
-    }
-    else
-    {
-      return std::vector<std::complex<double>>(vr.begin(), vr.end());
-    }
+    return ProbeFields({&U}, has_imaginary)[0];
   }
 
   const auto &GetProbes() const { return op_idx; }
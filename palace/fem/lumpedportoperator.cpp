@@ -10,7 +10,6 @@
 #include "utils/iodata.hpp"
 #include "utils/lumpedelement.hpp"
 #include "utils/mfemcoefficients.hpp"
-#include "utils/mfemintegrators.hpp"
 
 namespace palace
 {
@@ -19,7 +18,7 @@ using namespace std::complex_literals;
 
 LumpedPortData::LumpedPortData(const config::LumpedPortData &data,
                                mfem::ParFiniteElementSpace &h1_fespace)
-  : excitation(data.excitation), s(nullptr), v(nullptr)
+  : excitation(data.excitation)
 {
   // Check inputs. Only one of the circuit or per square properties should be specified
   // for the port boundary.
@@ -160,117 +159,28 @@ double LumpedPortData::GetExcitationVoltage() const
   }
 }
 
-std::complex<double> LumpedPortData::GetSParameter(mfem::ParComplexGridFunction &E) const
+double LumpedPortData::GetSParameterCoefficient(const LumpedElementData &elem) const
 {
-  // Compute port S-parameter, or the projection of the field onto the port mode:
+  // The port S-parameter is the projection of the field onto the port mode:
   // (E x H_inc) ⋅ n = E ⋅ (E_inc / Z_s), integrated over the port surface.
-  if (!s)
-  {
-    auto &nd_fespace = *E.ParFESpace();
-    SumVectorCoefficient fb(nd_fespace.GetParMesh()->SpaceDimension());
-    for (const auto &elem : elems)
-    {
-      const double Rs = R * GetToSquare(*elem);
-      const double Hinc = 1.0 / std::sqrt(Rs * elem->GetGeometryWidth() *
-                                          elem->GetGeometryLength() * elems.size());
-      fb.AddCoefficient(elem->GetModeCoefficient(Hinc), elem->GetMarker());
-    }
-    s = std::make_unique<mfem::ParLinearForm>(&nd_fespace);
-    s->AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(fb));
-    s->UseFastAssembly(true);
-    s->Assemble();
-  }
-  return {(*s)(E.real()), (*s)(E.imag())};
-}
-
-double LumpedPortData::GetPower(mfem::ParGridFunction &E, mfem::ParGridFunction &B,
-                                const MaterialOperator &mat_op,
-                                const std::map<int, int> &local_to_shared) const
-{
-  // Compute port power, (E x H) ⋅ n = E ⋅ (-n x H), integrated over the port surface
-  // using the computed E and H = μ⁻¹ B fields. The linear form is reconstructed from
-  // scratch each time due to changing H. The BdrCurrentVectorCoefficient computes -n x H,
-  // where n is an outward normal.
-  auto &nd_fespace = *E.ParFESpace();
-  SumVectorCoefficient fb(nd_fespace.GetParMesh()->SpaceDimension());
-  for (const auto &elem : elems)
-  {
-    fb.AddCoefficient(
-        std::make_unique<BdrCurrentVectorCoefficient>(B, mat_op, local_to_shared),
-        elem->GetMarker());
-  }
-  mfem::ParLinearForm p(&nd_fespace);
-  p.AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(fb));
-  p.UseFastAssembly(true);
-  p.Assemble();
-  return p(E);
+  const double Rs = R * GetToSquare(elem);
+  return 1.0 / std::sqrt(Rs * elem.GetGeometryWidth() * elem.GetGeometryLength() *
+                         elems.size());
 }
 
-std::complex<double>
-LumpedPortData::GetPower(mfem::ParComplexGridFunction &E, mfem::ParComplexGridFunction &B,
-                         const MaterialOperator &mat_op,
-                         const std::map<int, int> &local_to_shared) const
+double LumpedPortData::GetVoltageCoefficient(const LumpedElementData &elem) const
 {
-  // Compute port power, (E x H⋆) ⋅ n = E ⋅ (-n x H⋆), integrated over the port surface
-  // using the computed E and H = μ⁻¹ B fields. The linear form is reconstructed from
-  // scratch each time due to changing H. The BdrCurrentVectorCoefficient computes -n x H,
-  // where n is an outward normal.
-  auto &nd_fespace = *E.ParFESpace();
-  SumVectorCoefficient fbr(nd_fespace.GetParMesh()->SpaceDimension());
-  SumVectorCoefficient fbi(nd_fespace.GetParMesh()->SpaceDimension());
-  for (const auto &elem : elems)
-  {
-    fbr.AddCoefficient(
-        std::make_unique<BdrCurrentVectorCoefficient>(B.real(), mat_op, local_to_shared),
-        elem->GetMarker());
-    fbi.AddCoefficient(
-        std::make_unique<BdrCurrentVectorCoefficient>(B.imag(), mat_op, local_to_shared),
-        elem->GetMarker());
-  }
-  mfem::ParLinearForm pr(&nd_fespace), pi(&nd_fespace);
-  pr.AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(fbr));
-  pi.AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(fbi));
-  pr.UseFastAssembly(true);
-  pi.UseFastAssembly(true);
-  pr.Assemble();
-  pi.Assemble();
-  return {pr(E.real()) + pi(E.imag()), pr(E.imag()) - pi(E.real())};
-}
-
-double LumpedPortData::GetVoltage(mfem::ParGridFunction &E) const
-{
-  // Compute the voltage across a port using the electric field solution.
+  // The voltage across a port is computed using the electric field solution.
   // We have:
   //             V = ∫ E ⋅ l̂ dl = 1/w ∫ E ⋅ l̂ dS  (for rectangular ports)
   // or,
   //             V = 1/(2π) ∫ E ⋅ r̂ / r dS        (for coaxial ports).
-  // We compute the surface integral via an inner product between the linear form with the
-  // averaging function as a vector coefficient and the solution expansion coefficients.
-  if (!v)
-  {
-    auto &nd_fespace = *E.ParFESpace();
-    SumVectorCoefficient fb(nd_fespace.GetParMesh()->SpaceDimension());
-    for (const auto &elem : elems)
-    {
-      fb.AddCoefficient(
-          elem->GetModeCoefficient(1.0 / (elem->GetGeometryWidth() * elems.size())),
-          elem->GetMarker());
-    }
-    v = std::make_unique<mfem::ParLinearForm>(&nd_fespace);
-    v->AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(fb));
-    v->UseFastAssembly(true);
-    v->Assemble();
-  }
-  return (*v)(E);
-}
-
-std::complex<double> LumpedPortData::GetVoltage(mfem::ParComplexGridFunction &E) const
-{
-  return {GetVoltage(E.real()), GetVoltage(E.imag())};
+  return 1.0 / (elem.GetGeometryWidth() * elems.size());
 }
 
 LumpedPortOperator::LumpedPortOperator(const IoData &iodata,
                                        mfem::ParFiniteElementSpace &h1_fespace)
+  : nd_fespace(nullptr), rt_fespace(nullptr)
 {
   // Set up lumped port boundary conditions.
   SetUpBoundaryProperties(iodata, h1_fespace);
@@ -483,6 +393,256 @@ const LumpedPortData &LumpedPortOperator::GetPort(int idx) const
   return it->second;
 }
 
+void LumpedPortOperator::AssemblePortFunctionals(
+    const mfem::ParGridFunction &E, const mfem::ParGridFunction &B,
+    const MaterialOperator &mat_op, const BdrFaceGeometry &bdr_geom) const
+{
+  // The S-parameter and voltage functionals integrate E against the scaled port mode over
+  // the port surface. The port power is (E x H) ⋅ n = E ⋅ (-n x H), integrated over the
+  // port surface using the computed E and H = μ⁻¹ B fields, where -n x H is evaluated as
+  // for BdrCurrentVectorCoefficient with n an outward normal. The DOFs of the ND and RT
+  // spaces are numbered in the order they are encountered on the port boundaries.
+  nd_fespace = E.ParFESpace();
+  rt_fespace = B.ParFESpace();
+  mfem::ParMesh &mesh = *nd_fespace->GetParMesh();
+  const int sdim = mesh.SpaceDimension();
+  MFEM_VERIFY(sdim == 3, "Lumped port postprocessing expects a mesh in 3D space!");
+  const int nports = static_cast<int>(ports.size());
+  std::vector<int> nd_map(nd_fespace->GetVSize(), -1);
+  std::vector<int> rt_map(rt_fespace->GetVSize() + rt_fespace->GetFaceNbrVSize(), -1);
+  port_nd_dofs.SetSize(0);
+  port_rt_dofs.SetSize(0);
+  auto GetIndex = [](int vdof, std::vector<int> &map, mfem::Array<int> &dofs, double &a)
+  {
+    if (vdof < 0)
+    {
+      vdof = -1 - vdof;
+      a = -a;
+    }
+    if (map[vdof] < 0)
+    {
+      map[vdof] = dofs.Size();
+      dofs.Append(vdof);
+    }
+    return map[vdof];
+  };
+
+  struct Entry
+  {
+    int i, j;
+    double a;
+  };
+  std::vector<Entry> sv_entries;
+  std::vector<std::vector<Entry>> p_entries(nports);
+  BdrGridFunctionQuadrature bdr_quad(mesh, bdr_geom);
+  mfem::DenseMatrix nd_vshape, rt_vshape, block;
+  mfem::Array<int> nd_vdofs, rt_vdofs;
+  mfem::Vector f(sdim), elvect, vec;
+  int j = 0;
+  for (const auto &[idx, data] : ports)
+  {
+    for (const auto &elem : data.GetElements())
+    {
+      auto fs = elem->GetModeCoefficient(data.GetSParameterCoefficient(*elem));
+      auto fv = elem->GetModeCoefficient(data.GetVoltageCoefficient(*elem));
+      bdr_quad.ForEachPoint(
+          *nd_fespace, elem->GetMarker(),
+          [&](int be, mfem::ElementTransformation &T, double w, const double *nor,
+              const double *C1, mfem::ElementTransformation &T1,
+              mfem::ElementTransformation *T2)
+          {
+            // Boundary element shape functions of the ND space.
+            const mfem::FiniteElement &fe = *nd_fespace->GetBE(be);
+            mfem::DofTransformation *nd_doftrans =
+                nd_fespace->GetBdrElementVDofs(be, nd_vdofs);
+            nd_vshape.SetSize(fe.GetDof(), sdim);
+            fe.CalcVShape(T, nd_vshape);
+            elvect.SetSize(fe.GetDof());
+
+            // S-parameter and voltage functionals.
+            for (int k = 0; k < 2; k++)
+            {
+              ((k == 0) ? fs : fv)->Eval(f, T, T.GetIntPoint());
+              nd_vshape.Mult(f, elvect);
+              elvect *= w;
+              if (nd_doftrans)
+              {
+                nd_doftrans->TransformDual(elvect);
+              }
+              for (int i = 0; i < nd_vdofs.Size(); i++)
+              {
+                double a = elvect(i);
+                const int row = GetIndex(nd_vdofs[i], nd_map, port_nd_dofs, a);
+                sv_entries.push_back({row, 2 * j + k, a});
+              }
+            }
+
+            // Power bilinear form, from the B-field on each side of the boundary.
+            const double s = (C1[0] * nor[0] + C1[1] * nor[1] + C1[2] * nor[2] < 0.0)
+                                 ? -w
+                                 : w;
+            auto AddSide = [&](mfem::ElementTransformation &Ti, double a)
+            {
+              mfem::DofTransformation *rt_doftrans =
+                  BdrGridFunctionQuadrature::GetElementVShape(*rt_fespace, Ti, rt_vshape,
+                                                              rt_vdofs);
+              const mfem::DenseMatrix &muinv = mat_op.GetInvPermeability(Ti.Attribute);
+              block.SetSize(nd_vdofs.Size(), rt_vdofs.Size());
+              for (int k = 0; k < rt_vdofs.Size(); k++)
+              {
+                double psi[3], u[3], c[3];
+                for (int d = 0; d < 3; d++)
+                {
+                  psi[d] = rt_vshape(k, d);
+                }
+                muinv.Mult(psi, u);
+                c[0] = nor[1] * u[2] - nor[2] * u[1];
+                c[1] = nor[2] * u[0] - nor[0] * u[2];
+                c[2] = nor[0] * u[1] - nor[1] * u[0];
+                for (int i = 0; i < nd_vdofs.Size(); i++)
+                {
+                  block(i, k) = a * (nd_vshape(i, 0) * c[0] + nd_vshape(i, 1) * c[1] +
+                                     nd_vshape(i, 2) * c[2]);
+                }
+              }
+              if (nd_doftrans)
+              {
+                for (int k = 0; k < block.Width(); k++)
+                {
+                  block.GetColumn(k, vec);
+                  nd_doftrans->TransformDual(vec);
+                  block.SetCol(k, vec);
+                }
+              }
+              if (rt_doftrans)
+              {
+                for (int i = 0; i < block.Height(); i++)
+                {
+                  block.GetRow(i, vec);
+                  rt_doftrans->TransformDual(vec);
+                  block.SetRow(i, vec);
+                }
+              }
+              for (int i = 0; i < nd_vdofs.Size(); i++)
+              {
+                for (int k = 0; k < rt_vdofs.Size(); k++)
+                {
+                  double b = block(i, k);
+                  const int row = GetIndex(nd_vdofs[i], nd_map, port_nd_dofs, b);
+                  const int col = GetIndex(rt_vdofs[k], rt_map, port_rt_dofs, b);
+                  p_entries[j].push_back({row, col, b});
+                }
+              }
+            };
+            AddSide(T1, s);
+            if (T2)
+            {
+              AddSide(*T2, -s);
+            }
+          });
+    }
+    j++;
+  }
+
+  // Construct the port functional multivector and power bilinear forms.
+  const int n = port_nd_dofs.Size(), m = port_rt_dofs.Size();
+  port_sv.SetSize(n, 2 * nports);
+  port_sv = 0.0;
+  for (const auto &e : sv_entries)
+  {
+    port_sv(e.i, e.j) += e.a;
+  }
+  port_p.clear();
+  for (j = 0; j < nports; j++)
+  {
+    port_p.push_back(std::make_unique<mfem::SparseMatrix>(n, m));
+    for (const auto &e : p_entries[j])
+    {
+      port_p.back()->Add(e.i, e.j, e.a);
+    }
+    port_p.back()->Finalize();
+  }
+}
+
+void LumpedPortOperator::GetPortValues(const mfem::ParGridFunction &Er,
+                                       const mfem::ParGridFunction *Ei,
+                                       const mfem::ParGridFunction &Br,
+                                       const mfem::ParGridFunction *Bi,
+                                       const MaterialOperator &mat_op,
+                                       const BdrFaceGeometry &bdr_geom,
+                                       std::vector<std::complex<double>> &S,
+                                       std::vector<std::complex<double>> &P,
+                                       std::vector<std::complex<double>> &V) const
+{
+  // Assemble the port functionals on first use. The fields should be ready for parallel
+  // comm on shared faces.
+  const int nports = static_cast<int>(ports.size());
+  S.assign(nports, 0.0);
+  P.assign(nports, 0.0);
+  V.assign(nports, 0.0);
+  if (nports == 0)
+  {
+    return;
+  }
+  if (nd_fespace != Er.ParFESpace() || rt_fespace != Br.ParFESpace())
+  {
+    AssemblePortFunctionals(Er, Br, mat_op, bdr_geom);
+  }
+
+  // Gather the field values at the port DOFs.
+  const int n = port_nd_dofs.Size(), m = port_rt_dofs.Size();
+  auto GatherE = [&](const mfem::ParGridFunction *U, mfem::Vector &u)
+  {
+    u.SetSize(n);
+    for (int i = 0; i < n; i++)
+    {
+      u(i) = U ? (*U)(port_nd_dofs[i]) : 0.0;
+    }
+  };
+  auto GatherB = [&](const mfem::ParGridFunction *U, mfem::Vector &u)
+  {
+    u.SetSize(m);
+    for (int k = 0; k < m; k++)
+    {
+      const int dof = port_rt_dofs[k];
+      u(k) = !U ? 0.0 : (dof < U->Size()) ? (*U)(dof) : U->FaceNbrData()(dof - U->Size());
+    }
+  };
+  mfem::Vector er, ei, br, bi, svr(2 * nports), svi(2 * nports), y(n);
+  GatherE(&Er, er);
+  GatherE(Ei, ei);
+  GatherB(&Br, br);
+  GatherB(Bi, bi);
+
+  // Compute the local contributions for all ports with a single block dot product for the
+  // S-parameters and voltages, and sum them over all processes at once.
+  port_sv.MultTranspose(er, svr);
+  port_sv.MultTranspose(ei, svi);
+  std::vector<double> vals(8 * nports);
+  for (int j = 0; j < nports; j++)
+  {
+    double *v = vals.data() + 8 * j;
+    v[0] = svr(2 * j);
+    v[1] = svi(2 * j);
+    v[2] = svr(2 * j + 1);
+    v[3] = svi(2 * j + 1);
+    port_p[j]->Mult(br, y);
+    v[4] = er * y;
+    v[5] = ei * y;
+    port_p[j]->Mult(bi, y);
+    v[6] = ei * y;
+    v[7] = er * y;
+  }
+  Mpi::GlobalSum(8 * nports, vals.data(), nd_fespace->GetComm());
+  for (int j = 0; j < nports; j++)
+  {
+    const double *v = vals.data() + 8 * j;
+    S[j] = {v[0], v[1]};
+    V[j] = {v[2], v[3]};
+    P[j] = {v[4] + v[6], v[5] - v[7]};
+  }
+}
+
 void LumpedPortOperator::AddStiffnessBdrCoefficients(double coef, SumMatrixCoefficient &fb)
 {
   // Add lumped inductor boundaries to the bilinear form.
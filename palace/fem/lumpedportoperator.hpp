@@ -14,6 +14,7 @@
 namespace palace
 {
 
+class BdrFaceGeometry;
 class IoData;
 class MaterialOperator;
 class SumMatrixCoefficient;
@@ -39,9 +40,6 @@ private:
   // different attributes and directions which add in parallel.
   std::vector<std::unique_ptr<LumpedElementData>> elems;
 
-  // Linear forms for postprocessing integrated quantities on the port.
-  mutable std::unique_ptr<mfem::ParLinearForm> s, v;
-
 public:
   LumpedPortData(const config::LumpedPortData &data,
                  mfem::ParFiniteElementSpace &h1_fespace);
@@ -66,16 +64,10 @@ public:
   double GetExcitationPower() const;
   double GetExcitationVoltage() const;
 
-  std::complex<double> GetSParameter(mfem::ParComplexGridFunction &E) const;
-  std::complex<double> GetPower(mfem::ParComplexGridFunction &E,
-                                mfem::ParComplexGridFunction &B,
-                                const MaterialOperator &mat_op,
-                                const std::map<int, int> &local_to_shared) const;
-  double GetPower(mfem::ParGridFunction &E, mfem::ParGridFunction &B,
-                  const MaterialOperator &mat_op,
-                  const std::map<int, int> &local_to_shared) const;
-  std::complex<double> GetVoltage(mfem::ParComplexGridFunction &E) const;
-  double GetVoltage(mfem::ParGridFunction &E) const;
+  // Scaling of the port mode for the S-parameter, E_inc / Z_s = H_inc, and for the voltage
+  // for the given port element.
+  double GetSParameterCoefficient(const LumpedElementData &elem) const;
+  double GetVoltageCoefficient(const LumpedElementData &elem) const;
 };
 
 //
@@ -89,6 +81,21 @@ private:
   // ports.
   std::map<int, LumpedPortData> ports;
   mfem::Array<int> port_marker, port_Rs_marker, port_Ls_marker, port_Cs_marker;
+
+  // Port functionals for postprocessing, assembled on first use for the spaces of the given
+  // fields. The S-parameter and voltage functionals of all ports are stored as the columns
+  // of a small multivector on the local ND space DOFs of the port boundaries, and the power
+  // of each port as a sparse bilinear form coupling these DOFs to the local and
+  // face-neighbor RT space DOFs of the neighboring elements.
+  mutable const mfem::ParFiniteElementSpace *nd_fespace, *rt_fespace;
+  mutable mfem::Array<int> port_nd_dofs, port_rt_dofs;
+  mutable mfem::DenseMatrix port_sv;
+  mutable std::vector<std::unique_ptr<mfem::SparseMatrix>> port_p;
+  void AssemblePortFunctionals(const mfem::ParGridFunction &E,
+                               const mfem::ParGridFunction &B,
+                               const MaterialOperator &mat_op,
+                               const BdrFaceGeometry &bdr_geom) const;
+
   void SetUpBoundaryProperties(const IoData &iodata,
                                mfem::ParFiniteElementSpace &h1_fespace);
   void PrintBoundaryInfo(const IoData &iodata, mfem::ParMesh &mesh);
@@ -110,6 +117,17 @@ public:
   const mfem::Array<int> &GetLsMarker() const { return port_Ls_marker; }
   const mfem::Array<int> &GetCsMarker() const { return port_Cs_marker; }
 
+  // Compute the S-parameters, powers, and voltages for all lumped ports, ordered by port
+  // index, from the real and imaginary parts of the electric field and magnetic flux
+  // density (imaginary parts may be nullptr for real-valued fields). Values for all ports
+  // are computed from the assembled port functionals with a single global reduction.
+  void GetPortValues(const mfem::ParGridFunction &Er, const mfem::ParGridFunction *Ei,
+                     const mfem::ParGridFunction &Br, const mfem::ParGridFunction *Bi,
+                     const MaterialOperator &mat_op, const BdrFaceGeometry &bdr_geom,
+                     std::vector<std::complex<double>> &S,
+                     std::vector<std::complex<double>> &P,
+                     std::vector<std::complex<double>> &V) const;
+
   // Add contributions to system matrices from lumped elements with nonzero inductance,
   // capacitance, and/or resistance.
   void AddStiffnessBdrCoefficients(double coef, SumMatrixCoefficient &fb);
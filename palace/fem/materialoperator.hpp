@@ -35,6 +35,7 @@ public:
   MaterialOperator(const IoData &iodata, const mfem::ParMesh &mesh);
 
   int SpaceDimension() const { return sdim; }
+  int GetAttributeMax() const { return static_cast<int>(mat_muinv.size()); }
 
   const auto &GetInvPermeability(int attr) const { return mat_muinv[attr - 1]; }
   const auto &GetPermittivityReal(int attr) const { return mat_epsilon[attr - 1]; }
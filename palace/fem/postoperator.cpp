@@ -24,18 +24,6 @@ using namespace std::complex_literals;
 namespace
 {
 
-auto LocalToShared(const mfem::ParMesh &mesh)
-{
-  // Construct shared face mapping required for boundary coefficients.
-  std::map<int, int> l2s;
-  for (int i = 0; i < mesh.GetNSharedFaces(); i++)
-  {
-    int i_local = mesh.GetSharedFace(i);
-    l2s[i_local] = i;
-  }
-  return l2s;
-}
-
 auto CreateParaviewPath(const IoData &iodata, const std::string &name)
 {
   std::string path = iodata.problem.output;
@@ -47,48 +35,106 @@ auto CreateParaviewPath(const IoData &iodata, const std::string &name)
   return path;
 }
 
+std::vector<int> GetOutputElements(mfem::ParMesh &mesh, const config::FieldOutputData &data,
+                                   bool bdr)
+{
+  // Select the local elements (or boundary elements) with the given attributes and with
+  // centers inside any of the given bounding boxes.
+  const std::vector<int> &attributes = bdr ? data.bdr_attributes : data.attributes;
+  const mfem::Array<int> &mesh_attr = bdr ? mesh.bdr_attributes : mesh.attributes;
+  const int attr_max = mesh_attr.Size() ? mesh_attr.Max() : 0;
+  std::vector<bool> attr_marker(attr_max, attributes.empty());
+  for (auto attr : attributes)
+  {
+    if (attr > 0 && attr <= attr_max)
+    {
+      attr_marker[attr - 1] = true;
+    }
+  }
+  const int sdim = mesh.SpaceDimension();
+  const int nboxes = static_cast<int>(data.bbmin.size()) / 3;
+  std::vector<int> elems;
+  mfem::Vector c;
+  for (int e = 0; e < (bdr ? mesh.GetNBE() : mesh.GetNE()); e++)
+  {
+    if (!attr_marker[(bdr ? mesh.GetBdrAttribute(e) : mesh.GetAttribute(e)) - 1])
+    {
+      continue;
+    }
+    if (nboxes > 0)
+    {
+      const mfem::Geometry::Type geom =
+          bdr ? mesh.GetBdrElementBaseGeometry(e) : mesh.GetElementBaseGeometry(e);
+      mfem::ElementTransformation *T =
+          bdr ? mesh.GetBdrElementTransformation(e) : mesh.GetElementTransformation(e);
+      T->Transform(mfem::Geometries.GetCenter(geom), c);
+      bool inside = false;
+      for (int b = 0; b < nboxes && !inside; b++)
+      {
+        inside = true;
+        for (int d = 0; d < std::min(sdim, 3); d++)
+        {
+          if (c(d) < data.bbmin[3 * b + d] || c(d) > data.bbmax[3 * b + d])
+          {
+            inside = false;
+            break;
+          }
+        }
+      }
+      if (!inside)
+      {
+        continue;
+      }
+    }
+    elems.push_back(e);
+  }
+  return elems;
+}
+
 }  // namespace
 
 PostOperator::PostOperator(const IoData &iodata, SpaceOperator &spaceop,
                            const std::string &name)
-  : local_to_shared(LocalToShared(*spaceop.GetNDSpace().GetParMesh())),
+  : bdr_geom(*spaceop.GetNDSpace().GetParMesh()),
     mat_op(spaceop.GetMaterialOp()),
-    surf_post_op(iodata, spaceop.GetMaterialOp(), local_to_shared, spaceop.GetH1Space()),
+    surf_post_op(iodata, spaceop.GetMaterialOp(), bdr_geom, spaceop.GetH1Space()),
     dom_post_op(iodata, spaceop.GetMaterialOp(), &spaceop.GetNDSpace(),
                 &spaceop.GetRTSpace()),
     has_imaginary(iodata.problem.type != config::ProblemData::Type::TRANSIENT),
     E(&spaceop.GetNDSpace()), B(&spaceop.GetRTSpace()), V(std::nullopt), A(std::nullopt),
     lumped_port_init(false), wave_port_init(false),
-    paraview(CreateParaviewPath(iodata, name), spaceop.GetNDSpace().GetParMesh()),
+    paraview(CreateParaviewPath(iodata, name), spaceop.GetNDSpace().GetParMesh(),
+             iodata.problem.async_output),
     paraview_bdr(CreateParaviewPath(iodata, name) + "_boundary",
-                 spaceop.GetNDSpace().GetParMesh()),
-    interp_op(iodata, *spaceop.GetNDSpace().GetParMesh())
-{
-  Esr = std::make_unique<BdrFieldVectorCoefficient>(E->real(), mat_op, local_to_shared);
-  Bsr = std::make_unique<BdrFieldVectorCoefficient>(B->real(), mat_op, local_to_shared);
-  Jsr = std::make_unique<BdrCurrentVectorCoefficient>(B->real(), mat_op, local_to_shared);
-  Qsr = std::make_unique<BdrChargeCoefficient>(E->real(), mat_op, local_to_shared);
+                 spaceop.GetNDSpace().GetParMesh(), iodata.problem.async_output),
+    interp_op(iodata, *spaceop.GetNDSpace().GetParMesh()),
+    sample_op(iodata, *spaceop.GetNDSpace().GetParMesh())
+{
+  Esr = std::make_unique<BdrFieldVectorCoefficient>(E->real(), mat_op, bdr_geom);
+  Bsr = std::make_unique<BdrFieldVectorCoefficient>(B->real(), mat_op, bdr_geom);
+  Jsr = std::make_unique<BdrCurrentVectorCoefficient>(B->real(), mat_op, bdr_geom);
+  Qsr = std::make_unique<BdrChargeCoefficient>(E->real(), mat_op, bdr_geom);
   if (has_imaginary)
   {
-    Esi = std::make_unique<BdrFieldVectorCoefficient>(E->imag(), mat_op, local_to_shared);
-    Bsi = std::make_unique<BdrFieldVectorCoefficient>(B->imag(), mat_op, local_to_shared);
-    Jsi = std::make_unique<BdrCurrentVectorCoefficient>(B->imag(), mat_op, local_to_shared);
-    Qsi = std::make_unique<BdrChargeCoefficient>(E->imag(), mat_op, local_to_shared);
+    Esi = std::make_unique<BdrFieldVectorCoefficient>(E->imag(), mat_op, bdr_geom);
+    Bsi = std::make_unique<BdrFieldVectorCoefficient>(B->imag(), mat_op, bdr_geom);
+    Jsi = std::make_unique<BdrCurrentVectorCoefficient>(B->imag(), mat_op, bdr_geom);
+    Qsi = std::make_unique<BdrChargeCoefficient>(E->imag(), mat_op, bdr_geom);
     Ue = std::make_unique<EnergyDensityCoefficient<EnergyDensityType::ELECTRIC,
                                                    EnergyDensityValueType::COMPLEX>>(
-        *E, mat_op, local_to_shared);
+        *E, mat_op, bdr_geom);
     Um = std::make_unique<EnergyDensityCoefficient<EnergyDensityType::MAGNETIC,
                                                    EnergyDensityValueType::COMPLEX>>(
-        *B, mat_op, local_to_shared);
+        *B, mat_op, bdr_geom);
   }
   else
   {
     Ue = std::make_unique<EnergyDensityCoefficient<EnergyDensityType::ELECTRIC,
                                                    EnergyDensityValueType::REAL>>(
-        E->real(), mat_op, local_to_shared);
+        E->real(), mat_op, bdr_geom);
     Um = std::make_unique<EnergyDensityCoefficient<EnergyDensityType::MAGNETIC,
                                                    EnergyDensityValueType::REAL>>(
-        B->real(), mat_op, local_to_shared);
+        B->real(), mat_op, bdr_geom);
   }
 
   // Initialize data collection objects and register additional fields associated with wave
@@ -105,28 +151,29 @@ PostOperator::PostOperator(const IoData &iodata, SpaceOperator &spaceop,
 
 PostOperator::PostOperator(const IoData &iodata, LaplaceOperator &laplaceop,
                            const std::string &name)
-  : local_to_shared(LocalToShared(*laplaceop.GetNDSpace().GetParMesh())),
+  : bdr_geom(*laplaceop.GetNDSpace().GetParMesh()),
     mat_op(laplaceop.GetMaterialOp()),
-    surf_post_op(iodata, laplaceop.GetMaterialOp(), local_to_shared,
-                 laplaceop.GetH1Space()),
+    surf_post_op(iodata, laplaceop.GetMaterialOp(), bdr_geom, laplaceop.GetH1Space()),
     dom_post_op(iodata, laplaceop.GetMaterialOp(), &laplaceop.GetNDSpace(), nullptr),
     has_imaginary(false), E(&laplaceop.GetNDSpace()), B(std::nullopt),
     V(&laplaceop.GetH1Space()), A(std::nullopt), lumped_port_init(false),
     wave_port_init(false),
-    paraview(CreateParaviewPath(iodata, name), laplaceop.GetNDSpace().GetParMesh()),
+    paraview(CreateParaviewPath(iodata, name), laplaceop.GetNDSpace().GetParMesh(),
+             iodata.problem.async_output),
     paraview_bdr(CreateParaviewPath(iodata, name) + "_boundary",
-                 laplaceop.GetNDSpace().GetParMesh()),
-    interp_op(iodata, *laplaceop.GetNDSpace().GetParMesh())
+                 laplaceop.GetNDSpace().GetParMesh(), iodata.problem.async_output),
+    interp_op(iodata, *laplaceop.GetNDSpace().GetParMesh()),
+    sample_op(iodata, *laplaceop.GetNDSpace().GetParMesh())
 {
   // Note: When using this constructor, you should not use any of the magnetic field related
   // postprocessing functions (magnetic field energy, inductor energy, surface currents,
   // etc.), since only V and E fields are supplied.
-  Esr = std::make_unique<BdrFieldVectorCoefficient>(E->real(), mat_op, local_to_shared);
-  Vs = std::make_unique<BdrFieldCoefficient>(*V, mat_op, local_to_shared);
+  Esr = std::make_unique<BdrFieldVectorCoefficient>(E->real(), mat_op, bdr_geom);
+  Vs = std::make_unique<BdrFieldCoefficient>(*V, mat_op, bdr_geom);
   Ue = std::make_unique<
       EnergyDensityCoefficient<EnergyDensityType::ELECTRIC, EnergyDensityValueType::REAL>>(
-      E->real(), mat_op, local_to_shared);
-  Qsr = std::make_unique<BdrChargeCoefficient>(E->real(), mat_op, local_to_shared);
+      E->real(), mat_op, bdr_geom);
+  Qsr = std::make_unique<BdrChargeCoefficient>(E->real(), mat_op, bdr_geom);
 
   // Initialize data collection objects.
   InitializeDataCollection(iodata);
@@ -134,27 +181,28 @@ PostOperator::PostOperator(const IoData &iodata, LaplaceOperator &laplaceop,
 
 PostOperator::PostOperator(const IoData &iodata, CurlCurlOperator &curlcurlop,
                            const std::string &name)
-  : local_to_shared(LocalToShared(*curlcurlop.GetNDSpace().GetParMesh())),
+  : bdr_geom(*curlcurlop.GetNDSpace().GetParMesh()),
     mat_op(curlcurlop.GetMaterialOp()),
-    surf_post_op(iodata, curlcurlop.GetMaterialOp(), local_to_shared,
-                 curlcurlop.GetH1Space()),
+    surf_post_op(iodata, curlcurlop.GetMaterialOp(), bdr_geom, curlcurlop.GetH1Space()),
     dom_post_op(iodata, curlcurlop.GetMaterialOp(), nullptr, &curlcurlop.GetRTSpace()),
     has_imaginary(false), E(std::nullopt), B(&curlcurlop.GetRTSpace()), V(std::nullopt),
     A(&curlcurlop.GetNDSpace()), lumped_port_init(false), wave_port_init(false),
-    paraview(CreateParaviewPath(iodata, name), curlcurlop.GetNDSpace().GetParMesh()),
+    paraview(CreateParaviewPath(iodata, name), curlcurlop.GetNDSpace().GetParMesh(),
+             iodata.problem.async_output),
     paraview_bdr(CreateParaviewPath(iodata, name) + "_boundary",
-                 curlcurlop.GetNDSpace().GetParMesh()),
-    interp_op(iodata, *curlcurlop.GetNDSpace().GetParMesh())
+                 curlcurlop.GetNDSpace().GetParMesh(), iodata.problem.async_output),
+    interp_op(iodata, *curlcurlop.GetNDSpace().GetParMesh()),
+    sample_op(iodata, *curlcurlop.GetNDSpace().GetParMesh())
 {
   // Note: When using this constructor, you should not use any of the electric field related
   // postprocessing functions (electric field energy, capacitor energy, surface charge,
   // etc.), since only the B field is supplied.
-  Bsr = std::make_unique<BdrFieldVectorCoefficient>(B->real(), mat_op, local_to_shared);
-  As = std::make_unique<BdrFieldVectorCoefficient>(*A, mat_op, local_to_shared);
+  Bsr = std::make_unique<BdrFieldVectorCoefficient>(B->real(), mat_op, bdr_geom);
+  As = std::make_unique<BdrFieldVectorCoefficient>(*A, mat_op, bdr_geom);
   Um = std::make_unique<
       EnergyDensityCoefficient<EnergyDensityType::MAGNETIC, EnergyDensityValueType::REAL>>(
-      B->real(), mat_op, local_to_shared);
-  Jsr = std::make_unique<BdrCurrentVectorCoefficient>(B->real(), mat_op, local_to_shared);
+      B->real(), mat_op, bdr_geom);
+  Jsr = std::make_unique<BdrCurrentVectorCoefficient>(B->real(), mat_op, bdr_geom);
 
   // Initialize data collection objects.
   InitializeDataCollection(iodata);
@@ -163,18 +211,35 @@ PostOperator::PostOperator(const IoData &iodata, CurlCurlOperator &curlcurlop,
 void PostOperator::InitializeDataCollection(const IoData &iodata)
 {
   // Set up postprocessing for output to disk. Results are stored in a directory at
-  // `iodata.problem.output/paraview`.
-  const mfem::VTKFormat format = mfem::VTKFormat::BINARY32;
+  // `iodata.problem.output/paraview`. Half precision output is written as single precision
+  // values rounded to the 10 mantissa bits of half precision, which compress better.
+  const auto &output = iodata.problem.field_output;
+  const mfem::VTKFormat format =
+      (output.format == config::FieldOutputData::DataFormat::FLOAT64)
+          ? mfem::VTKFormat::BINARY
+          : mfem::VTKFormat::BINARY32;
+  const int mantissa_bits =
+      (output.format == config::FieldOutputData::DataFormat::FLOAT16) ? 10 : 0;
 #if defined(MFEM_USE_ZLIB)
   const int compress = -1;  // Default compression level
 #else
   const int compress = 0;
 #endif
   const bool use_ho = true;
-  const int refine_ho =
+  int refine_ho =
       (E) ? E->ParFESpace()->GetMaxElementOrder() : B->ParFESpace()->GetMaxElementOrder();
+  if (output.max_levels_of_detail > 0)
+  {
+    refine_ho = std::min(refine_ho, output.max_levels_of_detail);
+  }
   const double mesh_Lc0 =
       iodata.DimensionalizeValue(IoData::ValueType::LENGTH, 1.0 / iodata.model.L0);
+  auto HasField = [&output](const std::string &name)
+  {
+    return output.fields.empty() ||
+           std::find(output.fields.begin(), output.fields.end(), name) !=
+               output.fields.end();
+  };
 
   // Output mesh coordinate units same as input.
   paraview.SetDataFormat(format);
@@ -182,6 +247,7 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
   paraview.SetHighOrderOutput(use_ho);
   paraview.SetLevelsOfDetail(refine_ho);
   paraview.SetLengthScale(mesh_Lc0);
+  paraview.SetMantissaBits(mantissa_bits);
 
   paraview_bdr.SetBoundaryOutput(true);
   paraview_bdr.SetDataFormat(format);
@@ -189,13 +255,26 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
   paraview_bdr.SetHighOrderOutput(use_ho);
   paraview_bdr.SetLevelsOfDetail(refine_ho);
   paraview_bdr.SetLengthScale(mesh_Lc0);
+  paraview_bdr.SetMantissaBits(mantissa_bits);
+
+  // Restrict the output to the selected attributes and regions.
+  mfem::ParMesh &mesh =
+      (E) ? *E->ParFESpace()->GetParMesh() : *B->ParFESpace()->GetParMesh();
+  if (!output.attributes.empty() || !output.bbmin.empty())
+  {
+    paraview.SetOutputElements(GetOutputElements(mesh, output, false));
+  }
+  if (!output.bdr_attributes.empty() || !output.bbmin.empty())
+  {
+    paraview_bdr.SetOutputElements(GetOutputElements(mesh, output, true));
+  }
 
   // Output fields @ phase = 0 and π/2 for frequency domain (rather than, for example,
   // peak phasors or magnitude = sqrt(2) * RMS). Also output fields evaluated on mesh
   // boundaries. For internal boundary surfaces, this takes the field evaluated in the
   // neighboring element with the larger dielectric permittivity or magnetic
   // permeability.
-  if (E)
+  if (E && HasField("E"))
   {
     if (has_imaginary)
     {
@@ -210,7 +289,7 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
       paraview_bdr.RegisterVCoeffField("E", Esr.get());
     }
   }
-  if (B)
+  if (B && HasField("B"))
   {
     if (has_imaginary)
     {
@@ -225,12 +304,12 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
       paraview_bdr.RegisterVCoeffField("B", Bsr.get());
     }
   }
-  if (V)
+  if (V && HasField("V"))
   {
     paraview.RegisterField("V", &*V);
     paraview_bdr.RegisterCoeffField("V", Vs.get());
   }
-  if (A)
+  if (A && HasField("A"))
   {
     paraview.RegisterField("A", &*A);
     paraview_bdr.RegisterVCoeffField("A", As.get());
@@ -239,7 +318,7 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
   // Extract surface charge from normally discontinuous ND E-field. Also extract surface
   // currents from tangentially discontinuous RT B-field The surface charge and surface
   // currents are single-valued at internal boundaries.
-  if (Qsr)
+  if (Qsr && HasField("Qs"))
   {
     if (has_imaginary)
     {
@@ -251,7 +330,7 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
       paraview_bdr.RegisterCoeffField("Qs", Qsr.get());
     }
   }
-  if (Jsr)
+  if (Jsr && HasField("Js"))
   {
     if (has_imaginary)
     {
@@ -266,12 +345,12 @@ void PostOperator::InitializeDataCollection(const IoData &iodata)
 
   // Extract energy density field for electric field energy 1/2 Dᴴ E or magnetic field
   // energy 1/2 Bᴴ H.
-  if (Ue)
+  if (Ue && HasField("Ue"))
   {
     paraview.RegisterCoeffField("Ue", Ue.get());
     paraview_bdr.RegisterCoeffField("Ue", Ue.get());
   }
-  if (Um)
+  if (Um && HasField("Um"))
   {
     paraview.RegisterCoeffField("Um", Um.get());
     paraview_bdr.RegisterCoeffField("Um", Um.get());
@@ -375,6 +454,45 @@ void PostOperator::SetAGridFunction(const mfem::Vector &a)
   A->ExchangeFaceNbrData();
 }
 
+void PostOperator::AddErrorIndicator(ErrorIndicator &indicator) const
+{
+  // Compute the error indicators from the flux D = ε E for electrostatics, or from
+  // H = μ⁻¹ B for all other problem types (the real and imaginary parts contribute
+  // together).
+  MFEM_VERIFY((V && E) || B, "Incorrect usage of PostOperator::AddErrorIndicator!");
+  const mfem::ParGridFunction &F = V ? E->real() : B->real();
+  if (!estimator)
+  {
+    estimator = std::make_unique<FluxErrorEstimator>(
+        *F.ParFESpace()->GetParMesh(), F.ParFESpace()->GetMaxElementOrder());
+  }
+  mfem::Vector err2;
+  double norm2 = 0.0;
+  auto AddFlux = [this, &err2, &norm2](mfem::MatrixCoefficient &coef,
+                                      const mfem::ParGridFunction &U)
+  {
+    mfem::VectorGridFunctionCoefficient Ucoef(&U);
+    mfem::MatrixVectorProductCoefficient Fcoef(coef, Ucoef);
+    norm2 += estimator->AddErrorIndicator(Fcoef, err2);
+  };
+  if (V)
+  {
+    MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_REAL> epsilon_func(
+        mat_op);
+    AddFlux(epsilon_func, E->real());
+  }
+  else
+  {
+    MaterialPropertyCoefficient<MaterialPropertyType::INV_PERMEABILITY> muinv_func(mat_op);
+    AddFlux(muinv_func, B->real());
+    if (has_imaginary)
+    {
+      AddFlux(muinv_func, B->imag());
+    }
+  }
+  indicator.AddIndicator(err2, norm2);
+}
+
 void PostOperator::UpdatePorts(const LumpedPortOperator &lumped_port_op, double omega)
 {
   MFEM_VERIFY(E && B, "Incorrect usage of PostOperator::UpdatePorts!");
@@ -382,6 +500,11 @@ void PostOperator::UpdatePorts(const LumpedPortOperator &lumped_port_op, double
   {
     return;
   }
+  std::vector<std::complex<double>> S, P, V;
+  lumped_port_op.GetPortValues(E->real(), has_imaginary ? &E->imag() : nullptr, B->real(),
+                               has_imaginary ? &B->imag() : nullptr, mat_op, bdr_geom,
+                               S, P, V);
+  int i = 0;
   for (const auto &[idx, data] : lumped_port_op)
   {
     auto &vi = lumped_port_vi[idx];
@@ -390,17 +513,18 @@ void PostOperator::UpdatePorts(const LumpedPortOperator &lumped_port_op, double
       MFEM_VERIFY(
           omega > 0.0,
           "Frequency domain lumped port postprocessing requires nonzero frequency!");
-      vi.S = data.GetSParameter(*E);
-      vi.P = data.GetPower(*E, *B, mat_op, local_to_shared);
-      vi.V = data.GetVoltage(*E);
+      vi.S = S[i];
+      vi.P = P[i];
+      vi.V = V[i];
       vi.Z = data.GetCharacteristicImpedance(omega);
     }
     else
     {
-      vi.P = data.GetPower(E->real(), B->real(), mat_op, local_to_shared);
-      vi.V = data.GetVoltage(E->real());
+      vi.P = P[i].real();
+      vi.V = V[i].real();
       vi.S = vi.Z = 0.0;
     }
+    i++;
   }
   lumped_port_init = true;
 }
@@ -418,7 +542,7 @@ void PostOperator::UpdatePorts(const WavePortOperator &wave_port_op, double omeg
                 "Frequency domain wave port postprocessing requires nonzero frequency!");
     auto &vi = wave_port_vi[idx];
     vi.S = data.GetSParameter(*E);
-    vi.P = data.GetPower(*E, *B, mat_op, local_to_shared);
+    vi.P = data.GetPower(*E, *B, mat_op, bdr_geom);
     vi.V = vi.Z = 0.0;  // Not yet implemented (Z = V² / P, I = V / Z)
   }
   wave_port_init = true;
@@ -615,30 +739,31 @@ double PostOperator::GetExternalKappa(const LumpedPortOperator &lumped_port_op,
                        Imj.real());  // mean(I²) = (I_r² + I_i²) / 2
 }
 
-double PostOperator::GetBulkParticipation(int idx, double Em) const
-{
-  // Compute the bulk dielectric participation ratio material given by index idx. Here, we
-  // have:
-  //                     p_mj = E_elec,j / (E_elec + E_cap).
-  MFEM_VERIFY(E, "Bulk Q not defined, no electric field solution found!");
-  double Ebulk = has_imaginary ? dom_post_op.GetDomainElectricFieldEnergy(idx, *E)
-                               : dom_post_op.GetDomainElectricFieldEnergy(idx, E->real());
-  return Ebulk / Em;
-}
-
-double PostOperator::GetBulkQualityFactor(int idx, double Em) const
+std::map<int, std::pair<double, double>>
+PostOperator::GetBulkParticipations(double Em) const
 {
-  // Compute the associated quality factor for the material given by index idx. Here, we
-  // have:
+  // Compute the bulk dielectric participation ratio and associated quality factor for the
+  // material given by index idx. Here, we have:
+  //                     p_mj = E_elec,j / (E_elec + E_cap)
+  // and:
   //             1/Q_mj = p_mj tan(δ)_j = tan(δ)_j E_elec,j / (E_elec + E_cap).
   MFEM_VERIFY(E, "Bulk Q not defined, no electric field solution found!");
-  double Ebulki = has_imaginary
-                      ? dom_post_op.GetDomainElectricFieldEnergyLoss(idx, *E)
-                      : dom_post_op.GetDomainElectricFieldEnergyLoss(idx, E->real());
-  return (Ebulki == 0.0) ? mfem::infinity() : Em / Ebulki;
+  const std::vector<double> vals =
+      has_imaginary ? dom_post_op.GetDomainElectricFieldEnergies(*E)
+                    : dom_post_op.GetDomainElectricFieldEnergies(E->real());
+  std::map<int, std::pair<double, double>> pQ;
+  int i = 0;
+  for (const auto &[idx, data] : dom_post_op.GetEps())
+  {
+    const double Ebulk = vals[i++];
+    const double Ebulki = vals[i++];
+    pQ.emplace(idx, std::make_pair(Ebulk / Em,
+                                   (Ebulki == 0.0) ? mfem::infinity() : Em / Ebulki));
+  }
+  return pQ;
 }
 
-double PostOperator::GetInterfaceParticipation(int idx, double Em) const
+std::map<int, double> PostOperator::GetInterfaceParticipations(double Em) const
 {
   // Compute the surface dielectric participation ratio and associated quality factor for
   // the material interface given by index idx. We have:
@@ -646,43 +771,79 @@ double PostOperator::GetInterfaceParticipation(int idx, double Em) const
   // with:
   //          p_mj = 1/2 t_j Re{∫_{Γ_j} (ε_j E_m)ᴴ E_m dS} /(E_elec + E_cap).
   MFEM_VERIFY(E, "Surface Q not defined, no electric field solution found!");
-  double Esurf = surf_post_op.GetInterfaceElectricFieldEnergy(idx, E->real());
+  std::vector<const mfem::ParGridFunction *> U = {&E->real()};
   if (has_imaginary)
   {
-    Esurf += surf_post_op.GetInterfaceElectricFieldEnergy(idx, E->imag());
+    U.push_back(&E->imag());
+  }
+  const std::vector<double> vals = surf_post_op.GetInterfaceElectricFieldEnergies(U);
+  std::map<int, double> p;
+  int i = 0;
+  for (const auto &[idx, data] : surf_post_op.GetEps())
+  {
+    double Esurf = vals[i++];
+    if (has_imaginary)
+    {
+      Esurf += vals[i++];
+    }
+    p.emplace(idx, Esurf / Em);
   }
-  return Esurf / Em;
+  return p;
 }
 
-double PostOperator::GetSurfaceCharge(int idx) const
+std::map<int, double> PostOperator::GetSurfaceCharges() const
 {
   // Compute the induced charge on a surface as Q_j = ∫ D ⋅ n_j dS, which correctly handles
-  // two-sided internal surfaces using a special GridFunction coefficient which accounts
-  // for both sides of the surface. This then yields the capacitive coupling to the
-  // excitation as C_jk = Q_j / V_k where V_k is the excitation voltage.
+  // two-sided internal surfaces by accounting for both sides of the surface. This then
+  // yields the capacitive coupling to the excitation as C_jk = Q_j / V_k where V_k is the
+  // excitation voltage.
   MFEM_VERIFY(E, "Surface capacitance not defined, no electric field solution found!");
-  double Q = surf_post_op.GetSurfaceElectricCharge(idx, E->real());
+  std::vector<const mfem::ParGridFunction *> U = {&E->real()};
   if (has_imaginary)
   {
-    double Qi = surf_post_op.GetSurfaceElectricCharge(idx, E->imag());
-    Q = std::copysign(std::sqrt(Q * Q + Qi * Qi), Q);
+    U.push_back(&E->imag());
+  }
+  const std::vector<double> vals = surf_post_op.GetSurfaceElectricCharges(U);
+  std::map<int, double> Q;
+  int i = 0;
+  for (const auto &[idx, data] : surf_post_op.GetCap())
+  {
+    double Qj = vals[i++];
+    if (has_imaginary)
+    {
+      const double Qji = vals[i++];
+      Qj = std::copysign(std::sqrt(Qj * Qj + Qji * Qji), Qj);
+    }
+    Q.emplace(idx, Qj);
   }
   return Q;
 }
 
-double PostOperator::GetSurfaceFlux(int idx) const
+std::map<int, double> PostOperator::GetSurfaceFluxes() const
 {
   // Compute the magnetic flux through a surface as Φ_j = ∫ B ⋅ n_j dS. This then yields the
   // inductive coupling to the excitation as M_jk = Φ_j / I_k where I_k is the excitation
-  // current. The special coefficient is used to avoid issues evaluating MFEM GridFunctions
-  // which are discontinuous at interior boundary elements.
+  // current. The flux is averaged over both sides of interior boundary elements, to avoid
+  // issues evaluating MFEM GridFunctions which are discontinuous there.
   MFEM_VERIFY(B,
               "Surface inductance not defined, no magnetic flux density solution found!");
-  double Phi = surf_post_op.GetSurfaceMagneticFlux(idx, B->real());
+  std::vector<const mfem::ParGridFunction *> U = {&B->real()};
   if (has_imaginary)
   {
-    double Phii = surf_post_op.GetSurfaceMagneticFlux(idx, B->imag());
-    Phi = std::copysign(std::sqrt(Phi * Phi + Phii * Phii), Phi);
+    U.push_back(&B->imag());
+  }
+  const std::vector<double> vals = surf_post_op.GetSurfaceMagneticFluxes(U);
+  std::map<int, double> Phi;
+  int i = 0;
+  for (const auto &[idx, data] : surf_post_op.GetInd())
+  {
+    double Phij = vals[i++];
+    if (has_imaginary)
+    {
+      const double Phiji = vals[i++];
+      Phij = std::copysign(std::sqrt(Phij * Phij + Phiji * Phiji), Phij);
+    }
+    Phi.emplace(idx, Phij);
   }
   return Phi;
 }
@@ -715,16 +876,69 @@ void PostOperator::WriteFields(int step, double time) const
   paraview_bdr.Save();
 }
 
-std::vector<std::complex<double>> PostOperator::ProbeEField() const
+void PostOperator::FlushFields() const
 {
-  MFEM_VERIFY(E, "PostOperator is not configured for electric field probes!");
-  return interp_op.ProbeField(*E, has_imaginary);
+  paraview.Flush();
+  paraview_bdr.Flush();
+}
+
+void PostOperator::ProbeFields(std::vector<std::complex<double>> &vE,
+                               std::vector<std::complex<double>> &vB) const
+{
+  // Interpolate all available fields together.
+  std::vector<const mfem::ParComplexGridFunction *> U;
+  if (E)
+  {
+    U.push_back(&*E);
+  }
+  if (B)
+  {
+    U.push_back(&*B);
+  }
+  std::vector<std::vector<std::complex<double>>> F =
+      interp_op.ProbeFields(U, has_imaginary);
+  vE = (E) ? std::move(F.front()) : std::vector<std::complex<double>>();
+  vB = (B) ? std::move(F.back()) : std::vector<std::complex<double>>();
 }
 
-std::vector<std::complex<double>> PostOperator::ProbeBField() const
+void PostOperator::SampleFields(std::vector<std::vector<double>> &vE,
+                                std::vector<std::vector<double>> &vB) const
 {
-  MFEM_VERIFY(B, "PostOperator is not configured for magnetic flux density probes!");
-  return interp_op.ProbeField(*B, has_imaginary);
+  // Sample the real and imaginary parts of all available fields together.
+  std::vector<const mfem::ParGridFunction *> U;
+  if (E)
+  {
+    U.push_back(&E->real());
+    if (has_imaginary)
+    {
+      U.push_back(&E->imag());
+    }
+  }
+  if (B)
+  {
+    U.push_back(&B->real());
+    if (has_imaginary)
+    {
+      U.push_back(&B->imag());
+    }
+  }
+  std::vector<std::vector<double>> vals = sample_op.Sample(U);
+  vE.clear();
+  vB.clear();
+  if (vals.empty())
+  {
+    return;
+  }
+  auto it = vals.begin();
+  if (E)
+  {
+    vE.assign(it, it + (has_imaginary ? 2 : 1));
+    it += vE.size();
+  }
+  if (B)
+  {
+    vB.assign(it, it + (has_imaginary ? 2 : 1));
+  }
 }
 
 }  // namespace palace
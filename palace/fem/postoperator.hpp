@@ -9,11 +9,15 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 #include <mfem.hpp>
 #include "fem/domainpostoperator.hpp"
+#include "fem/errorestimator.hpp"
 #include "fem/interpolationoperator.hpp"
+#include "fem/samplingoperator.hpp"
 #include "fem/surfacepostoperator.hpp"
+#include "utils/asyncdatacollection.hpp"
 
 namespace palace
 {
@@ -41,8 +45,8 @@ class PetscParVector;
 class PostOperator
 {
 private:
-  // Shared face mapping for boundary coefficients.
-  std::map<int, int> local_to_shared;
+  // Face data of the boundary elements for boundary coefficients.
+  BdrFaceGeometry bdr_geom;
 
   // Reference to material property operator (not owned).
   const MaterialOperator &mat_op;
@@ -67,11 +71,16 @@ private:
   std::map<int, PortPostData> lumped_port_vi, wave_port_vi;
   bool lumped_port_init, wave_port_init;
 
-  // Data collection for writing fields to disk for visualization and sampling points.
-  mutable mfem::ParaViewDataCollection paraview, paraview_bdr;
+  // Data collection for writing fields to disk for visualization and sampling points. The
+  // field output files are optionally written asynchronously.
+  mutable AsyncParaViewDataCollection paraview, paraview_bdr;
   mutable InterpolationOperator interp_op;
+  SamplingOperator sample_op;
   void InitializeDataCollection(const IoData &iodata);
 
+  // Flux recovery error estimator for adaptive mesh refinement, constructed on first use.
+  mutable std::unique_ptr<FluxErrorEstimator> estimator;
+
 public:
   PostOperator(const IoData &iodata, SpaceOperator &spaceop, const std::string &name);
   PostOperator(const IoData &iodata, LaplaceOperator &laplaceop, const std::string &name);
@@ -167,32 +176,50 @@ public:
   double GetExternalKappa(const LumpedPortOperator &lumped_port_op, int idx,
                           double Em) const;
 
-  // Postprocess the participation ratio or quality factor for bulk lossy dielectric losses
-  // in the electric field mode.
-  double GetBulkParticipation(int idx, double Em) const;
-  double GetBulkQualityFactor(int idx, double Em) const;
+  // Postprocess the participation ratio and quality factor for bulk lossy dielectric
+  // losses in the electric field mode, for all domains (keyed by domain index).
+  std::map<int, std::pair<double, double>> GetBulkParticipations(double Em) const;
 
   // Postprocess the partitipation ratio for interface lossy dielectric losses in the
-  // electric field mode.
-  double GetInterfaceParticipation(int idx, double Em) const;
+  // electric field mode, for all interface surfaces (keyed by surface index).
+  std::map<int, double> GetInterfaceParticipations(double Em) const;
+
+  // Postprocess the charge or flux for all surfaces using the electric field solution or
+  // the magnetic flux density field solution (keyed by surface index).
+  std::map<int, double> GetSurfaceCharges() const;
+  std::map<int, double> GetSurfaceFluxes() const;
 
-  // Postprocess the charge or flux for a surface index using the electric field solution
-  // or the magnetic flux density field solution.
-  double GetSurfaceCharge(int idx) const;
-  double GetSurfaceFlux(int idx) const;
+  // Add the element-wise error indicators for the current solution to the provided
+  // indicator, using the electric flux density for electrostatic solutions and the magnetic
+  // field otherwise.
+  void AddErrorIndicator(ErrorIndicator &indicator) const;
 
   // Write to disk the E- and B-fields extracted from the solution vectors. Note that fields
   // are not redimensionalized, to do so one needs to compute: B <= B * (μ₀ H₀), E <= E *
   // (Z₀ H₀), V <= V * (Z₀ H₀ L₀), etc.
   void WriteFields(int step, double time) const;
 
+  // Wait until all field output has been written to disk, for asynchronous output. Errors
+  // writing any of the output files are reported here.
+  void FlushFields() const;
+
   // Probe the E- and B-fields for their vector-values at speceified locations in space.
   // Locations of probes are set up in constructor from configuration file data. If
   // has_imaginary is false, the returned fields have only nonzero real parts. Output
-  // vectors are ordered by vector dimension, that is [v1x, v1y, v1z, v2x, v2y, v2z, ...].
+  // vectors are ordered by vector dimension, that is [v1x, v1y, v1z, v2x, v2y, v2z, ...],
+  // and are empty for fields which are not available. All fields are probed together.
   const auto &GetProbes() const { return interp_op.GetProbes(); }
-  std::vector<std::complex<double>> ProbeEField() const;
-  std::vector<std::complex<double>> ProbeBField() const;
+  void ProbeFields(std::vector<std::complex<double>> &vE,
+                   std::vector<std::complex<double>> &vB) const;
+
+  // Sample the E- and B-fields on the structured grids of points of the sampling regions
+  // set up in the constructor from configuration file data. On the root process, the real
+  // part (and imaginary part if has_imaginary is true) of each available field is returned
+  // with values ordered by vector dimension first, over all points of all regions.
+  const auto &GetSamplingRegions() const { return sample_op.GetRegions(); }
+  int GetNumSamplingPoints() const { return sample_op.GetNumPoints(); }
+  void SampleFields(std::vector<std::vector<double>> &vE,
+                    std::vector<std::vector<double>> &vB) const;
 };
 
 }  // namespace palace
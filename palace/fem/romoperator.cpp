@@ -31,6 +31,9 @@ RomOperator::RomOperator(const IoData &iodata, SpaceOperator &sp, int nmax)
   C = spaceop.GetSystemMatrixPetsc(SpaceOperator::OperatorType::DAMPING,
                                    mfem::Operator::DIAG_ZERO);
 
+  // The operator for HDM solves and residual evaluation is constructed on first use.
+  KMC = nullptr;
+
   // Set up the linear solver and set operators but don't set the operators yet (this will
   // be done during an HDM solve at a given parameter point). The preconditioner for the
   // complex linear system is constructed from a real approximation to the complex system
@@ -151,12 +154,21 @@ void RomOperator::SolveHDM(double omega, petsc::PetscParVector &E, bool print)
     MFEM_VERIFY(step >= 0 && static_cast<std::size_t>(step) < A2.size(),
                 "Invalid out-of-range frequency for PROM solution!");
     std::vector<std::unique_ptr<mfem::Operator>> P, AuxP;
-    A2[step] = spaceop.GetSystemMatrixPetsc(SpaceOperator::OperatorType::EXTRA, omega,
-                                            mfem::Operator::DIAG_ZERO, print);
-    auto A = utils::GetSystemMatrixShell(omega, *K, *M, C.get(), A2[step].get());
+    if (!A2[step])
+    {
+      A2[step] = spaceop.GetSystemMatrixPetsc(SpaceOperator::OperatorType::EXTRA, omega,
+                                              mfem::Operator::DIAG_ZERO, print);
+    }
+    std::unique_ptr<petsc::PetscParMatrix> A;
+    const petsc::PetscParMatrix *opA = GetSystemMatrixSum(omega, A2[step].get());
+    if (!opA)
+    {
+      A = utils::GetSystemMatrixShell(omega, *K, *M, C.get(), A2[step].get());
+      opA = A.get();
+    }
     spaceop.GetPreconditionerMatrix(omega, P, AuxP, print);
     pc0->SetOperator(P, &AuxP);
-    ksp0->SetOperator(*A);
+    ksp0->SetOperator(*opA);
 
     Mpi::Print("\n");
     spaceop.GetFreqDomainExcitationVector(omega, *R0);
@@ -176,51 +188,34 @@ void RomOperator::SolveHDM(double omega, petsc::PetscParVector &E, bool print)
   dim = (has_real) + (has_imag) + static_cast<int>(dim0);
   MFEM_VERIFY(dim <= nmax, "Unable to increase basis storage size, increase maximum number "
                            "of vectors!");
-  bool mgs = false, cgs2 = true;
   if (has_real && has_imag)
   {
     {
       petsc::PetscParVector v = V->GetColumn(dim - 2);
       v.SetFromVector(Er_);
       V->RestoreColumn(dim - 2, v);
-      if (opKM)
-      {
-        V->OrthonormalizeColumn(dim - 2, mgs, cgs2, *opKM, *T0);
-      }
-      else
-      {
-        V->OrthonormalizeColumn(dim - 2, mgs, cgs2);
-      }
     }
     {
       petsc::PetscParVector v = V->GetColumn(dim - 1);
       v.SetFromVector(Ei_);
       V->RestoreColumn(dim - 1, v);
-      if (opKM)
-      {
-        V->OrthonormalizeColumn(dim - 1, mgs, cgs2, *opKM, *T0);
-      }
-      else
-      {
-        V->OrthonormalizeColumn(dim - 1, mgs, cgs2);
-      }
     }
   }
   else
   {
-    {
-      petsc::PetscParVector v = V->GetColumn(dim - 1);
-      v.Copy(E);
-      V->RestoreColumn(dim - 1, v);
-      if (opKM)
-      {
-        V->OrthonormalizeColumn(dim - 1, mgs, cgs2, *opKM, *T0);
-      }
-      else
-      {
-        V->OrthonormalizeColumn(dim - 1, mgs, cgs2);
-      }
-    }
+    petsc::PetscParVector v = V->GetColumn(dim - 1);
+    v.Copy(E);
+    V->RestoreColumn(dim - 1, v);
+  }
+
+  // Orthonormalize the new basis vectors as a block against the existing basis.
+  if (opKM)
+  {
+    V->OrthonormalizeColumns(dim0, dim - dim0, *opKM);
+  }
+  else
+  {
+    V->OrthonormalizeColumns(dim0, dim - dim0);
   }
 
   // Update reduced-order operators. Resize preserves the upper dim0 x dim0 block of each
@@ -268,7 +263,14 @@ void RomOperator::AssemblePROM(double omega)
                                             mfem::Operator::DIAG_ZERO, false);
     if (tA2)
     {
+      // The stored system matrix sum may reference the matrix being replaced, so release it
+      // to be constructed again on next use.
       hasA2 = true;
+      if (A2[step])
+      {
+        opKMC.reset();
+        KMC = nullptr;
+      }
       A2[step] = std::move(tA2);
     }
     auto tRHS2 = std::make_unique<petsc::PetscParVector>(*K);
@@ -439,18 +441,25 @@ double RomOperator::ComputeError(double omega)
     den = R0->Norml2();
   }
 
-  K->MultAdd(*E0, *R0);
-  M->Mult(*E0, *T0);
-  R0->AXPY(-omega * omega, *T0);
-  if (C)
+  MFEM_VERIFY(!hasA2 || A2[step], "Unexpected uncached frequency for A2 matrix in PROM!");
+  if (const auto *opA = GetSystemMatrixSum(omega, A2[step].get()))
   {
-    C->Mult(*E0, *T0);
-    R0->AXPY(1i * omega, *T0);
+    opA->MultAdd(*E0, *R0);
   }
-  if (hasA2)
+  else
   {
-    MFEM_VERIFY(A2[step], "Unexpected uncached frequency for A2 matrix in PROM!");
-    A2[step]->MultAdd(*E0, *R0);
+    K->MultAdd(*E0, *R0);
+    M->Mult(*E0, *T0);
+    R0->AXPY(-omega * omega, *T0);
+    if (C)
+    {
+      C->Mult(*E0, *T0);
+      R0->AXPY(1i * omega, *T0);
+    }
+    if (hasA2)
+    {
+      A2[step]->MultAdd(*E0, *R0);
+    }
   }
   if (!kspKM)
   {
@@ -467,6 +476,27 @@ double RomOperator::ComputeError(double omega)
   return num / den;
 }
 
+const petsc::PetscParMatrix *
+RomOperator::GetSystemMatrixSum(double omega, const petsc::PetscParMatrix *A2)
+{
+  // The sum is constructed again only if the terms do not fit in the stored sparsity
+  // pattern (for example when A2(ω) is first included).
+  std::vector<const mfem::HypreParMatrix *> mats;
+  std::vector<std::complex<double>> weights;
+  if (!utils::GetSystemMatrixTerms(omega, *K, *M, C.get(), A2, mats, weights))
+  {
+    return nullptr;
+  }
+  if (!KMC || !KMC->Update(mats, weights))
+  {
+    auto sum = std::make_unique<hypre::HypreParMatrixSum>(mats, weights);
+    KMC = sum.get();
+    opKMC = std::make_unique<petsc::PetscShellMatrix>(K->GetComm(), std::move(sum));
+    opKMC->SetSymmetric();
+  }
+  return opKMC.get();
+}
+
 void RomOperator::BVMatProjectInternal(petsc::PetscDenseMatrix &V, petsc::PetscParMatrix &A,
                                        petsc::PetscDenseMatrix &Ar,
                                        petsc::PetscParVector &r, int n0, int n)
@@ -9,6 +9,7 @@
 #include <vector>
 #include <mfem.hpp>
 #include "linalg/curlcurl.hpp"
+#include "linalg/hypre.hpp"
 #include "linalg/ksp.hpp"
 #include "linalg/pc.hpp"
 #include "linalg/petsc.hpp"
@@ -44,6 +45,18 @@ private:
   // Working storage for HDM vectors.
   std::unique_ptr<petsc::PetscParVector> E0, R0, T0;
 
+  // Operator K + iω C - ω² M + A2(ω) stored on a shared sparsity pattern (if available),
+  // for HDM solves and residual evaluation, and a non-owning pointer to the underlying sum.
+  // The shared pattern is kept and only the values of the sum are updated for each ω. The
+  // sum references the A2(ω) matrices, so it is released when one of them is replaced.
+  std::unique_ptr<petsc::PetscParMatrix> opKMC;
+  hypre::HypreParMatrixSum *KMC;
+
+  // Update the stored operator K + iω C - ω² M + A2(ω) for the given frequency. Returns
+  // nullptr if the matrices cannot be stored on a shared sparsity pattern.
+  const petsc::PetscParMatrix *GetSystemMatrixSum(double omega,
+                                                  const petsc::PetscParMatrix *A2);
+
   // PROM matrices, vectors, and linear solver.
   std::unique_ptr<petsc::PetscDenseMatrix> Kr, Mr, Cr, Ar;
   std::unique_ptr<petsc::PetscParVector> RHS1r, RHSr, Er;
@@ -0,0 +1,255 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "samplingoperator.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include "utils/communication.hpp"
+#include "utils/iodata.hpp"
+
+namespace palace
+{
+
+std::array<double, 3> SamplingOperator::Region::GetPoint(int i) const
+{
+  // Points are numbered with the first axis varying fastest.
+  std::array<double, 3> x = origin;
+  for (std::size_t a = 0; a < axes.size(); a++)
+  {
+    const int j = i % n[a];
+    i /= n[a];
+    const double t = (n[a] > 1) ? static_cast<double>(j) / (n[a] - 1) : 0.0;
+    for (int d = 0; d < 3; d++)
+    {
+      x[d] += t * axes[a][d];
+    }
+  }
+  return x;
+}
+
+SamplingOperator::SamplingOperator(const IoData &iodata, mfem::ParMesh &mesh)
+  : comm(mesh.GetComm()), npts(0)
+{
+  for (const auto &[idx, data] : iodata.domains.postpro.sampling)
+  {
+    const int n = std::accumulate(data.npts.begin(), data.npts.end(), 1,
+                                  [](int a, int b) { return a * b; });
+    regions.push_back({idx, npts, n, data.origin, data.axes, data.npts});
+    npts += n;
+  }
+  if (regions.empty())
+  {
+    return;
+  }
+#if defined(MFEM_USE_GSLIB)
+  // Each process searches for a contiguous block of the points of all regions. The results
+  // are sent to the processes owning the points, which cache the element and reference
+  // coordinates of each point for evaluating the fields.
+  const double bb_t = 0.1;  // MFEM defaults
+  const double newton_tol = 1.0e-12;
+  const int dim = mesh.SpaceDimension();
+  MFEM_VERIFY(
+      mesh.Dimension() == dim,
+      "Sampling postprocessing functionality requires mesh dimension == space dimension!");
+  const int rank = Mpi::Rank(comm), size = Mpi::Size(comm);
+  const int start = static_cast<int>((static_cast<long long int>(npts) * rank) / size),
+            end = static_cast<int>((static_cast<long long int>(npts) * (rank + 1)) / size);
+  const int nq = end - start;
+  mfem::Vector xyz(nq * dim);
+  {
+    std::size_t r = 0;
+    for (int i = start; i < end; i++)
+    {
+      while (i >= regions[r].offset + regions[r].npts)
+      {
+        r++;
+      }
+      const std::array<double, 3> x = regions[r].GetPoint(i - regions[r].offset);
+      for (int d = 0; d < dim; d++)
+      {
+        // Use default ordering byNODES.
+        xyz(d * nq + i - start) = x[d];
+      }
+    }
+  }
+  std::vector<int> send_counts(size, 0), send_displs(size + 1, 0);
+  std::vector<int> send_ints, recv_ints;
+  std::vector<double> send_ref, recv_ref;
+  int nlost = 0;
+  {
+    mfem::FindPointsGSLIB op(comm);
+    op.Setup(mesh, bb_t, newton_tol, std::max(nq, 1));
+    op.FindPoints(xyz, mfem::Ordering::byNODES);
+    const auto &code = op.GetCode();
+    const auto &proc = op.GetProc();
+    const auto &elem = op.GetElem();
+    const auto &ref = op.GetReferencePosition();
+    for (int i = 0; i < nq; i++)
+    {
+      if (code[i] == 2)
+      {
+        nlost++;
+        continue;
+      }
+      send_counts[proc[i]]++;
+    }
+    std::partial_sum(send_counts.begin(), send_counts.end(), send_displs.begin() + 1);
+    std::vector<int> pos(send_displs.begin(), send_displs.end() - 1);
+    send_ints.resize(2 * send_displs.back());
+    send_ref.resize(dim * send_displs.back());
+    for (int i = 0; i < nq; i++)
+    {
+      if (code[i] == 2)
+      {
+        continue;
+      }
+      const int k = pos[proc[i]]++;
+      send_ints[2 * k] = start + i;
+      send_ints[2 * k + 1] = elem[i];
+      for (int d = 0; d < dim; d++)
+      {
+        send_ref[dim * k + d] = ref(i * dim + d);
+      }
+    }
+  }
+  Mpi::GlobalSum(1, &nlost, comm);
+  if (nlost > 0)
+  {
+    Mpi::Warning(comm,
+                 "{:d} sampling point{} could not be found!\nUsing default value 0.0!\n",
+                 nlost, (nlost > 1) ? "s" : "");
+  }
+
+  // Exchange the located points with their owning processes.
+  std::vector<int> recv_point_counts(size), recv_point_displs(size + 1, 0);
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_point_counts.data(), 1, MPI_INT, comm);
+  std::partial_sum(recv_point_counts.begin(), recv_point_counts.end(),
+                   recv_point_displs.begin() + 1);
+  {
+    auto Exchange = [&](int m, auto *send, auto *recv, MPI_Datatype type)
+    {
+      std::vector<int> sc(size), sd(size), rc(size), rd(size);
+      for (int p = 0; p < size; p++)
+      {
+        sc[p] = m * send_counts[p];
+        sd[p] = m * send_displs[p];
+        rc[p] = m * recv_point_counts[p];
+        rd[p] = m * recv_point_displs[p];
+      }
+      MPI_Alltoallv(send, sc.data(), sd.data(), type, recv, rc.data(), rd.data(), type,
+                    comm);
+    };
+    const int nloc = recv_point_displs.back();
+    recv_ints.resize(2 * nloc);
+    recv_ref.resize(dim * nloc);
+    Exchange(2, send_ints.data(), recv_ints.data(), MPI_INT);
+    Exchange(dim, send_ref.data(), recv_ref.data(), MPI_DOUBLE);
+    loc_pts.resize(nloc);
+    loc_elems.resize(nloc);
+    loc_ips.resize(nloc);
+    for (int k = 0; k < nloc; k++)
+    {
+      loc_pts[k] = recv_ints[2 * k];
+      loc_elems[k] = recv_ints[2 * k + 1];
+      if (dim == 3)
+      {
+        loc_ips[k].Set3(&recv_ref[dim * k]);
+      }
+      else
+      {
+        loc_ips[k].Set2(&recv_ref[dim * k]);
+      }
+    }
+  }
+
+  // Gather the global indices of the points owned by each process on the root process, for
+  // assembling the sampled values.
+  const bool root = Mpi::Root(comm);
+  int nloc = static_cast<int>(loc_pts.size());
+  if (root)
+  {
+    recv_counts.resize(size);
+    recv_displs.resize(size + 1, 0);
+  }
+  MPI_Gather(&nloc, 1, MPI_INT, recv_counts.data(), 1, MPI_INT, 0, comm);
+  if (root)
+  {
+    std::partial_sum(recv_counts.begin(), recv_counts.end(), recv_displs.begin() + 1);
+    recv_pts.resize(recv_displs.back());
+  }
+  MPI_Gatherv(loc_pts.data(), nloc, MPI_INT, recv_pts.data(), recv_counts.data(),
+              recv_displs.data(), MPI_INT, 0, comm);
+#else
+  MFEM_ABORT("SamplingOperator class requires MFEM_USE_GSLIB!");
+#endif
+}
+
+std::vector<std::vector<double>>
+SamplingOperator::Sample(const std::vector<const mfem::ParGridFunction *> &U) const
+{
+  // Evaluate all fields at the local points, with the values for each point stored
+  // contiguously, and gather them on the root process.
+  int ncomp = 0;
+  for (const auto *u : U)
+  {
+    ncomp += u->VectorDim();
+  }
+  const int nloc = static_cast<int>(loc_pts.size());
+  std::vector<double> vals(nloc * ncomp);
+  mfem::Vector v;
+  for (int k = 0, c = 0; k < static_cast<int>(U.size()); k++)
+  {
+    const int vdim = U[k]->VectorDim();
+    for (int j = 0; j < nloc; j++)
+    {
+      U[k]->GetVectorValue(loc_elems[j], loc_ips[j], v);
+      for (int d = 0; d < vdim; d++)
+      {
+        vals[j * ncomp + c + d] = v(d);
+      }
+    }
+    c += vdim;
+  }
+  const bool root = Mpi::Root(comm);
+  const int size = Mpi::Size(comm);
+  std::vector<double> recv_vals;
+  std::vector<int> counts, displs;
+  if (root)
+  {
+    recv_vals.resize(recv_pts.size() * ncomp);
+    counts.resize(size);
+    displs.resize(size);
+    for (int p = 0; p < size; p++)
+    {
+      counts[p] = recv_counts[p] * ncomp;
+      displs[p] = recv_displs[p] * ncomp;
+    }
+  }
+  MPI_Gatherv(vals.data(), nloc * ncomp, MPI_DOUBLE, recv_vals.data(), counts.data(),
+              displs.data(), MPI_DOUBLE, 0, comm);
+  if (!root)
+  {
+    return {};
+  }
+
+  // Reorder the values by field, component, and global point index.
+  std::vector<std::vector<double>> F(U.size());
+  for (int k = 0, c = 0; k < static_cast<int>(U.size()); k++)
+  {
+    const int vdim = U[k]->VectorDim();
+    F[k].resize(static_cast<std::size_t>(npts) * vdim, 0.0);
+    for (std::size_t j = 0; j < recv_pts.size(); j++)
+    {
+      for (int d = 0; d < vdim; d++)
+      {
+        F[k][static_cast<std::size_t>(d) * npts + recv_pts[j]] =
+            recv_vals[j * ncomp + c + d];
+      }
+    }
+    c += vdim;
+  }
+  return F;
+}
+
+}  // namespace palace
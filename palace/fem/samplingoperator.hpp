@@ -0,0 +1,76 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PALACE_SAMPLING_OPERATOR_HPP
+#define PALACE_SAMPLING_OPERATOR_HPP
+
+#include <array>
+#include <vector>
+#include <mfem.hpp>
+
+namespace palace
+{
+
+class IoData;
+
+//
+// A class for sampling fields on structured grids of points along lines, planes, or
+// volumes, for large numbers of points. The points of all sampling regions are distributed
+// across the processes and located once with MFEM's GSLIB interface. The owning process,
+// element, and reference coordinates of each point are cached on construction, so that
+// sampling the fields only requires local evaluation and a single gather to the root
+// process.
+//
+class SamplingOperator
+{
+public:
+  struct Region
+  {
+    // Sampling region index from the configuration file.
+    int idx;
+
+    // Offset of the first point of this region in the list of all points, and number of
+    // points.
+    int offset, npts;
+
+    // Structured grid of points: origin, spanning axes, and points along each axis.
+    std::array<double, 3> origin;
+    std::vector<std::array<double, 3>> axes;
+    std::vector<int> n;
+
+    // Coordinates of the i-th point of this region.
+    std::array<double, 3> GetPoint(int i) const;
+  };
+
+private:
+  MPI_Comm comm;
+
+  // Sampling regions and total number of points over all regions.
+  std::vector<Region> regions;
+  int npts;
+
+  // Points located in the local elements, with their global indices, elements, and
+  // reference coordinates.
+  std::vector<int> loc_pts, loc_elems;
+  std::vector<mfem::IntegrationPoint> loc_ips;
+
+  // Global indices of the points owned by each process, gathered on the root process.
+  std::vector<int> recv_pts, recv_counts, recv_displs;
+
+public:
+  SamplingOperator(const IoData &iodata, mfem::ParMesh &mesh);
+
+  // Sample the given fields at the points of all sampling regions. On the root process,
+  // the values for each field are returned ordered by vector dimension first, that is [v1x,
+  // v2x, ..., v1y, v2y, ...] over all points (empty on all other processes). Points which
+  // could not be found have value zero.
+  std::vector<std::vector<double>>
+  Sample(const std::vector<const mfem::ParGridFunction *> &U) const;
+
+  const auto &GetRegions() const { return regions; }
+  int GetNumPoints() const { return npts; }
+};
+
+}  // namespace palace
+
+#endif  // PALACE_SAMPLING_OPERATOR_HPP
@@ -4,6 +4,7 @@
 #include "spaceoperator.hpp"
 
 #include <complex>
+#include "linalg/complex.hpp"
 #include "linalg/petsc.hpp"
 #include "utils/communication.hpp"
 #include "utils/geodata.hpp"
@@ -110,7 +111,8 @@ SpaceOperator::SpaceOperator(const IoData &iodata,
                              const std::vector<std::unique_ptr<mfem::ParMesh>> &mesh)
   : dbc_marker(SetUpBoundaryProperties(iodata, *mesh.back())), skip_zeros(0),
     pc_gmg(iodata.solver.linear.mat_gmg), pc_lor(iodata.solver.linear.mat_lor),
-    pc_shifted(iodata.solver.linear.mat_shifted), print_hdr(true),
+    pc_shifted(iodata.solver.linear.mat_shifted),
+    pc_complex(iodata.solver.linear.mat_complex), print_hdr(true),
     nd_fecs(utils::ConstructFECollections<mfem::ND_FECollection>(
         pc_gmg, pc_lor, iodata.solver.order, mesh.back()->Dimension())),
     h1_fecs(utils::ConstructFECollections<mfem::H1_FECollection>(
@@ -129,7 +131,7 @@ SpaceOperator::SpaceOperator(const IoData &iodata,
     surf_z_op(iodata, *mesh.back()), lumped_port_op(iodata, h1_fespaces.GetFinestFESpace()),
     wave_port_op(iodata, mat_op, nd_fespaces.GetFinestFESpace(),
                  h1_fespaces.GetFinestFESpace()),
-    surf_j_op(iodata, h1_fespaces.GetFinestFESpace())
+    surf_j_op(iodata, h1_fespaces.GetFinestFESpace()), reuse_assembly(false)
 {
   // Finalize setup.
   CheckBoundaryProperties();
@@ -260,6 +262,7 @@ SpaceOperator::GetSystemMatrixPetsc(SpaceOperator::OperatorType type, double ome
     default:
       MFEM_ABORT("Invalid GetSystemMatrix matrix type!");
   }
+  const bool reuse = reuse_assembly && type == OperatorType::COMPLETE;
   std::unique_ptr<mfem::HypreParMatrix> hAr, hAi;
   bool has_real = false, has_imag = false;
   if (!dfr.empty() || !fr.empty() || !dfbr.empty() || !fbr.empty())
@@ -268,10 +271,22 @@ SpaceOperator::GetSystemMatrixPetsc(SpaceOperator::OperatorType type, double ome
     mfem::ParBilinearForm a(&nd_fespaces.GetFinestFESpace());
     AddIntegrators(a, dfr, fr, dfbr, fbr);
     // a.SetAssemblyLevel(mfem::AssemblyLevel::FULL);
+    if (reuse)
+    {
+      Ar_p.UseSparsity(a);
+    }
     a.Assemble(skip_zeros);
     a.Finalize(skip_zeros);
-    hAr.reset(a.ParallelAssemble());
-    hAr->EliminateBC(dbc_tdof_list, ess_diag);
+    if (reuse)
+    {
+      Ar_p.Assemble(a, dbc_tdof_list, ess_diag);
+      hAr = Ar_p.GetView();
+    }
+    else
+    {
+      hAr.reset(a.ParallelAssemble());
+      hAr->EliminateBC(dbc_tdof_list, ess_diag);
+    }
   }
   if (!dfi.empty() || !fi.empty() || !dfbi.empty() || !fbi.empty())
   {
@@ -279,10 +294,22 @@ SpaceOperator::GetSystemMatrixPetsc(SpaceOperator::OperatorType type, double ome
     mfem::ParBilinearForm a(&nd_fespaces.GetFinestFESpace());
     AddIntegrators(a, dfi, fi, dfbi, fbi);
     // a.SetAssemblyLevel(mfem::AssemblyLevel::FULL);
+    if (reuse)
+    {
+      Ai_p.UseSparsity(a);
+    }
     a.Assemble(skip_zeros);
     a.Finalize(skip_zeros);
-    hAi.reset(a.ParallelAssemble());
-    hAi->EliminateBC(dbc_tdof_list, mfem::Operator::DiagonalPolicy::DIAG_ZERO);
+    if (reuse)
+    {
+      Ai_p.Assemble(a, dbc_tdof_list, mfem::Operator::DiagonalPolicy::DIAG_ZERO);
+      hAi = Ai_p.GetView();
+    }
+    else
+    {
+      hAi.reset(a.ParallelAssemble());
+      hAi->EliminateBC(dbc_tdof_list, mfem::Operator::DiagonalPolicy::DIAG_ZERO);
+    }
   }
   if (!has_real && !has_imag)
   {
@@ -377,7 +404,7 @@ void SpaceOperator::GetPreconditionerInternal(
     const std::function<void(SumMatrixCoefficient &, SumMatrixCoefficient &,
                              SumCoefficient &, SumMatrixCoefficient &)> &AddCoefficients,
     std::vector<std::unique_ptr<mfem::Operator>> &B,
-    std::vector<std::unique_ptr<mfem::Operator>> &AuxB, bool print)
+    std::vector<std::unique_ptr<mfem::Operator>> &AuxB, bool print, bool imag)
 {
   // Construct the real, optionally SPD matrix for frequency or time domain preconditioning
   // (Mr > 0, Mi < 0):
@@ -385,6 +412,16 @@ void SpaceOperator::GetPreconditionerInternal(
   //              B = a0 K + a1 C +         Mr .
   MFEM_VERIFY(h1_fespaces.GetNumLevels() == nd_fespaces.GetNumLevels(),
               "Multigrid heirarchy mismatch for auxiliary space preconditioning!");
+  auto &B_p_ = imag ? Bi_p : B_p;
+  auto &AuxB_p_ = imag ? AuxBi_p : AuxB_p;
+  const auto diag_policy = imag ? mfem::Operator::DiagonalPolicy::DIAG_ZERO
+                                : mfem::Operator::DiagonalPolicy::DIAG_ONE;
+  const char *name = pc_complex ? (imag ? "Im{B}" : "Re{B}") : "B";
+  if (reuse_assembly)
+  {
+    B_p_.resize(nd_fespaces.GetNumLevels());
+    AuxB_p_.resize(nd_fespaces.GetNumLevels());
+  }
   for (int s = 0; s < 2; s++)
   {
     auto &B_ = (s == 0) ? B : AuxB;
@@ -401,6 +438,12 @@ void SpaceOperator::GetPreconditionerInternal(
       SumMatrixCoefficient df(sdim), f(sdim), fb(sdim);
       SumCoefficient dfb;
       AddCoefficients(df, f, dfb, fb);
+      if (imag && f.empty() && fb.empty() && (s == 1 || (df.empty() && dfb.empty())))
+      {
+        // No contribution to the imaginary part.
+        B_.push_back(nullptr);
+        continue;
+      }
       mfem::ParBilinearForm b(&fespace_l);
       if (s == 1)
       {
@@ -412,6 +455,10 @@ void SpaceOperator::GetPreconditionerInternal(
         AddIntegrators(b, df, f, dfb, fb);
       }
       // b.SetAssemblyLevel(mfem::AssemblyLevel::FULL);
+      if (reuse_assembly && !pc_lor)
+      {
+        ((s == 0) ? B_p_[l] : AuxB_p_[l]).UseSparsity(b);
+      }
       b.Assemble(skip_zeros);
       b.Finalize(skip_zeros);
       std::unique_ptr<mfem::HypreParMatrix> hB;
@@ -422,11 +469,27 @@ void SpaceOperator::GetPreconditionerInternal(
         mfem::ParLORDiscretization lor(b, dbc_tdof_list_l);
         hB = std::make_unique<mfem::HypreParMatrix>(lor.GetAssembledMatrix());
       }
-      else
+      else if (!reuse_assembly)
       {
         hB.reset(b.ParallelAssemble());
       }
-      hB->EliminateBC(dbc_tdof_list_l, mfem::Operator::DiagonalPolicy::DIAG_ONE);
+      if (reuse_assembly)
+      {
+        auto &B_l = (s == 0) ? B_p_[l] : AuxB_p_[l];
+        if (hB)
+        {
+          B_l.Assemble(std::move(hB), dbc_tdof_list_l, diag_policy);
+        }
+        else
+        {
+          B_l.Assemble(b, dbc_tdof_list_l, diag_policy);
+        }
+        hB = B_l.GetView();
+      }
+      else
+      {
+        hB->EliminateBC(dbc_tdof_list_l, diag_policy);
+      }
 
       // Print some information.
       PrintHeader();
@@ -446,7 +509,7 @@ void SpaceOperator::GetPreconditionerInternal(
         {
           str = " (LOR)";
         }
-        Mpi::Print(" B{}: NNZ = {:d}, norm = {:e}\n", str, hB->NNZ(),
+        Mpi::Print(" {}{}: NNZ = {:d}, norm = {:e}\n", name, str, hB->NNZ(),
                    hypre_ParCSRMatrixFnorm(*hB));
       }
       B_.push_back(std::move(hB));
@@ -458,6 +521,43 @@ void SpaceOperator::GetPreconditionerMatrix(
     double omega, std::vector<std::unique_ptr<mfem::Operator>> &B,
     std::vector<std::unique_ptr<mfem::Operator>> &AuxB, bool print)
 {
+  if (pc_complex)
+  {
+    // Complex-valued frequency domain preconditioner matrix, using the real and imaginary
+    // parts of the system matrix A = K + iω C - ω² (Mr + i Mi) + A2(ω).
+    const int sdim = nd_fespaces.GetFinestFESpace().GetParMesh()->SpaceDimension();
+    auto AddRealCoefficients = [this, omega, sdim](
+                                   SumMatrixCoefficient &df, SumMatrixCoefficient &f,
+                                   SumCoefficient &dfb, SumMatrixCoefficient &fb)
+    {
+      SumMatrixCoefficient fbi(sdim);
+      SumCoefficient dfbi;
+      this->AddStiffnessCoefficients(1.0, df, f, fb);
+      this->AddRealMassCoefficients(-omega * omega, false, f, fb);
+      this->AddExtraSystemBdrCoefficients(omega, dfb, dfbi, fb, fbi);
+    };
+    auto AddImagCoefficients = [this, omega, sdim](
+                                   SumMatrixCoefficient &df, SumMatrixCoefficient &f,
+                                   SumCoefficient &dfb, SumMatrixCoefficient &fb)
+    {
+      SumMatrixCoefficient fbr(sdim);
+      SumCoefficient dfbr;
+      this->AddDampingCoefficients(omega, f, fb);
+      this->AddImagMassCoefficients(-omega * omega, f, fb);
+      this->AddExtraSystemBdrCoefficients(omega, dfbr, dfb, fbr, fb);
+    };
+    std::vector<std::unique_ptr<mfem::Operator>> Bi, AuxBi;
+    GetPreconditionerInternal(AddRealCoefficients, B, AuxB, print);
+    GetPreconditionerInternal(AddImagCoefficients, Bi, AuxBi, print, true);
+    for (std::size_t l = 0; l < B.size(); l++)
+    {
+      B[l] = std::make_unique<ComplexWrapperOperator>(std::move(B[l]), std::move(Bi[l]));
+      AuxB[l] =
+          std::make_unique<ComplexWrapperOperator>(std::move(AuxB[l]), std::move(AuxBi[l]));
+    }
+    return;
+  }
+
   // Frequency domain preconditioner matrix.
   auto AddCoefficients = [this, omega](SumMatrixCoefficient &df, SumMatrixCoefficient &f,
                                        SumCoefficient &dfb, SumMatrixCoefficient &fb)
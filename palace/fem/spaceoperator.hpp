@@ -15,6 +15,7 @@
 #include "fem/surfacecurrentoperator.hpp"
 #include "fem/surfaceimpedanceoperator.hpp"
 #include "fem/waveportoperator.hpp"
+#include "linalg/hypre.hpp"
 
 namespace palace
 {
@@ -46,6 +47,7 @@ private:
   const bool pc_gmg;      // Whether to use geometric multigrid in preconditioning
   const bool pc_lor;      // Whether to use low-order refined (LOR) preconditioner
   const bool pc_shifted;  // Whether the preconditioner uses the shifted mass matrix
+  const bool pc_complex;  // Whether the preconditioner uses the complex system matrix
 
   // Helper variable and function for log file printing.
   bool print_hdr;
@@ -71,12 +73,22 @@ private:
   WavePortOperator wave_port_op;
   SurfaceCurrentOperator surf_j_op;
 
-  // Helper function to assemble preconditioner matrix data structures.
+  // Persistent storage for the complete system matrix and the preconditioner matrices at
+  // each multigrid level, which are repeatedly reassembled with unchanged sparsity during
+  // frequency sweeps or time integration. Only used when enabled with SetReuseAssembly.
+  bool reuse_assembly;
+  hypre::PersistentParMatrix Ar_p, Ai_p;
+  std::vector<hypre::PersistentParMatrix> B_p, AuxB_p, Bi_p, AuxBi_p;
+
+  // Helper function to assemble preconditioner matrix data structures. When imag is true,
+  // the assembled matrices are the imaginary parts of complex-valued preconditioner
+  // matrices (zero diagonal for eliminated rows, and nullptr for levels with no
+  // contributions).
   void GetPreconditionerInternal(
       const std::function<void(SumMatrixCoefficient &, SumMatrixCoefficient &,
                                SumCoefficient &, SumMatrixCoefficient &)> &AddCoefficients,
       std::vector<std::unique_ptr<mfem::Operator>> &B,
-      std::vector<std::unique_ptr<mfem::Operator>> &AuxB, bool print);
+      std::vector<std::unique_ptr<mfem::Operator>> &AuxB, bool print, bool imag = false);
 
   // Helper functions for building the bilinear forms corresponding to the discretized
   // operators in Maxwell's equations.
@@ -127,6 +139,12 @@ public:
   auto &GetH1Space() { return h1_fespaces.GetFinestFESpace(); }
   auto &GetRTSpace() { return rt_fespace; }
 
+  // Enable reuse of the sparsity pattern, communication pattern, and essential BC
+  // elimination data for the complete system matrix and the preconditioner matrices. When
+  // enabled, the returned matrices reference storage owned by this object and are only
+  // valid until the next call assembling the same operator.
+  void SetReuseAssembly(bool reuse) { reuse_assembly = reuse; }
+
   // Construct the frequency-dependent complex linear system matrix:
   //                 A = K + iω C - ω² (Mr + i Mi) + A2(ω)
   // or any one of its terms. The type parameter controls which terms of the above
@@ -163,6 +181,9 @@ public:
   // (Mr > 0, Mi < 0):
   //              B =    K +  ω C + ω² (-/+ Mr - Mi) , or
   //              B = a0 K + a1 C +         Mr .
+  // When complex-valued preconditioning is enabled, the frequency domain preconditioner
+  // matrix at each level is instead the complex system matrix A(ω) (as a
+  // ComplexWrapperOperator).
   void GetPreconditionerMatrix(double omega,
                                std::vector<std::unique_ptr<mfem::Operator>> &B,
                                std::vector<std::unique_ptr<mfem::Operator>> &AuxB,
@@ -5,13 +5,74 @@
 
 #include <string>
 #include "fem/materialoperator.hpp"
+#include "utils/communication.hpp"
 #include "utils/geodata.hpp"
 #include "utils/iodata.hpp"
-#include "utils/mfemintegrators.hpp"
 
 namespace palace
 {
 
+namespace
+{
+
+// Calls f(i, w, nor, C1, T1, T2) at each surface quadrature point, for the boundary
+// elements belonging to the i-th attribute group of the surface (see
+// BdrGridFunctionQuadrature::ForEachPoint).
+template <typename F>
+void ForEachSurfaceQuadraturePoint(const mfem::ParFiniteElementSpace &h1_fespace,
+                                   const std::vector<mfem::Array<int>> &attr_markers,
+                                   const BdrFaceGeometry &bdr_geom, F &&f)
+{
+  BdrGridFunctionQuadrature bdr_quad(*h1_fespace.GetParMesh(), bdr_geom);
+  for (int i = 0; i < static_cast<int>(attr_markers.size()); i++)
+  {
+    bdr_quad.ForEachPoint(h1_fespace, attr_markers[i],
+                          [&](int, mfem::ElementTransformation &, double w,
+                              const double *nor, const double *C1,
+                              mfem::ElementTransformation &T1,
+                              mfem::ElementTransformation *T2)
+                          { f(i, w, nor, C1, T1, T2); });
+  }
+}
+
+// Adds a cᵀ u(x), for the vector field u evaluated at the current integration point of the
+// given element, to the linear functional w.
+void AddPointFunctional(const mfem::ParFiniteElementSpace &fespace,
+                        mfem::ElementTransformation &T, const double *c, double a,
+                        mfem::Vector &w)
+{
+  mfem::DenseMatrix vshape;
+  mfem::Array<int> vdofs;
+  mfem::DofTransformation *doftrans =
+      BdrGridFunctionQuadrature::GetElementVShape(fespace, T, vshape, vdofs);
+  mfem::Vector elvect(vshape.Height());
+  vshape.Mult(c, elvect.GetData());
+  elvect *= a;
+  if (doftrans)
+  {
+    doftrans->TransformDual(elvect);
+  }
+  w.AddElementVector(vdofs, elvect);
+}
+
+// Returns w ⋅ u summed over the local and face-neighbor DOFs of u.
+double LocalDot(const mfem::Vector &w, const mfem::ParGridFunction &U)
+{
+  const mfem::Vector &U_nbr = U.FaceNbrData();
+  double dot = 0.0;
+  for (int i = 0; i < U.Size(); i++)
+  {
+    dot += w(i) * U(i);
+  }
+  for (int i = 0; i < U_nbr.Size(); i++)
+  {
+    dot += w(U.Size() + i) * U_nbr(i);
+  }
+  return dot;
+}
+
+}  // namespace
+
 SurfacePostOperator::InterfaceDielectricData::InterfaceDielectricData(
     const config::InterfaceDielectricData &data, mfem::ParMesh &mesh)
   : type(DielectricInterfaceType::INVALID), epsilon(0.0), ts(data.ts),
@@ -101,28 +162,109 @@ SurfacePostOperator::InterfaceDielectricData::InterfaceDielectricData(
   }
 }
 
-std::unique_ptr<mfem::Coefficient>
-SurfacePostOperator::InterfaceDielectricData::GetCoefficient(
-    int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-    const std::map<int, int> &local_to_shared) const
+void SurfacePostOperator::InterfaceDielectricData::Assemble(
+    const mfem::ParFiniteElementSpace &fespace,
+    const mfem::ParFiniteElementSpace &h1_fespace, const MaterialOperator &mat_op,
+    const BdrFaceGeometry &bdr_geom) const
 {
-  switch (type)
-  {
-    case DielectricInterfaceType::MA:
-      return std::make_unique<DielectricInterfaceCoefficient<DielectricInterfaceType::MA>>(
-          U, mat_op, ts, epsilon, sides[i], local_to_shared);
-    case DielectricInterfaceType::MS:
-      return std::make_unique<DielectricInterfaceCoefficient<DielectricInterfaceType::MS>>(
-          U, mat_op, ts, epsilon, sides[i], local_to_shared);
-    case DielectricInterfaceType::SA:
-      return std::make_unique<DielectricInterfaceCoefficient<DielectricInterfaceType::SA>>(
-          U, mat_op, ts, epsilon, sides[i], local_to_shared);
-    case DielectricInterfaceType::DEFAULT:
-    default:
-      return std::make_unique<
-          DielectricInterfaceCoefficient<DielectricInterfaceType::DEFAULT>>(
-          U, mat_op, ts, epsilon, sides[i], local_to_shared);
-  }
+  // For each quadrature point, store the rows evaluating the single-sided field and the
+  // matrix A such that the integrand is Eᵀ A E (see DielectricInterfaceCoefficient).
+  const int sdim = fespace.GetParMesh()->SpaceDimension();
+  row_ptr.assign(1, 0);
+  col_idx.clear();
+  row_val.clear();
+  A.clear();
+  mfem::DenseMatrix vshape;
+  mfem::Array<int> vdofs;
+  mfem::Vector col;
+  ForEachSurfaceQuadraturePoint(
+      h1_fespace, attr_markers, bdr_geom,
+      [&](int i, double w, const double *nor, const double *C1,
+          mfem::ElementTransformation &T1, mfem::ElementTransformation *T2)
+      {
+        // Get the element for the single-sided solution.
+        mfem::ElementTransformation *T = &T1;
+        if (T2)
+        {
+          if (!sides[i].Size())
+          {
+            // With no side specified, try to take the solution from the element which
+            // corresponds to the vacuum domain, or at least the one with the higher speed
+            // of light.
+            if (mat_op.GetLightSpeedMin(T2->Attribute) >
+                mat_op.GetLightSpeedMax(T1.Attribute))
+            {
+              T = T2;
+            }
+          }
+          else
+          {
+            double dot = 0.0;
+            for (int d = 0; d < sdim; d++)
+            {
+              dot += C1[d] * sides[i](d);
+            }
+            if (dot < 0.0)
+            {
+              T = T2;
+            }
+          }
+        }
+
+        // Field evaluation rows for this point.
+        mfem::DofTransformation *doftrans =
+            BdrGridFunctionQuadrature::GetElementVShape(fespace, *T, vshape, vdofs);
+        col.SetSize(vshape.Height());
+        for (int d = 0; d < sdim; d++)
+        {
+          vshape.GetColumn(d, col);
+          if (doftrans)
+          {
+            doftrans->TransformDual(col);
+          }
+          for (int j = 0; j < vdofs.Size(); j++)
+          {
+            col_idx.push_back((vdofs[j] >= 0) ? vdofs[j] : -1 - vdofs[j]);
+            row_val.push_back((vdofs[j] >= 0) ? col(j) : -col(j));
+          }
+          row_ptr.push_back(static_cast<int>(col_idx.size()));
+        }
+
+        // Quadratic form for the interface type.
+        double a_n = 0.0, a_t = 0.0;
+        switch (type)
+        {
+          case DielectricInterfaceType::MA:
+            // Metal-air interface: 0.5 * t / ϵ_MA * |E_n|² .
+            a_n = 0.5 * ts / epsilon;
+            break;
+          case DielectricInterfaceType::MS:
+            {
+              // Metal-substrate interface: 0.5 * t * (ϵ_S)² / ϵ_MS * |E_n|² .
+              const double epsilon_S = mat_op.GetPermittivityReal(T->Attribute)
+                                           .InnerProduct(nor, nor);
+              a_n = 0.5 * ts * std::pow(epsilon_S, 2) / epsilon;
+            }
+            break;
+          case DielectricInterfaceType::SA:
+            // Substrate-air interface: 0.5 * t * (ϵ_SA * |E_t|² + 1 / ϵ_MS * |E_n|²) .
+            a_t = 0.5 * ts * epsilon;
+            a_n = 0.5 * ts / epsilon;
+            break;
+          case DielectricInterfaceType::DEFAULT:
+          default:
+            // No specific interface, use full field evaluation: 0.5 * t * ϵ * |E|² .
+            a_t = a_n = 0.5 * ts * epsilon;
+            break;
+        }
+        for (int j = 0; j < sdim; j++)
+        {
+          for (int k = 0; k < sdim; k++)
+          {
+            A.push_back(w * ((a_n - a_t) * nor[j] * nor[k] + ((j == k) ? a_t : 0.0)));
+          }
+        }
+      });
 }
 
 SurfacePostOperator::SurfaceChargeData::SurfaceChargeData(
@@ -132,11 +274,39 @@ SurfacePostOperator::SurfaceChargeData::SurfaceChargeData(
   mesh::AttrToMarker(mesh.bdr_attributes.Max(), data.attributes, attr_markers.back());
 }
 
-std::unique_ptr<mfem::Coefficient> SurfacePostOperator::SurfaceChargeData::GetCoefficient(
-    int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-    const std::map<int, int> &local_to_shared) const
+void SurfacePostOperator::SurfaceChargeData::Assemble(
+    const mfem::ParFiniteElementSpace &fespace,
+    const mfem::ParFiniteElementSpace &h1_fespace, const MaterialOperator &mat_op,
+    const BdrFaceGeometry &bdr_geom) const
 {
-  return std::make_unique<BdrChargeCoefficient>(U, mat_op, local_to_shared);
+  // The surface charge is Q = ∫ D ⋅ n dS, where for interior faces D ⋅ n = ε (E1 - E2) ⋅ n
+  // and the normal points into el1 (see BdrChargeCoefficient).
+  const int sdim = fespace.GetParMesh()->SpaceDimension();
+  w.SetSize(fespace.GetVSize() + fespace.GetFaceNbrVSize());
+  w = 0.0;
+  double c[3];
+  ForEachSurfaceQuadraturePoint(
+      h1_fespace, attr_markers, bdr_geom,
+      [&](int, double a, const double *nor, const double *C1,
+          mfem::ElementTransformation &T1, mfem::ElementTransformation *T2)
+      {
+        double dot = 0.0;
+        for (int d = 0; d < sdim; d++)
+        {
+          dot += C1[d] * nor[d];
+        }
+        if (dot < 0.0)
+        {
+          a = -a;
+        }
+        mat_op.GetPermittivityReal(T1.Attribute).MultTranspose(nor, c);
+        AddPointFunctional(fespace, T1, c, a, w);
+        if (T2)
+        {
+          mat_op.GetPermittivityReal(T2->Attribute).MultTranspose(nor, c);
+          AddPointFunctional(fespace, *T2, c, -a, w);
+        }
+      });
 }
 
 SurfacePostOperator::SurfaceFluxData::SurfaceFluxData(const config::InductanceData &data,
@@ -178,22 +348,48 @@ SurfacePostOperator::SurfaceFluxData::SurfaceFluxData(const config::InductanceDa
   mesh::AttrToMarker(mesh.bdr_attributes.Max(), data.attributes, attr_markers.back());
 }
 
-std::unique_ptr<mfem::Coefficient> SurfacePostOperator::SurfaceFluxData::GetCoefficient(
-    int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-    const std::map<int, int> &local_to_shared) const
+void SurfacePostOperator::SurfaceFluxData::Assemble(
+    const mfem::ParFiniteElementSpace &fespace,
+    const mfem::ParFiniteElementSpace &h1_fespace, const MaterialOperator &mat_op,
+    const BdrFaceGeometry &bdr_geom) const
 {
-  return std::make_unique<BdrFluxCoefficient>(U, direction, local_to_shared);
+  // The surface flux is Φ = ∫ B ⋅ n dS, where for interior faces B is averaged over the
+  // neighboring elements and the normal is oriented with the global direction (see
+  // BdrFluxCoefficient).
+  const int sdim = fespace.GetParMesh()->SpaceDimension();
+  w.SetSize(fespace.GetVSize() + fespace.GetFaceNbrVSize());
+  w = 0.0;
+  ForEachSurfaceQuadraturePoint(
+      h1_fespace, attr_markers, bdr_geom,
+      [&](int, double a, const double *nor, const double *,
+          mfem::ElementTransformation &T1, mfem::ElementTransformation *T2)
+      {
+        double dot = 0.0;
+        for (int d = 0; d < sdim; d++)
+        {
+          dot += direction(d) * nor[d];
+        }
+        if (dot < 0.0)
+        {
+          a = -a;
+        }
+        if (T2)
+        {
+          AddPointFunctional(fespace, T1, nor, 0.5 * a, w);
+          AddPointFunctional(fespace, *T2, nor, 0.5 * a, w);
+        }
+        else
+        {
+          AddPointFunctional(fespace, T1, nor, a, w);
+        }
+      });
 }
 
 SurfacePostOperator::SurfacePostOperator(const IoData &iodata, const MaterialOperator &mat,
-                                         const std::map<int, int> &l2s,
+                                         const BdrFaceGeometry &geom,
                                          mfem::ParFiniteElementSpace &h1_fespace)
-  : mat_op(mat), local_to_shared(l2s), ones(&h1_fespace)
+  : mat_op(mat), bdr_geom(geom), h1_fespace(h1_fespace)
 {
-  // Define a constant 1 function on the scalar finite element space for computing surface
-  // integrals.
-  ones.mfem::Vector::operator=(1.0);
-
   // Surface dielectric loss postprocessing.
   for (const auto &[idx, data] : iodata.boundaries.postpro.dielectric)
   {
@@ -213,56 +409,103 @@ SurfacePostOperator::SurfacePostOperator(const IoData &iodata, const MaterialOpe
   }
 }
 
-double
-SurfacePostOperator::GetInterfaceElectricFieldEnergy(int idx,
-                                                     const mfem::ParGridFunction &E) const
+void SurfacePostOperator::AssembleSurfaceData(const SurfaceData &data,
+                                              const mfem::ParGridFunction &U) const
 {
-  auto it = eps_surfs.find(idx);
-  MFEM_VERIFY(it != eps_surfs.end(),
-              "Unknown dielectric loss postprocessing surface index requested!");
-  return GetSurfaceIntegral(it->second, E);
+  // The surface data is assembled once for the finite element space of the field, which
+  // should be ready for parallel comm on shared faces.
+  if (data.fespace != U.ParFESpace())
+  {
+    data.Assemble(*U.ParFESpace(), h1_fespace, mat_op, bdr_geom);
+    data.fespace = U.ParFESpace();
+  }
 }
 
-double SurfacePostOperator::GetInterfaceLossTangent(int idx) const
+std::vector<double> SurfacePostOperator::GetInterfaceElectricFieldEnergies(
+    const std::vector<const mfem::ParGridFunction *> &E) const
 {
-  auto it = eps_surfs.find(idx);
-  MFEM_VERIFY(it != eps_surfs.end(),
-              "Unknown dielectric loss postprocessing surface index requested!");
-  return it->second.tandelta;
+  // Evaluate the single-sided field at each quadrature point and sum the quadratic forms.
+  std::vector<double> vals;
+  vals.reserve(eps_surfs.size() * E.size());
+  mfem::Vector V;
+  for (const auto &[idx, data] : eps_surfs)
+  {
+    for (const auto *U : E)
+    {
+      AssembleSurfaceData(data, *U);
+      const int sdim = U->ParFESpace()->GetParMesh()->SpaceDimension();
+      const mfem::Vector &U_nbr = U->FaceNbrData();
+      const int npts = (static_cast<int>(data.row_ptr.size()) - 1) / sdim;
+      double energy = 0.0;
+      V.SetSize(sdim);
+      for (int q = 0; q < npts; q++)
+      {
+        for (int d = 0; d < sdim; d++)
+        {
+          const int r = q * sdim + d;
+          V(d) = 0.0;
+          for (int k = data.row_ptr[r]; k < data.row_ptr[r + 1]; k++)
+          {
+            const int j = data.col_idx[k];
+            V(d) += data.row_val[k] * ((j < U->Size()) ? (*U)(j) : U_nbr(j - U->Size()));
+          }
+        }
+        const double *Aq = data.A.data() + q * sdim * sdim;
+        for (int j = 0; j < sdim; j++)
+        {
+          for (int k = 0; k < sdim; k++)
+          {
+            energy += V(j) * Aq[j * sdim + k] * V(k);
+          }
+        }
+      }
+      vals.push_back(energy);
+    }
+  }
+  Mpi::GlobalSum(static_cast<int>(vals.size()), vals.data(), h1_fespace.GetComm());
+  return vals;
 }
 
-double SurfacePostOperator::GetSurfaceElectricCharge(int idx,
-                                                     const mfem::ParGridFunction &E) const
+std::vector<double> SurfacePostOperator::GetSurfaceElectricCharges(
+    const std::vector<const mfem::ParGridFunction *> &E) const
 {
-  auto it = charge_surfs.find(idx);
-  MFEM_VERIFY(it != charge_surfs.end(),
-              "Unknown capacitance postprocessing surface index requested!");
-  return GetSurfaceIntegral(it->second, E);
+  std::vector<double> vals;
+  vals.reserve(charge_surfs.size() * E.size());
+  for (const auto &[idx, data] : charge_surfs)
+  {
+    for (const auto *U : E)
+    {
+      AssembleSurfaceData(data, *U);
+      vals.push_back(LocalDot(data.w, *U));
+    }
+  }
+  Mpi::GlobalSum(static_cast<int>(vals.size()), vals.data(), h1_fespace.GetComm());
+  return vals;
 }
 
-double SurfacePostOperator::GetSurfaceMagneticFlux(int idx,
-                                                   const mfem::ParGridFunction &B) const
+std::vector<double> SurfacePostOperator::GetSurfaceMagneticFluxes(
+    const std::vector<const mfem::ParGridFunction *> &B) const
 {
-  auto it = flux_surfs.find(idx);
-  MFEM_VERIFY(it != flux_surfs.end(),
-              "Unknown inductance postprocessing surface index requested!");
-  return GetSurfaceIntegral(it->second, B);
+  std::vector<double> vals;
+  vals.reserve(flux_surfs.size() * B.size());
+  for (const auto &[idx, data] : flux_surfs)
+  {
+    for (const auto *U : B)
+    {
+      AssembleSurfaceData(data, *U);
+      vals.push_back(LocalDot(data.w, *U));
+    }
+  }
+  Mpi::GlobalSum(static_cast<int>(vals.size()), vals.data(), h1_fespace.GetComm());
+  return vals;
 }
 
-double SurfacePostOperator::GetSurfaceIntegral(const SurfaceData &data,
-                                               const mfem::ParGridFunction &U) const
+double SurfacePostOperator::GetInterfaceLossTangent(int idx) const
 {
-  // Integrate the coefficient over the boundary attributes making up this surface index.
-  std::vector<std::unique_ptr<mfem::Coefficient>> fb;
-  mfem::ParLinearForm s(ones.ParFESpace());
-  for (int i = 0; i < static_cast<int>(data.attr_markers.size()); i++)
-  {
-    fb.emplace_back(data.GetCoefficient(i, U, mat_op, local_to_shared));
-    s.AddBoundaryIntegrator(new BoundaryLFIntegrator(*fb.back()), data.attr_markers[i]);
-  }
-  s.UseFastAssembly(true);
-  s.Assemble();
-  return s(ones);
+  auto it = eps_surfs.find(idx);
+  MFEM_VERIFY(it != eps_surfs.end(),
+              "Unknown dielectric loss postprocessing surface index requested!");
+  return it->second.tandelta;
 }
 
 }  // namespace palace
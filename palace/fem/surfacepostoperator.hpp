@@ -5,7 +5,6 @@
 #define PALACE_SURF_POST_OPERATOR_HPP
 
 #include <map>
-#include <memory>
 #include <vector>
 #include <mfem.hpp>
 #include "utils/mfemcoefficients.hpp"
@@ -32,16 +31,24 @@ class SurfacePostOperator
 {
 private:
   // Mapping from surface index to data structure containing surface postprocessing
-  // information for surface loss, charge, or magnetic flux.
+  // information for surface loss, charge, or magnetic flux. The surface integrals are
+  // precomputed on first use for the finite element space of the given field: Charge and
+  // flux are linear in the solution and are assembled into functionals on the local and
+  // face-neighbor DOFs, while the quadratic interface energy caches the field evaluation
+  // and quadrature weights at each surface quadrature point.
   struct SurfaceData
   {
     mutable std::vector<mfem::Array<int>> attr_markers;
 
+    // Finite element space for which the cached data was assembled.
+    mutable const mfem::ParFiniteElementSpace *fespace = nullptr;
+
     virtual ~SurfaceData() = default;
 
-    virtual std::unique_ptr<mfem::Coefficient>
-    GetCoefficient(int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-                   const std::map<int, int> &local_to_shared) const = 0;
+    virtual void Assemble(const mfem::ParFiniteElementSpace &fespace,
+                          const mfem::ParFiniteElementSpace &h1_fespace,
+                          const MaterialOperator &mat_op,
+                          const BdrFaceGeometry &bdr_geom) const = 0;
   };
   struct InterfaceDielectricData : public SurfaceData
   {
@@ -49,30 +56,45 @@ private:
     double epsilon, ts, tandelta;
     std::vector<mfem::Vector> sides;
 
+    // Sparse rows evaluating the field at each quadrature point from the local and
+    // face-neighbor DOFs, and the symmetric matrices of the quadratic form for the energy
+    // at each point (scaled by the quadrature weight).
+    mutable std::vector<int> row_ptr, col_idx;
+    mutable std::vector<double> row_val, A;
+
     InterfaceDielectricData(const config::InterfaceDielectricData &data,
                             mfem::ParMesh &mesh);
 
-    std::unique_ptr<mfem::Coefficient>
-    GetCoefficient(int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-                   const std::map<int, int> &local_to_shared) const override;
+    void Assemble(const mfem::ParFiniteElementSpace &fespace,
+                  const mfem::ParFiniteElementSpace &h1_fespace,
+                  const MaterialOperator &mat_op,
+                  const BdrFaceGeometry &bdr_geom) const override;
   };
   struct SurfaceChargeData : public SurfaceData
   {
+    // Linear functional on the local and face-neighbor DOFs.
+    mutable mfem::Vector w;
+
     SurfaceChargeData(const config::CapacitanceData &data, mfem::ParMesh &mesh);
 
-    std::unique_ptr<mfem::Coefficient>
-    GetCoefficient(int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-                   const std::map<int, int> &local_to_shared) const override;
+    void Assemble(const mfem::ParFiniteElementSpace &fespace,
+                  const mfem::ParFiniteElementSpace &h1_fespace,
+                  const MaterialOperator &mat_op,
+                  const BdrFaceGeometry &bdr_geom) const override;
   };
   struct SurfaceFluxData : public SurfaceData
   {
     mfem::Vector direction;
 
+    // Linear functional on the local and face-neighbor DOFs.
+    mutable mfem::Vector w;
+
     SurfaceFluxData(const config::InductanceData &data, mfem::ParMesh &mesh);
 
-    std::unique_ptr<mfem::Coefficient>
-    GetCoefficient(int i, const mfem::ParGridFunction &U, const MaterialOperator &mat_op,
-                   const std::map<int, int> &local_to_shared) const override;
+    void Assemble(const mfem::ParFiniteElementSpace &fespace,
+                  const mfem::ParFiniteElementSpace &h1_fespace,
+                  const MaterialOperator &mat_op,
+                  const BdrFaceGeometry &bdr_geom) const override;
   };
   std::map<int, InterfaceDielectricData> eps_surfs;
   std::map<int, SurfaceChargeData> charge_surfs;
@@ -81,18 +103,17 @@ private:
   // Reference to material property operator (not owned).
   const MaterialOperator &mat_op;
 
-  // Shared face mapping for boundary coefficients (not owned).
-  const std::map<int, int> &local_to_shared;
+  // Face data of the boundary elements for boundary coefficients (not owned).
+  const BdrFaceGeometry &bdr_geom;
 
-  // Unit function used for computing surface integrals.
-  mfem::ParGridFunction ones;
+  // Scalar finite element space used for the surface quadrature rules (not owned).
+  const mfem::ParFiniteElementSpace &h1_fespace;
 
-  double GetSurfaceIntegral(const SurfaceData &data, const mfem::ParGridFunction &U) const;
+  void AssembleSurfaceData(const SurfaceData &data, const mfem::ParGridFunction &U) const;
 
 public:
   SurfacePostOperator(const IoData &iodata, const MaterialOperator &mat,
-                      const std::map<int, int> &l2s,
-                      mfem::ParFiniteElementSpace &h1_fespace);
+                      const BdrFaceGeometry &geom, mfem::ParFiniteElementSpace &h1_fespace);
 
   // Access data structures for the postprocessing surface with the given type.
   const auto &GetEps() const { return eps_surfs; }
@@ -103,11 +124,16 @@ public:
   auto SizeInd() const { return flux_surfs.size(); }
 
   // Get surface integrals computing dielectric interface energy, surface charge, or
-  // surface magnetic flux.
-  double GetInterfaceElectricFieldEnergy(int idx, const mfem::ParGridFunction &E) const;
+  // surface magnetic flux for all surfaces of the given type at once, with a single global
+  // reduction. Values are ordered by surface index and then by field, that is [s1u1, s1u2,
+  // ..., s2u1, s2u2, ...].
+  std::vector<double> GetInterfaceElectricFieldEnergies(
+      const std::vector<const mfem::ParGridFunction *> &E) const;
+  std::vector<double>
+  GetSurfaceElectricCharges(const std::vector<const mfem::ParGridFunction *> &E) const;
+  std::vector<double>
+  GetSurfaceMagneticFluxes(const std::vector<const mfem::ParGridFunction *> &B) const;
   double GetInterfaceLossTangent(int idx) const;
-  double GetSurfaceElectricCharge(int idx, const mfem::ParGridFunction &E) const;
-  double GetSurfaceMagneticFlux(int idx, const mfem::ParGridFunction &B) const;
 };
 
 }  // namespace palace
@@ -750,15 +750,15 @@ std::complex<double> WavePortData::GetSParameter(mfem::ParComplexGridFunction &E
 std::complex<double> WavePortData::GetPower(mfem::ParComplexGridFunction &E,
                                             mfem::ParComplexGridFunction &B,
                                             const MaterialOperator &mat_op,
-                                            const std::map<int, int> &local_to_shared) const
+                                            const BdrFaceGeometry &bdr_geom) const
 {
   // Compute port power, (E x H) ⋅ n = E ⋅ (-n x H), integrated over the port surface
   // using the computed E and H = μ⁻¹ B fields. The linear form is reconstructed from
   // scratch each time due to changing H. The BdrCurrentVectorCoefficient computes -n x H,
   // where n is an outward normal.
   auto &nd_fespace = *E.ParFESpace();
-  BdrCurrentVectorCoefficient nxHr_func(B.real(), mat_op, local_to_shared);
-  BdrCurrentVectorCoefficient nxHi_func(B.imag(), mat_op, local_to_shared);
+  BdrCurrentVectorCoefficient nxHr_func(B.real(), mat_op, bdr_geom);
+  BdrCurrentVectorCoefficient nxHi_func(B.imag(), mat_op, bdr_geom);
   mfem::ParLinearForm pr(&nd_fespace), pi(&nd_fespace);
   pr.AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(nxHr_func), attr_marker);
   pi.AddBoundaryIntegrator(new VectorFEBoundaryLFIntegrator(nxHi_func), attr_marker);
@@ -15,6 +15,7 @@
 namespace palace
 {
 
+class BdrFaceGeometry;
 class IoData;
 class MaterialOperator;
 class SumMatrixCoefficient;
@@ -122,7 +123,7 @@ public:
   std::complex<double> GetPower(mfem::ParComplexGridFunction &E,
                                 mfem::ParComplexGridFunction &B,
                                 const MaterialOperator &mat_op,
-                                const std::map<int, int> &local_to_shared) const;
+                                const BdrFaceGeometry &bdr_geom) const;
   std::complex<double> GetVoltage(mfem::ParComplexGridFunction &E) const
   {
     MFEM_ABORT("GetVoltage is not yet implemented for wave port boundaries!");
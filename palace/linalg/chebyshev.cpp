@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <general/forall.hpp>
+#include "linalg/complex.hpp"
 #include "linalg/pc.hpp"
 #include "linalg/petsc.hpp"
 
@@ -54,6 +55,69 @@ public:
   }
 };
 
+#if defined(PETSC_USE_COMPLEX)
+// Computes y = d1 ∘ (A1 x) + d2 ∘ (A2 x) for use in constructing the real and imaginary
+// parts of the diagonally scaled complex operator.
+class ScaledSumOperator : public mfem::Operator
+{
+private:
+  const mfem::Operator &A1, *A2;
+  const mfem::Vector d1, d2;
+  mutable mfem::Vector z;
+
+public:
+  ScaledSumOperator(const mfem::Operator &op1, const mfem::Vector &v1,
+                    const mfem::Operator *op2, const mfem::Vector &v2)
+    : mfem::Operator(op1.Height()), A1(op1), A2(op2), d1(v1), d2(v2), z(v1.Size())
+  {
+  }
+
+  void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+  {
+    A1.Mult(x, z);
+    {
+      const int N = height;
+      const auto *D = d1.Read();
+      const auto *Z = z.Read();
+      auto *Y = y.Write();
+      MFEM_FORALL(i, N, { Y[i] = D[i] * Z[i]; });
+    }
+    if (A2)
+    {
+      A2->Mult(x, z);
+      const int N = height;
+      const auto *D = d2.Read();
+      const auto *Z = z.Read();
+      auto *Y = y.ReadWrite();
+      MFEM_FORALL(i, N, { Y[i] += D[i] * Z[i]; });
+    }
+  }
+
+  void MultTranspose(const mfem::Vector &x, mfem::Vector &y) const override
+  {
+    {
+      const int N = height;
+      const auto *D = d1.Read();
+      const auto *X = x.Read();
+      auto *Z = z.Write();
+      MFEM_FORALL(i, N, { Z[i] = D[i] * X[i]; });
+    }
+    A1.MultTranspose(z, y);
+    if (A2)
+    {
+      {
+        const int N = height;
+        const auto *D = d2.Read();
+        const auto *X = x.Read();
+        auto *Z = z.Write();
+        MFEM_FORALL(i, N, { Z[i] = D[i] * X[i]; });
+      }
+      A2->AddMultTranspose(z, y);
+    }
+  }
+};
+#endif
+
 }  // namespace
 
 ChebyshevSmoother::ChebyshevSmoother(MPI_Comm c, const mfem::Array<int> &tdof_list,
@@ -70,25 +134,115 @@ void ChebyshevSmoother::SetOperator(const mfem::Operator &op)
 
   // Configure symmetric diagonal scaling.
   const int N = height;
+  const auto *A_c = dynamic_cast<const ComplexWrapperOperator *>(A);
   dinv.SetSize(N);
-  mfem::Vector diag(N);
-  A->AssembleDiagonal(diag);
-  const auto *D = diag.Read();
-  auto *DI = dinv.Write();
-  MFEM_FORALL(i, N, {
-    MFEM_ASSERT_KERNEL(D[i] != 0.0, "Zero diagonal entry in Chebyshev smoother!");
-    DI[i] = 1.0 / D[i];
-  });
-  const auto *I = dbc_tdof_list.Read();
-  MFEM_FORALL(i, dbc_tdof_list.Size(), {
-    DI[I[i]] = 1.0;  // Assumes operator DiagonalPolicy::ONE
-  });
+  if (A_c)
+  {
+    // Complex-valued scaling: Dinv = 1 / (dr + i di) .
+    dinv_i.SetSize(N);
+    mfem::Vector diag(N), diag_i(N);
+    A_c->AssembleDiagonal(diag, diag_i);
+    const auto *D = diag.Read();
+    const auto *DD = diag_i.Read();
+    auto *DI = dinv.Write();
+    auto *DII = dinv_i.Write();
+    MFEM_FORALL(i, N, {
+      const double s = D[i] * D[i] + DD[i] * DD[i];
+      MFEM_ASSERT_KERNEL(s != 0.0, "Zero diagonal entry in Chebyshev smoother!");
+      DI[i] = D[i] / s;
+      DII[i] = -DD[i] / s;
+    });
+    const auto *I = dbc_tdof_list.Read();
+    MFEM_FORALL(i, dbc_tdof_list.Size(), {
+      DI[I[i]] = 1.0;  // Assumes operator DiagonalPolicy::ONE
+      DII[I[i]] = 0.0;
+    });
+  }
+  else
+  {
+    dinv_i.SetSize(0);
+    mfem::Vector diag(N);
+    A->AssembleDiagonal(diag);
+    const auto *D = diag.Read();
+    auto *DI = dinv.Write();
+    MFEM_FORALL(i, N, {
+      MFEM_ASSERT_KERNEL(D[i] != 0.0, "Zero diagonal entry in Chebyshev smoother!");
+      DI[i] = 1.0 / D[i];
+    });
+    const auto *I = dbc_tdof_list.Read();
+    MFEM_FORALL(i, dbc_tdof_list.Size(), {
+      DI[I[i]] = 1.0;  // Assumes operator DiagonalPolicy::ONE
+    });
+  }
 
   // Set up Chebyshev coefficients using the computed maximum eigenvalue estimate. See
   // mfem::OperatorChebyshevSmoother or Adams et al., Parallel multigrid smoothing:
-  // polynomial versus Gauss-Seidel, JCP (2003).
-  petsc::PetscShellMatrix DinvA(comm, std::make_unique<SymmetricScaledOperator>(*A, dinv));
-  lambda_max = 1.1 * DinvA.Norm2();
+  // polynomial versus Gauss-Seidel, JCP (2003). For complex-valued operators, the estimate
+  // uses the norm of the complex scaled operator Dinv A.
+  if (A_c)
+  {
+#if defined(PETSC_USE_COMPLEX)
+    mfem::Vector neg_dinv_i(N);
+    neg_dinv_i.Set(-1.0, dinv_i);
+    petsc::PetscShellMatrix DinvA(
+        comm,
+        std::make_unique<ScaledSumOperator>(A_c->Real(), dinv, A_c->Imag(), neg_dinv_i),
+        std::make_unique<ScaledSumOperator>(A_c->Real(), dinv_i, A_c->Imag(), dinv));
+    lambda_max = 1.1 * DinvA.Norm2();
+#else
+    MFEM_ABORT("Complex-valued Chebyshev smoothing requires PETSc built with complex "
+               "scalar support!");
+#endif
+  }
+  else
+  {
+    petsc::PetscShellMatrix DinvA(comm,
+                                  std::make_unique<SymmetricScaledOperator>(*A, dinv));
+    lambda_max = 1.1 * DinvA.Norm2();
+  }
+}
+
+void ChebyshevSmoother::ScaleResidual(const mfem::Array<mfem::Vector *> &R,
+                                      mfem::Array<mfem::Vector *> &D, double sd, double sr,
+                                      bool init) const
+{
+  const int N = height;
+  const auto *DI = dinv.Read();
+  if (dinv_i.Size() == 0)
+  {
+    for (int j = 0; j < R.Size(); j++)
+    {
+      const auto *RR = R[j]->Read();
+      if (init)
+      {
+        auto *DD = D[j]->Write();
+        MFEM_FORALL(i, N, { DD[i] = sr * DI[i] * RR[i]; });
+      }
+      else
+      {
+        auto *DD = D[j]->ReadWrite();
+        MFEM_FORALL(i, N, { DD[i] = sd * DD[i] + sr * DI[i] * RR[i]; });
+      }
+    }
+    return;
+  }
+  MFEM_VERIFY(R.Size() % 2 == 0,
+              "Complex-valued Chebyshev smoother requires (real, imaginary) pairs of "
+              "vectors!");
+  const auto *DII = dinv_i.Read();
+  for (int j = 0; j < R.Size(); j += 2)
+  {
+    const auto *RR = R[j]->Read();
+    const auto *RI = R[j + 1]->Read();
+    auto *DR = init ? D[j]->Write() : D[j]->ReadWrite();
+    auto *DJ = init ? D[j + 1]->Write() : D[j + 1]->ReadWrite();
+    MFEM_FORALL(i, N, {
+      const double dr = init ? 0.0 : sd * DR[i];
+      const double di = init ? 0.0 : sd * DJ[i];
+      DR[i] = dr + sr * (DI[i] * RR[i] - DII[i] * RI[i]);
+      DJ[i] = di + sr * (DI[i] * RI[i] + DII[i] * RR[i]);
+    });
+  }
 }
 
 void ChebyshevSmoother::ArrayMult(const mfem::Array<const mfem::Vector *> &X,
@@ -132,15 +286,7 @@ void ChebyshevSmoother::ArrayMult(const mfem::Array<const mfem::Vector *> &X,
     }
 
     // 4th-kind Chebyshev smoother
-    {
-      const auto *DI = dinv.Read();
-      for (int j = 0; j < nrhs; j++)
-      {
-        const auto *RR = R[j]->Read();
-        auto *DD = D[j]->ReadWrite();
-        MFEM_FORALL(i, height, { DD[i] = 4.0 / (3.0 * lambda_max) * DI[i] * RR[i]; });
-      }
-    }
+    ScaleResidual(R, D, 0.0, 4.0 / (3.0 * lambda_max), true);
     for (int k = 1; k < order; k++)
     {
       for (int j = 0; j < nrhs; j++)
@@ -148,22 +294,13 @@ void ChebyshevSmoother::ArrayMult(const mfem::Array<const mfem::Vector *> &X,
         *Y[j] += *D[j];
       }
       A->ArrayAddMult(D, R, -1.0);
-      {
-        const auto *DI = dinv.Read();
-        for (int j = 0; j < nrhs; j++)
-        {
-          const auto *RR = R[j]->Read();
-          auto *DD = D[j]->ReadWrite();
-          MFEM_FORALL(i, height, {
-            // From Lottes
-            // DD[i] = (2.0 * k - 3.0) / (2.0 * k + 1.0) * DD[i] +
-            //         (8.0 * k - 4.0) / ((2.0 * k + 1.0) * lambda_max) * DI[i] * RR[i];
-            // From Phillips and Fischer
-            DD[i] = (2.0 * k - 1.0) / (2.0 * k + 3.0) * DD[i] +
-                    (8.0 * k + 4.0) / ((2.0 * k + 3.0) * lambda_max) * DI[i] * RR[i];
-          });
-        }
-      }
+
+      // From Lottes
+      //   D = (2k - 3) / (2k + 1) D + (8k - 4) / ((2k + 1) λ_max) Dinv R
+      // From Phillips and Fischer
+      //   D = (2k - 1) / (2k + 3) D + (8k + 4) / ((2k + 3) λ_max) Dinv R
+      ScaleResidual(R, D, (2.0 * k - 1.0) / (2.0 * k + 3.0),
+                    (8.0 * k + 4.0) / ((2.0 * k + 3.0) * lambda_max), false);
     }
     for (int j = 0; j < nrhs; j++)
     {
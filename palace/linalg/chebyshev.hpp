@@ -14,7 +14,9 @@ namespace palace
 // mfem::OperatorChebyshevSmoother allows a nonzero initial guess and uses alternative
 // methods to estimate the largest eigenvalue. See also Phillips and Fischer, Optimal
 // Chebyshev smoothers and one-sided V-cycles, arXiv:2210.03179v1 (2022) for reference on
-// the 4th-kind Chebyshev polynomial smoother.
+// the 4th-kind Chebyshev polynomial smoother. For a complex-valued ComplexWrapperOperator,
+// the smoother acts on (real, imaginary) pairs of vectors and uses complex diagonal
+// scaling.
 //
 class ChebyshevSmoother : public mfem::Solver
 {
@@ -27,8 +29,9 @@ private:
   // Number of smoother iterations and polynomial order.
   const int pc_it, order;
 
-  // Diagonal scaling of the operator.
-  mfem::Vector dinv;
+  // Diagonal scaling of the operator (real and imaginary parts, the latter is empty for a
+  // real-valued operator).
+  mfem::Vector dinv, dinv_i;
 
   // Maximum operator eigenvalue for Chebyshev polynomial smoothing.
   double lambda_max;
@@ -36,6 +39,11 @@ private:
   // Temporary vectors for smoother application.
   mutable mfem::Vector r, d;
 
+  // Computes D = sd D + sr Dinv R, or D = sr Dinv R if init is true, for each vector (or
+  // (real, imaginary) pair of vectors for complex-valued operators).
+  void ScaleResidual(const mfem::Array<mfem::Vector *> &R, mfem::Array<mfem::Vector *> &D,
+                     double sd, double sr, bool init) const;
+
 public:
   ChebyshevSmoother(MPI_Comm c, const mfem::Array<int> &tdof_list, int smooth_it,
                     int poly_order);
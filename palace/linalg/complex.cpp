@@ -0,0 +1,139 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "complex.hpp"
+
+#include "linalg/hypre.hpp"
+
+namespace palace
+{
+
+ComplexWrapperOperator::ComplexWrapperOperator(std::unique_ptr<mfem::Operator> &&opr,
+                                               std::unique_ptr<mfem::Operator> &&opi)
+  : mfem::Operator(opr->Height(), opr->Width()), Ar(std::move(opr)), Ai(std::move(opi))
+{
+  MFEM_VERIFY(height == width, "ComplexWrapperOperator requires a square operator!");
+  MFEM_VERIFY(!Ai || (Ai->Height() == height && Ai->Width() == width),
+              "Mismatch in dimension of real and imaginary parts of ComplexWrapperOperator!");
+}
+
+void ComplexWrapperOperator::AssembleDiagonal(mfem::Vector &dr, mfem::Vector &di) const
+{
+  dr.SetSize(height);
+  di.SetSize(height);
+  Ar->AssembleDiagonal(dr);
+  if (Ai)
+  {
+    Ai->AssembleDiagonal(di);
+  }
+  else
+  {
+    di = 0.0;
+  }
+}
+
+void ComplexWrapperOperator::ArrayMultInternal(const mfem::Array<const mfem::Vector *> &X,
+                                               mfem::Array<mfem::Vector *> &Y, double a,
+                                               bool add, bool transpose) const
+{
+  // Computes y = a A x or y += a A x for each (real, imaginary) pair, with the
+  // (non-Hermitian) transpose Aᵀ = Arᵀ + i Aiᵀ if requested.
+  MFEM_VERIFY(X.Size() == Y.Size() && X.Size() % 2 == 0,
+              "ComplexWrapperOperator requires (real, imaginary) pairs of vectors!");
+  auto Apply = [transpose](const mfem::Operator &op, const mfem::Vector &x, mfem::Vector &y)
+  {
+    if (transpose)
+    {
+      op.MultTranspose(x, y);
+    }
+    else
+    {
+      op.Mult(x, y);
+    }
+  };
+  z.SetSize(height);
+  for (int j = 0; j < X.Size(); j += 2)
+  {
+    const mfem::Vector &xr = *X[j], &xi = *X[j + 1];
+    mfem::Vector &yr = *Y[j], &yi = *Y[j + 1];
+
+    // yr = a (Ar xr - Ai xi)
+    Apply(*Ar, xr, z);
+    if (add)
+    {
+      yr.Add(a, z);
+    }
+    else
+    {
+      yr.Set(a, z);
+    }
+    if (Ai)
+    {
+      Apply(*Ai, xi, z);
+      yr.Add(-a, z);
+    }
+
+    // yi = a (Ai xr + Ar xi)
+    Apply(*Ar, xi, z);
+    if (add)
+    {
+      yi.Add(a, z);
+    }
+    else
+    {
+      yi.Set(a, z);
+    }
+    if (Ai)
+    {
+      Apply(*Ai, xr, z);
+      yi.Add(a, z);
+    }
+  }
+}
+
+void ComplexBlockSolver::SetOperator(const mfem::Operator &op)
+{
+  const auto *A = dynamic_cast<const ComplexWrapperOperator *>(&op);
+  MFEM_VERIFY(A, "ComplexBlockSolver requires a ComplexWrapperOperator!");
+  const auto *Ar = dynamic_cast<const mfem::HypreParMatrix *>(&A->Real());
+  const auto *Ai = dynamic_cast<const mfem::HypreParMatrix *>(A->Imag());
+  MFEM_VERIFY(Ar && (!A->HasImag() || Ai),
+              "ComplexBlockSolver requires mfem::HypreParMatrix real and imaginary parts!");
+  height = A->Height();
+  width = A->Width();
+
+  // Construct the real equivalent symmetric block system (missing blocks are zero).
+  mfem::Array2D<const mfem::HypreParMatrix *> blocks(2, 2);
+  mfem::Array2D<double> block_coeffs(2, 2);
+  blocks(0, 0) = Ar;
+  blocks(0, 1) = Ai;
+  blocks(1, 0) = Ai;
+  blocks(1, 1) = Ar;
+  block_coeffs(0, 0) = 1.0;
+  block_coeffs(0, 1) = -1.0;
+  block_coeffs(1, 0) = -1.0;
+  block_coeffs(1, 1) = -1.0;
+  K.reset(mfem::HypreParMatrixFromBlocks(blocks, &block_coeffs));
+  solver->SetOperator(*K);
+}
+
+void ComplexBlockSolver::ArrayMult(const mfem::Array<const mfem::Vector *> &X,
+                                   mfem::Array<mfem::Vector *> &Y) const
+{
+  MFEM_VERIFY(X.Size() == Y.Size() && X.Size() % 2 == 0,
+              "ComplexBlockSolver requires (real, imaginary) pairs of vectors!");
+  x_.SetSize(2 * height);
+  y_.SetSize(2 * height);
+  mfem::Vector xr(x_, 0, height), xi(x_, height, height);
+  mfem::Vector yr(y_, 0, height), yi(y_, height, height);
+  for (int j = 0; j < X.Size(); j += 2)
+  {
+    xr = *X[j];
+    xi.Set(-1.0, *X[j + 1]);
+    solver->Mult(x_, y_);
+    *Y[j] = yr;
+    *Y[j + 1] = yi;
+  }
+}
+
+}  // namespace palace
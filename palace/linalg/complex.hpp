@@ -0,0 +1,118 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PALACE_COMPLEX_OPERATOR_HPP
+#define PALACE_COMPLEX_OPERATOR_HPP
+
+#include <memory>
+#include <mfem.hpp>
+
+namespace palace
+{
+
+//
+// A complex-valued operator A = Ar + i Ai represented by its real and imaginary parts. The
+// operator acts on complex vectors stored as consecutive (real, imaginary) pairs of real
+// vectors through the ArrayMult interface, so it can be used with the multiple RHS
+// capabilities of the geometric multigrid solver and smoothers. The operator dimensions
+// are those of the real and imaginary parts. The imaginary part may be empty.
+//
+class ComplexWrapperOperator : public mfem::Operator
+{
+private:
+  std::unique_ptr<mfem::Operator> Ar, Ai;
+
+  // Temporary vector for operator application.
+  mutable mfem::Vector z;
+
+  void ArrayMultInternal(const mfem::Array<const mfem::Vector *> &X,
+                         mfem::Array<mfem::Vector *> &Y, double a, bool add,
+                         bool transpose) const;
+
+public:
+  ComplexWrapperOperator(std::unique_ptr<mfem::Operator> &&opr,
+                         std::unique_ptr<mfem::Operator> &&opi);
+
+  const mfem::Operator &Real() const { return *Ar; }
+  const mfem::Operator *Imag() const { return Ai.get(); }
+  bool HasImag() const { return (Ai != nullptr); }
+
+  // Assemble the real and imaginary parts of the operator diagonal.
+  void AssembleDiagonal(mfem::Vector &dr, mfem::Vector &di) const;
+
+  void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+  {
+    MFEM_ABORT("ComplexWrapperOperator only supports application to (real, imaginary) "
+               "pairs of vectors with ArrayMult!");
+  }
+
+  void ArrayMult(const mfem::Array<const mfem::Vector *> &X,
+                 mfem::Array<mfem::Vector *> &Y) const override
+  {
+    ArrayMultInternal(X, Y, 1.0, false, false);
+  }
+
+  void ArrayMultTranspose(const mfem::Array<const mfem::Vector *> &X,
+                          mfem::Array<mfem::Vector *> &Y) const override
+  {
+    ArrayMultInternal(X, Y, 1.0, false, true);
+  }
+
+  void ArrayAddMult(const mfem::Array<const mfem::Vector *> &X,
+                    mfem::Array<mfem::Vector *> &Y, const double a = 1.0) const override
+  {
+    ArrayMultInternal(X, Y, a, true, false);
+  }
+
+  void ArrayAddMultTranspose(const mfem::Array<const mfem::Vector *> &X,
+                             mfem::Array<mfem::Vector *> &Y,
+                             const double a = 1.0) const override
+  {
+    ArrayMultInternal(X, Y, a, true, true);
+  }
+};
+
+//
+// Wrapper for a real-valued (direct) solver to solve complex-valued linear systems with a
+// ComplexWrapperOperator using the equivalent real symmetric block system:
+//                 [  Ar -Ai ] [ xr ]   [  br ]
+//                 [ -Ai -Ar ] [ xi ] = [ -bi ] .
+// Both parts of the operator must be mfem::HypreParMatrix objects.
+//
+class ComplexBlockSolver : public mfem::Solver
+{
+private:
+  // The real-valued solver and the real equivalent block matrix.
+  std::unique_ptr<mfem::Solver> solver;
+  std::unique_ptr<mfem::HypreParMatrix> K;
+
+  // Temporary vectors for solver application.
+  mutable mfem::Vector x_, y_;
+
+public:
+  ComplexBlockSolver(std::unique_ptr<mfem::Solver> &&pc)
+    : mfem::Solver(), solver(std::move(pc))
+  {
+  }
+
+  void SetOperator(const mfem::Operator &op) override;
+
+  void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+  {
+    MFEM_ABORT("ComplexBlockSolver only supports application to (real, imaginary) pairs "
+               "of vectors with ArrayMult!");
+  }
+
+  void ArrayMult(const mfem::Array<const mfem::Vector *> &X,
+                 mfem::Array<mfem::Vector *> &Y) const override;
+
+  void ArrayMultTranspose(const mfem::Array<const mfem::Vector *> &X,
+                          mfem::Array<mfem::Vector *> &Y) const override
+  {
+    ArrayMult(X, Y);  // Complex symmetric operator
+  }
+};
+
+}  // namespace palace
+
+#endif  // PALACE_COMPLEX_OPERATOR_HPP
@@ -393,7 +393,6 @@ int FeastEigenSolver::SolveInternal(RG rg)
   {
     // Orthonormalize the (real-valued) basis Q.
     {
-      bool mgs = false, cgs2 = true;
       for (PetscInt j = 0; j < mQ / 2; j++)
       {
         petsc::PetscParVector q1 = Q.GetColumn(j);
@@ -410,16 +409,13 @@ int FeastEigenSolver::SolveInternal(RG rg)
         q2.SetFromVector(qi);
         Q.RestoreColumn(j + mQ / 2, q2);
       }
-      for (PetscInt j = 0; j < mQ; j++)
+      if (opB)
       {
-        if (opB)
-        {
-          Q.OrthonormalizeColumn(j, mgs, cgs2, *opB, *r0);
-        }
-        else
-        {
-          Q.OrthonormalizeColumn(j, mgs, cgs2);
-        }
+        Q.OrthonormalizeColumns(0, mQ, *opB);
+      }
+      else
+      {
+        Q.OrthonormalizeColumns(0, mQ);
       }
     }
 
@@ -3,7 +3,10 @@
 
 #include "hypre.hpp"
 
+#include <algorithm>
 #include <map>
+#include <numeric>
+#include <utility>
 
 namespace mfem
 {
@@ -874,4 +877,873 @@ void hypreParCSRInfNorm(hypre_ParCSRMatrix *Ar, hypre_ParCSRMatrix *Ai, HYPRE_Re
               "HYPRE error encountered: Error code = " << hypre_error_flag << "!");
 }
 
+bool PersistentParMatrix::HasSameStructure(const mfem::HypreParMatrix &B) const
+{
+  // All processes take part in the reduction, even if the local structure differs.
+  hypre_ParCSRMatrix *hB = B;
+  int same = 0;
+  if (A)
+  {
+    hypre_ParCSRMatrix *hA = *A;
+    auto SameCSR = [](hypre_CSRMatrix *C, hypre_CSRMatrix *D)
+    {
+      const HYPRE_Int nrows = hypre_CSRMatrixNumRows(C);
+      if (nrows != hypre_CSRMatrixNumRows(D) ||
+          hypre_CSRMatrixNumCols(C) != hypre_CSRMatrixNumCols(D) ||
+          hypre_CSRMatrixNumNonzeros(C) != hypre_CSRMatrixNumNonzeros(D))
+      {
+        return false;
+      }
+      const HYPRE_Int *CI = hypre_CSRMatrixI(C), *DI = hypre_CSRMatrixI(D);
+      const HYPRE_Int *CJ = hypre_CSRMatrixJ(C), *DJ = hypre_CSRMatrixJ(D);
+      return std::equal(CI, CI + nrows + 1, DI) && std::equal(CJ, CJ + CI[nrows], DJ);
+    };
+    same =
+        hypre_ParCSRMatrixFirstRowIndex(hA) == hypre_ParCSRMatrixFirstRowIndex(hB) &&
+        hypre_ParCSRMatrixFirstColDiag(hA) == hypre_ParCSRMatrixFirstColDiag(hB) &&
+        hypre_ParCSRMatrixGlobalNumRows(hA) == hypre_ParCSRMatrixGlobalNumRows(hB) &&
+        hypre_ParCSRMatrixGlobalNumCols(hA) == hypre_ParCSRMatrixGlobalNumCols(hB) &&
+        SameCSR(hypre_ParCSRMatrixDiag(hA), hypre_ParCSRMatrixDiag(hB)) &&
+        SameCSR(hypre_ParCSRMatrixOffd(hA), hypre_ParCSRMatrixOffd(hB));
+    if (same)
+    {
+      const HYPRE_Int ncols_offd = hypre_CSRMatrixNumCols(hypre_ParCSRMatrixOffd(hA));
+      const HYPRE_BigInt *col_map_offd_A = hypre_ParCSRMatrixColMapOffd(hA);
+      const HYPRE_BigInt *col_map_offd_B = hypre_ParCSRMatrixColMapOffd(hB);
+      same = std::equal(col_map_offd_A, col_map_offd_A + ncols_offd, col_map_offd_B);
+    }
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &same, 1, MPI_INT, MPI_MIN, B.GetComm());
+  return same;
+}
+
+void PersistentParMatrix::SetUpParallelAssembly(mfem::ParBilinearForm &a)
+{
+  // The parallel matrix is A = Pᵀ A_local P, where P is the prolongation from true dofs to
+  // local dofs. Each entry of the local matrix contributes to the entries of A at the
+  // global true dofs of the nonzeros in the corresponding rows of P. Contributions to rows
+  // owned by other processes are exchanged, and the positions of all contributions in the
+  // stored structure of A (from a full parallel assembly) are computed once here.
+  mfem::ParFiniteElementSpace &fespace = *a.ParFESpace();
+  const mfem::SparseMatrix &S = a.SpMat();
+  MPI_Comm comm = fespace.GetComm();
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  // Rows of P with global true dof column indices.
+  hypre_ParCSRMatrix *hP = *fespace.Dof_TrueDof_Matrix();
+  std::vector<std::size_t> P_ptr(1, 0);
+  std::vector<HYPRE_BigInt> P_col;
+  std::vector<HYPRE_Real> P_val;
+  {
+    hypre_CSRMatrix *P_diag = hypre_ParCSRMatrixDiag(hP);
+    hypre_CSRMatrix *P_offd = hypre_ParCSRMatrixOffd(hP);
+    const HYPRE_Int *P_diag_i = hypre_CSRMatrixI(P_diag);
+    const HYPRE_Int *P_diag_j = hypre_CSRMatrixJ(P_diag);
+    const HYPRE_Int *P_offd_i = hypre_CSRMatrixI(P_offd);
+    const HYPRE_Int *P_offd_j = hypre_CSRMatrixJ(P_offd);
+    const HYPRE_Real *P_diag_a = hypre_CSRMatrixData(P_diag);
+    const HYPRE_Real *P_offd_a = hypre_CSRMatrixData(P_offd);
+    const HYPRE_BigInt first_col = hypre_ParCSRMatrixFirstColDiag(hP);
+    const HYPRE_BigInt *col_map_offd = hypre_ParCSRMatrixColMapOffd(hP);
+    for (HYPRE_Int i = 0; i < hypre_CSRMatrixNumRows(P_diag); i++)
+    {
+      for (HYPRE_Int k = P_diag_i[i]; k < P_diag_i[i + 1]; k++)
+      {
+        P_col.push_back(first_col + P_diag_j[k]);
+        P_val.push_back(P_diag_a[k]);
+      }
+      for (HYPRE_Int k = P_offd_i[i]; k < P_offd_i[i + 1]; k++)
+      {
+        P_col.push_back(col_map_offd[P_offd_j[k]]);
+        P_val.push_back(P_offd_a[k]);
+      }
+      P_ptr.push_back(P_col.size());
+    }
+  }
+
+  // Row partitioning and structure of A.
+  hypre_ParCSRMatrix *hA = *A;
+  hypre_CSRMatrix *A_diag = hypre_ParCSRMatrixDiag(hA);
+  hypre_CSRMatrix *A_offd = hypre_ParCSRMatrixOffd(hA);
+  const HYPRE_Int nnz_diag = hypre_CSRMatrixNumNonzeros(A_diag);
+  const HYPRE_Int nnz_offd = hypre_CSRMatrixNumNonzeros(A_offd);
+  const HYPRE_Int *A_diag_i = hypre_CSRMatrixI(A_diag);
+  const HYPRE_Int *A_diag_j = hypre_CSRMatrixJ(A_diag);
+  const HYPRE_Int *A_offd_i = hypre_CSRMatrixI(A_offd);
+  const HYPRE_Int *A_offd_j = hypre_CSRMatrixJ(A_offd);
+  const HYPRE_Int ncols_diag = hypre_CSRMatrixNumCols(A_diag);
+  const HYPRE_Int ncols_offd = hypre_CSRMatrixNumCols(A_offd);
+  const HYPRE_BigInt first_row = hypre_ParCSRMatrixFirstRowIndex(hA);
+  const HYPRE_BigInt first_col = hypre_ParCSRMatrixFirstColDiag(hA);
+  const HYPRE_BigInt *col_map_offd = hypre_ParCSRMatrixColMapOffd(hA);
+  std::vector<HYPRE_BigInt> row_starts(size + 1);
+  MPI_Allgather(&first_row, 1, HYPRE_MPI_BIG_INT, row_starts.data(), 1, HYPRE_MPI_BIG_INT,
+                comm);
+  row_starts[size] = hypre_ParCSRMatrixGlobalNumRows(hA);
+  auto Owner = [&](HYPRE_BigInt gi)
+  {
+    return static_cast<int>(std::upper_bound(row_starts.begin(), row_starts.end(), gi) -
+                            row_starts.begin()) -
+           1;
+  };
+
+  // Positions of the entries (gi, gj) of locally owned rows in the stored structure of A,
+  // indexing the diagonal block and then the off-diagonal block (-1 if not present). The
+  // entries are processed by row, marking the positions of the columns of each row.
+  std::vector<std::int64_t> marker_diag(ncols_diag, -1), marker_offd(ncols_offd, -1);
+  auto FindPositions = [&](const std::vector<HYPRE_BigInt> &idx)
+  {
+    const std::size_t n = idx.size() / 2;
+    std::vector<std::int64_t> pos(n, -1);
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&idx](std::size_t a, std::size_t b) { return idx[2 * a] < idx[2 * b]; });
+    for (std::size_t t = 0; t < n;)
+    {
+      const HYPRE_BigInt gi = idx[2 * order[t]];
+      const HYPRE_Int r = static_cast<HYPRE_Int>(gi - first_row);
+      for (HYPRE_Int k = A_diag_i[r]; k < A_diag_i[r + 1]; k++)
+      {
+        marker_diag[A_diag_j[k]] = k;
+      }
+      for (HYPRE_Int k = A_offd_i[r]; k < A_offd_i[r + 1]; k++)
+      {
+        marker_offd[A_offd_j[k]] = static_cast<std::int64_t>(nnz_diag) + k;
+      }
+      for (; t < n && idx[2 * order[t]] == gi; t++)
+      {
+        const HYPRE_BigInt gj = idx[2 * order[t] + 1];
+        if (gj >= first_col && gj < first_col + ncols_diag)
+        {
+          pos[order[t]] = marker_diag[gj - first_col];
+          continue;
+        }
+        const HYPRE_BigInt *it =
+            std::lower_bound(col_map_offd, col_map_offd + ncols_offd, gj);
+        if (it != col_map_offd + ncols_offd && *it == gj)
+        {
+          pos[order[t]] = marker_offd[it - col_map_offd];
+        }
+      }
+      for (HYPRE_Int k = A_diag_i[r]; k < A_diag_i[r + 1]; k++)
+      {
+        marker_diag[A_diag_j[k]] = -1;
+      }
+      for (HYPRE_Int k = A_offd_i[r]; k < A_offd_i[r + 1]; k++)
+      {
+        marker_offd[A_offd_j[k]] = -1;
+      }
+    }
+    return pos;
+  };
+
+  // Contributions of each local entry, as global row and column indices. Those to rows
+  // owned by other processes are grouped by owner and sorted, so that contributions to the
+  // same entry of a remote row are combined before sending.
+  struct Contribution
+  {
+    HYPRE_BigInt i, j;
+    std::size_t c;
+  };
+  const int *S_i = S.GetI(), *S_j = S.GetJ();
+  std::vector<HYPRE_BigInt> local_idx;
+  std::vector<std::size_t> local_c;
+  std::vector<std::vector<Contribution>> remote(size);
+  rap_ptr.assign(1, 0);
+  rap_coef.clear();
+  for (int i = 0; i < S.Height(); i++)
+  {
+    for (int k = S_i[i]; k < S_i[i + 1]; k++)
+    {
+      const int j = S_j[k];
+      for (std::size_t p = P_ptr[i]; p < P_ptr[i + 1]; p++)
+      {
+        const int owner = Owner(P_col[p]);
+        for (std::size_t q = P_ptr[j]; q < P_ptr[j + 1]; q++)
+        {
+          if (owner == rank)
+          {
+            local_idx.push_back(P_col[p]);
+            local_idx.push_back(P_col[q]);
+            local_c.push_back(rap_coef.size());
+          }
+          else
+          {
+            remote[owner].push_back({P_col[p], P_col[q], rap_coef.size()});
+          }
+          rap_coef.push_back(P_val[p] * P_val[q]);
+        }
+      }
+      rap_ptr.push_back(rap_coef.size());
+    }
+  }
+  rap_pos.assign(rap_coef.size(), -1);
+  bool ok = true;
+  {
+    const std::vector<std::int64_t> pos = FindPositions(local_idx);
+    for (std::size_t t = 0; t < pos.size(); t++)
+    {
+      rap_pos[local_c[t]] = pos[t];
+      ok = ok && (pos[t] >= 0);
+    }
+  }
+  auto SameEntry = [](const Contribution &a, const Contribution &b)
+  { return a.i == b.i && a.j == b.j; };
+  send_counts.assign(size, 0);
+  send_displs.assign(size + 1, 0);
+  for (int d = 0; d < size; d++)
+  {
+    std::sort(remote[d].begin(), remote[d].end(),
+              [](const Contribution &a, const Contribution &b)
+              { return (a.i < b.i) || (a.i == b.i && a.j < b.j); });
+    for (std::size_t t = 0; t < remote[d].size(); t++)
+    {
+      if (t == 0 || !SameEntry(remote[d][t], remote[d][t - 1]))
+      {
+        send_counts[d]++;
+      }
+    }
+    send_displs[d + 1] = send_displs[d] + send_counts[d];
+  }
+  std::vector<HYPRE_BigInt> send_idx(2 * static_cast<std::size_t>(send_displs[size]));
+  for (int d = 0; d < size; d++)
+  {
+    std::int64_t slot = send_displs[d] - 1;
+    for (std::size_t t = 0; t < remote[d].size(); t++)
+    {
+      const Contribution &e = remote[d][t];
+      if (t == 0 || !SameEntry(e, remote[d][t - 1]))
+      {
+        slot++;
+        send_idx[2 * slot] = e.i;
+        send_idx[2 * slot + 1] = e.j;
+      }
+      rap_pos[e.c] = static_cast<std::int64_t>(nnz_diag) + nnz_offd + slot;
+    }
+  }
+
+  // Exchange the global row and column indices of the remote contributions, and find
+  // their positions on the owning processes.
+  recv_counts.resize(size);
+  recv_displs.assign(size + 1, 0);
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm);
+  for (int d = 0; d < size; d++)
+  {
+    recv_displs[d + 1] = recv_displs[d] + recv_counts[d];
+  }
+  std::vector<HYPRE_BigInt> recv_idx(2 * static_cast<std::size_t>(recv_displs[size]));
+  {
+    std::vector<int> sc(size), sd(size), rc(size), rd(size);
+    for (int d = 0; d < size; d++)
+    {
+      sc[d] = 2 * send_counts[d];
+      sd[d] = 2 * send_displs[d];
+      rc[d] = 2 * recv_counts[d];
+      rd[d] = 2 * recv_displs[d];
+    }
+    MPI_Alltoallv(send_idx.data(), sc.data(), sd.data(), HYPRE_MPI_BIG_INT, recv_idx.data(),
+                  rc.data(), rd.data(), HYPRE_MPI_BIG_INT, comm);
+  }
+  recv_pos = FindPositions(recv_idx);
+  for (const auto pos : recv_pos)
+  {
+    ok = ok && (pos >= 0);
+  }
+
+  // The map is only used if it is complete on all processes.
+  int valid = ok;
+  MPI_Allreduce(MPI_IN_PLACE, &valid, 1, MPI_INT, MPI_MIN, comm);
+  rap_valid = valid;
+  rap_fespace = &fespace;
+  rap_sequence = fespace.GetSequence();
+}
+
+void PersistentParMatrix::RefillValues(const mfem::SparseMatrix &S)
+{
+  hypre_CSRMatrix *A_diag = hypre_ParCSRMatrixDiag((hypre_ParCSRMatrix *)*A);
+  hypre_CSRMatrix *A_offd = hypre_ParCSRMatrixOffd((hypre_ParCSRMatrix *)*A);
+  const std::int64_t nnz_diag = hypre_CSRMatrixNumNonzeros(A_diag);
+  const std::int64_t nnz_offd = hypre_CSRMatrixNumNonzeros(A_offd);
+  HYPRE_Real *A_diag_a = hypre_CSRMatrixData(A_diag);
+  HYPRE_Real *A_offd_a = hypre_CSRMatrixData(A_offd);
+  std::fill(A_diag_a, A_diag_a + nnz_diag, 0.0);
+  std::fill(A_offd_a, A_offd_a + nnz_offd, 0.0);
+  std::vector<HYPRE_Real> send(send_displs.back(), 0.0), recv(recv_displs.back());
+  const double *S_a = S.GetData();
+  for (int k = 0; k < S.NumNonZeroElems(); k++)
+  {
+    for (std::size_t c = rap_ptr[k]; c < rap_ptr[k + 1]; c++)
+    {
+      const std::int64_t pos = rap_pos[c];
+      const HYPRE_Real v = rap_coef[c] * S_a[k];
+      if (pos < nnz_diag)
+      {
+        A_diag_a[pos] += v;
+      }
+      else if (pos < nnz_diag + nnz_offd)
+      {
+        A_offd_a[pos - nnz_diag] += v;
+      }
+      else
+      {
+        send[pos - nnz_diag - nnz_offd] += v;
+      }
+    }
+  }
+  MPI_Alltoallv(send.data(), send_counts.data(), send_displs.data(), HYPRE_MPI_REAL,
+                recv.data(), recv_counts.data(), recv_displs.data(), HYPRE_MPI_REAL,
+                A->GetComm());
+  for (std::size_t r = 0; r < recv.size(); r++)
+  {
+    if (recv_pos[r] < nnz_diag)
+    {
+      A_diag_a[recv_pos[r]] += recv[r];
+    }
+    else
+    {
+      A_offd_a[recv_pos[r] - nnz_diag] += recv[r];
+    }
+  }
+}
+
+void PersistentParMatrix::SetUpElimination(const mfem::Array<int> &ess_tdof_list)
+{
+  // Find the eliminated entries by eliminating on a matrix of all ones: the entries which
+  // are zeroed are exactly those modified by mfem::HypreParMatrix::EliminateBC. This
+  // requires communication only once, and also sets up the communication package for the
+  // persistent matrix.
+  hypre_ParCSRMatrix *hA = *A;
+  hypre_CSRMatrix *A_diag = hypre_ParCSRMatrixDiag(hA);
+  hypre_CSRMatrix *A_offd = hypre_ParCSRMatrixOffd(hA);
+  const HYPRE_Int nnz_diag = hypre_CSRMatrixNumNonzeros(A_diag);
+  const HYPRE_Int nnz_offd = hypre_CSRMatrixNumNonzeros(A_offd);
+  HYPRE_Real *A_diag_a = hypre_CSRMatrixData(A_diag);
+  HYPRE_Real *A_offd_a = hypre_CSRMatrixData(A_offd);
+  const HYPRE_Int *A_diag_i = hypre_CSRMatrixI(A_diag);
+  const HYPRE_Int *A_diag_j = hypre_CSRMatrixJ(A_diag);
+  std::vector<HYPRE_Real> diag_a(A_diag_a, A_diag_a + nnz_diag);
+  std::vector<HYPRE_Real> offd_a(A_offd_a, A_offd_a + nnz_offd);
+  std::fill(A_diag_a, A_diag_a + nnz_diag, 1.0);
+  std::fill(A_offd_a, A_offd_a + nnz_offd, 1.0);
+  A->EliminateBC(ess_tdof_list, mfem::Operator::DiagonalPolicy::DIAG_KEEP);
+
+  elim_diag.clear();
+  elim_offd.clear();
+  elim_diag_diag.clear();
+  for (HYPRE_Int k = 0; k < nnz_diag; k++)
+  {
+    if (A_diag_a[k] == 0.0)
+    {
+      elim_diag.push_back(k);
+    }
+  }
+  for (HYPRE_Int k = 0; k < nnz_offd; k++)
+  {
+    if (A_offd_a[k] == 0.0)
+    {
+      elim_offd.push_back(k);
+    }
+  }
+  elim_diag_diag.reserve(ess_tdof_list.Size());
+  for (auto i : ess_tdof_list)
+  {
+    for (HYPRE_Int k = A_diag_i[i]; k < A_diag_i[i + 1]; k++)
+    {
+      if (A_diag_j[k] == i)
+      {
+        elim_diag_diag.push_back(k);
+        break;
+      }
+    }
+  }
+  elim_tdof_list = ess_tdof_list;
+  elim_valid = true;
+
+  // Restore the original values.
+  std::copy(diag_a.begin(), diag_a.end(), A_diag_a);
+  std::copy(offd_a.begin(), offd_a.end(), A_offd_a);
+}
+
+void PersistentParMatrix::UseSparsity(mfem::ParBilinearForm &a) const
+{
+  if (sparsity)
+  {
+    a.UseSparsity(*sparsity);
+  }
+}
+
+mfem::HypreParMatrix &
+PersistentParMatrix::Assemble(mfem::ParBilinearForm &a,
+                              const mfem::Array<int> &ess_tdof_list,
+                              mfem::Operator::DiagonalPolicy diag_policy)
+{
+  // Refill the values directly from the local matrix if its sparsity and the finite
+  // element space are unchanged on all processes, skipping the triple product.
+  const mfem::SparseMatrix &S = a.SpMat();
+  int reuse = rap_valid && sparsity && a.ParFESpace() == rap_fespace &&
+              a.ParFESpace()->GetSequence() == rap_sequence &&
+              S.Height() == sparsity->Height() &&
+              S.NumNonZeroElems() == sparsity->NumNonZeroElems() &&
+              std::equal(S.GetI(), S.GetI() + S.Height() + 1, sparsity->GetI()) &&
+              std::equal(S.GetJ(), S.GetJ() + S.NumNonZeroElems(), sparsity->GetJ());
+  MPI_Allreduce(MPI_IN_PLACE, &reuse, 1, MPI_INT, MPI_MIN, a.ParFESpace()->GetComm());
+  if (reuse)
+  {
+    RefillValues(S);
+    return EliminateBC(ess_tdof_list, diag_policy);
+  }
+
+  // Keep a copy of the local sparsity pattern for subsequent assemblies.
+  sparsity = std::make_unique<mfem::SparseMatrix>(S);
+  A.reset(a.ParallelAssemble());
+  elim_valid = false;
+  SetUpParallelAssembly(a);
+  return EliminateBC(ess_tdof_list, diag_policy);
+}
+
+mfem::HypreParMatrix &
+PersistentParMatrix::Assemble(std::unique_ptr<mfem::HypreParMatrix> &&B,
+                              const mfem::Array<int> &ess_tdof_list,
+                              mfem::Operator::DiagonalPolicy diag_policy)
+{
+  if (HasSameStructure(*B))
+  {
+    // Refill the values of the persistent matrix.
+    hypre_CSRMatrix *A_diag = hypre_ParCSRMatrixDiag((hypre_ParCSRMatrix *)*A);
+    hypre_CSRMatrix *A_offd = hypre_ParCSRMatrixOffd((hypre_ParCSRMatrix *)*A);
+    hypre_CSRMatrix *B_diag = hypre_ParCSRMatrixDiag((hypre_ParCSRMatrix *)*B);
+    hypre_CSRMatrix *B_offd = hypre_ParCSRMatrixOffd((hypre_ParCSRMatrix *)*B);
+    std::copy(hypre_CSRMatrixData(B_diag),
+              hypre_CSRMatrixData(B_diag) + hypre_CSRMatrixNumNonzeros(B_diag),
+              hypre_CSRMatrixData(A_diag));
+    std::copy(hypre_CSRMatrixData(B_offd),
+              hypre_CSRMatrixData(B_offd) + hypre_CSRMatrixNumNonzeros(B_offd),
+              hypre_CSRMatrixData(A_offd));
+  }
+  else
+  {
+    A = std::move(B);
+    elim_valid = false;
+    rap_valid = false;
+  }
+  return EliminateBC(ess_tdof_list, diag_policy);
+}
+
+mfem::HypreParMatrix &
+PersistentParMatrix::EliminateBC(const mfem::Array<int> &ess_tdof_list,
+                                 mfem::Operator::DiagonalPolicy diag_policy)
+{
+  if (!elim_valid || elim_tdof_list.Size() != ess_tdof_list.Size() ||
+      !std::equal(ess_tdof_list.begin(), ess_tdof_list.end(), elim_tdof_list.begin()))
+  {
+    SetUpElimination(ess_tdof_list);
+  }
+
+  // Apply the elimination using the stored entry positions.
+  HYPRE_Real *A_diag_a =
+      hypre_CSRMatrixData(hypre_ParCSRMatrixDiag((hypre_ParCSRMatrix *)*A));
+  HYPRE_Real *A_offd_a =
+      hypre_CSRMatrixData(hypre_ParCSRMatrixOffd((hypre_ParCSRMatrix *)*A));
+  for (auto k : elim_diag)
+  {
+    A_diag_a[k] = 0.0;
+  }
+  for (auto k : elim_offd)
+  {
+    A_offd_a[k] = 0.0;
+  }
+  if (diag_policy != mfem::Operator::DiagonalPolicy::DIAG_KEEP)
+  {
+    const HYPRE_Real diag =
+        (diag_policy == mfem::Operator::DiagonalPolicy::DIAG_ONE) ? 1.0 : 0.0;
+    for (auto k : elim_diag_diag)
+    {
+      A_diag_a[k] = diag;
+    }
+  }
+  return *A;
+}
+
+std::unique_ptr<mfem::HypreParMatrix> PersistentParMatrix::GetView() const
+{
+  MFEM_VERIFY(A, "PersistentParMatrix has not been assembled!");
+  return std::make_unique<mfem::HypreParMatrix>((hypre_ParCSRMatrix *)*A, false);
+}
+
+HypreParMatrixSum::HypreParMatrixSum(const std::vector<const mfem::HypreParMatrix *> &A,
+                                     const std::vector<std::complex<double>> &w)
+  : mfem::Operator(A.empty() ? 0 : A[0]->Height(), A.empty() ? 0 : A[0]->Width()), mats(A)
+{
+  MFEM_VERIFY(!A.empty() && A.size() == w.size(),
+              "Invalid number of matrices or weights for HypreParMatrixSum!");
+
+  // Construct the shared sparsity pattern as the union of the patterns of all terms.
+  G = std::make_unique<mfem::HypreParMatrix>(*A[0]);
+  for (std::size_t k = 1; k < A.size(); k++)
+  {
+    MFEM_VERIFY(A[k]->Height() == height && A[k]->Width() == width,
+                "Invalid matrix dimensions for HypreParMatrixSum!");
+    G.reset(mfem::Add(1.0, *G, 1.0, *A[k]));
+  }
+  hypre_ParCSRMatrix *hG = *G;
+  if (!hypre_ParCSRMatrixCommPkg(hG))
+  {
+    hypre_MatvecCommPkgCreate(hG);
+  }
+
+  // Locate the nonzeros of each term in the shared graph. The sparsity of each term is a
+  // subset of the shared sparsity by construction.
+  diag_pos.resize(A.size());
+  offd_pos.resize(A.size());
+  for (std::size_t k = 0; k < A.size(); k++)
+  {
+    MFEM_VERIFY(GetPositions(*A[k], diag_pos[k], offd_pos[k]),
+                "Found nonzero entry which is not in HypreParMatrixSum sparsity!");
+  }
+  hypre_CSRMatrix *G_diag = hypre_ParCSRMatrixDiag(hG);
+  hypre_CSRMatrix *G_offd = hypre_ParCSRMatrixOffd(hG);
+  diag_ai.resize(hypre_CSRMatrixI(G_diag)[hypre_CSRMatrixNumRows(G_diag)]);
+  offd_ai.resize(hypre_CSRMatrixI(G_offd)[hypre_CSRMatrixNumRows(G_offd)]);
+  SetWeights(w);
+
+  // Allocate communication buffers.
+  hypre_ParCSRCommPkg *comm_pkg = hypre_ParCSRMatrixCommPkg(hG);
+  HYPRE_Int num_sends = hypre_ParCSRCommPkgNumSends(comm_pkg);
+  send_r.resize(hypre_ParCSRCommPkgSendMapStart(comm_pkg, num_sends));
+  send_i.resize(send_r.size());
+  offd_r.resize(hypre_CSRMatrixNumCols(G_offd));
+  offd_i.resize(offd_r.size());
+}
+
+bool HypreParMatrixSum::GetPositions(const mfem::HypreParMatrix &A,
+                                     std::vector<HYPRE_Int> &dpos,
+                                     std::vector<HYPRE_Int> &opos) const
+{
+  hypre_ParCSRMatrix *hG = *G;
+
+  hypre_CSRMatrix *G_diag = hypre_ParCSRMatrixDiag(hG);
+  HYPRE_Int *G_diag_i = hypre_CSRMatrixI(G_diag);
+  HYPRE_Int *G_diag_j = hypre_CSRMatrixJ(G_diag);
+  HYPRE_Int ncols_G_diag = hypre_CSRMatrixNumCols(G_diag);
+
+  hypre_CSRMatrix *G_offd = hypre_ParCSRMatrixOffd(hG);
+  HYPRE_Int *G_offd_i = hypre_CSRMatrixI(G_offd);
+  HYPRE_Int *G_offd_j = hypre_CSRMatrixJ(G_offd);
+  HYPRE_Int ncols_G_offd = hypre_CSRMatrixNumCols(G_offd);
+
+  HYPRE_BigInt *col_map_offd_G = hypre_ParCSRMatrixColMapOffd(hG);
+
+  HYPRE_BigInt first_row = hypre_ParCSRMatrixFirstRowIndex(hG);
+  HYPRE_Int nrows_local = hypre_CSRMatrixNumRows(G_diag);
+
+  hypre_ParCSRMatrix *hA = A;
+
+  hypre_CSRMatrix *A_diag = hypre_ParCSRMatrixDiag(hA);
+  HYPRE_Int *A_diag_i = hypre_CSRMatrixI(A_diag);
+  HYPRE_Int *A_diag_j = hypre_CSRMatrixJ(A_diag);
+
+  hypre_CSRMatrix *A_offd = hypre_ParCSRMatrixOffd(hA);
+  HYPRE_Int *A_offd_i = hypre_CSRMatrixI(A_offd);
+  HYPRE_Int *A_offd_j = hypre_CSRMatrixJ(A_offd);
+  HYPRE_Int ncols_A_offd = hypre_CSRMatrixNumCols(A_offd);
+
+  HYPRE_BigInt *col_map_offd_A = hypre_ParCSRMatrixColMapOffd(hA);
+
+  MFEM_VERIFY(first_row == hypre_ParCSRMatrixFirstRowIndex(hA) &&
+                  nrows_local == hypre_CSRMatrixNumRows(A_diag) &&
+                  ncols_G_diag == hypre_CSRMatrixNumCols(A_diag),
+              "Invalid mismatch in matrix sizes/distribution!");
+
+  HYPRE_Int i, j, pos;
+
+  // Map the off-diagonal columns of the term to those of the shared graph (the column maps
+  // are sorted by global index).
+  std::vector<HYPRE_Int> offd_map(ncols_A_offd);
+  for (j = 0; j < ncols_A_offd; j++)
+  {
+    auto it =
+        std::lower_bound(col_map_offd_G, col_map_offd_G + ncols_G_offd, col_map_offd_A[j]);
+    if (it == col_map_offd_G + ncols_G_offd || *it != col_map_offd_A[j])
+    {
+      return false;
+    }
+    offd_map[j] = static_cast<HYPRE_Int>(it - col_map_offd_G);
+  }
+
+  // Markers left over from previous rows always point before the start of the current row.
+  std::vector<HYPRE_Int> marker_diag(ncols_G_diag, -1), marker_offd(ncols_G_offd, -1);
+  dpos.resize(A_diag_i[nrows_local]);
+  opos.resize(A_offd_i[nrows_local]);
+  for (i = 0; i < nrows_local; i++)
+  {
+    for (j = G_diag_i[i]; j < G_diag_i[i + 1]; j++)
+    {
+      marker_diag[G_diag_j[j]] = j;
+    }
+    for (j = A_diag_i[i]; j < A_diag_i[i + 1]; j++)
+    {
+      pos = marker_diag[A_diag_j[j]];
+      if (pos < G_diag_i[i])
+      {
+        return false;
+      }
+      dpos[j] = pos;
+    }
+
+    for (j = G_offd_i[i]; j < G_offd_i[i + 1]; j++)
+    {
+      marker_offd[G_offd_j[j]] = j;
+    }
+    for (j = A_offd_i[i]; j < A_offd_i[i + 1]; j++)
+    {
+      pos = marker_offd[offd_map[A_offd_j[j]]];
+      if (pos < G_offd_i[i])
+      {
+        return false;
+      }
+      opos[j] = pos;
+    }
+  }
+  return true;
+}
+
+void HypreParMatrixSum::SetWeights(const std::vector<std::complex<double>> &w)
+{
+  MFEM_VERIFY(w.size() == mats.size(), "Invalid number of weights for HypreParMatrixSum!");
+
+  // Accumulate the weighted values of all terms into the values of the shared graph (real
+  // part) and the separate storage for the imaginary part.
+  hypre_ParCSRMatrix *hG = *G;
+  hypre_CSRMatrix *G_diag = hypre_ParCSRMatrixDiag(hG);
+  hypre_CSRMatrix *G_offd = hypre_ParCSRMatrixOffd(hG);
+  HYPRE_Real *G_diag_a = hypre_CSRMatrixData(G_diag);
+  HYPRE_Real *G_offd_a = hypre_CSRMatrixData(G_offd);
+  std::fill(G_diag_a, G_diag_a + diag_ai.size(), 0.0);
+  std::fill(G_offd_a, G_offd_a + offd_ai.size(), 0.0);
+  std::fill(diag_ai.begin(), diag_ai.end(), 0.0);
+  std::fill(offd_ai.begin(), offd_ai.end(), 0.0);
+  for (std::size_t k = 0; k < mats.size(); k++)
+  {
+    hypre_ParCSRMatrix *hA = *mats[k];
+    const HYPRE_Real *A_diag_a = hypre_CSRMatrixData(hypre_ParCSRMatrixDiag(hA));
+    const HYPRE_Real *A_offd_a = hypre_CSRMatrixData(hypre_ParCSRMatrixOffd(hA));
+    const double wr = w[k].real(), wi = w[k].imag();
+    for (std::size_t j = 0; j < diag_pos[k].size(); j++)
+    {
+      G_diag_a[diag_pos[k][j]] += wr * A_diag_a[j];
+      diag_ai[diag_pos[k][j]] += wi * A_diag_a[j];
+    }
+    for (std::size_t j = 0; j < offd_pos[k].size(); j++)
+    {
+      G_offd_a[offd_pos[k][j]] += wr * A_offd_a[j];
+      offd_ai[offd_pos[k][j]] += wi * A_offd_a[j];
+    }
+  }
+}
+
+bool HypreParMatrixSum::Update(const std::vector<const mfem::HypreParMatrix *> &A,
+                               const std::vector<std::complex<double>> &w)
+{
+  // Only the terms whose matrices have changed are located in the shared graph again. The
+  // sum is left unchanged if any of them does not fit in the shared sparsity pattern.
+  if (A.size() != mats.size())
+  {
+    return false;
+  }
+  std::vector<std::vector<HYPRE_Int>> dpos(A.size()), opos(A.size());
+  for (std::size_t k = 0; k < A.size(); k++)
+  {
+    if (A[k] != mats[k] && (A[k]->Height() != height || A[k]->Width() != width ||
+                            !GetPositions(*A[k], dpos[k], opos[k])))
+    {
+      return false;
+    }
+  }
+  for (std::size_t k = 0; k < A.size(); k++)
+  {
+    if (A[k] != mats[k])
+    {
+      mats[k] = A[k];
+      diag_pos[k] = std::move(dpos[k]);
+      offd_pos[k] = std::move(opos[k]);
+    }
+  }
+  SetWeights(w);
+  return true;
+}
+
+void HypreParMatrixSum::MultInternal(const mfem::Vector &xr, const mfem::Vector &xi,
+                                     mfem::Vector &yr, mfem::Vector &yi, double a,
+                                     bool add) const
+{
+  // Computes y = a A x or y += a A x.
+  hypre_ParCSRMatrix *hG = *G;
+
+  hypre_CSRMatrix *G_diag = hypre_ParCSRMatrixDiag(hG);
+  const HYPRE_Real *G_diag_a = hypre_CSRMatrixData(G_diag);
+  HYPRE_Int *G_diag_i = hypre_CSRMatrixI(G_diag);
+  HYPRE_Int *G_diag_j = hypre_CSRMatrixJ(G_diag);
+
+  hypre_CSRMatrix *G_offd = hypre_ParCSRMatrixOffd(hG);
+  const HYPRE_Real *G_offd_a = hypre_CSRMatrixData(G_offd);
+  HYPRE_Int *G_offd_i = hypre_CSRMatrixI(G_offd);
+  HYPRE_Int *G_offd_j = hypre_CSRMatrixJ(G_offd);
+
+  hypre_ParCSRCommPkg *comm_pkg = hypre_ParCSRMatrixCommPkg(hG);
+  HYPRE_Int num_sends = hypre_ParCSRCommPkgNumSends(comm_pkg);
+  HYPRE_Int *send_map = hypre_ParCSRCommPkgSendMapElmts(comm_pkg);
+  HYPRE_Int send_size = hypre_ParCSRCommPkgSendMapStart(comm_pkg, num_sends);
+
+  HYPRE_Int nrows_local = hypre_CSRMatrixNumRows(G_diag);
+
+  HYPRE_Int i, j;
+
+  const double *XR = xr.HostRead();
+  const double *XI = xi.HostRead();
+  double *YR = add ? yr.HostReadWrite() : yr.HostWrite();
+  double *YI = add ? yi.HostReadWrite() : yi.HostWrite();
+
+  // Start communication of the off-processor entries of x.
+  for (i = 0; i < send_size; i++)
+  {
+    send_r[i] = XR[send_map[i]];
+    send_i[i] = XI[send_map[i]];
+  }
+  hypre_ParCSRCommHandle *comm_handle_r =
+      hypre_ParCSRCommHandleCreate(1, comm_pkg, send_r.data(), offd_r.data());
+  hypre_ParCSRCommHandle *comm_handle_i =
+      hypre_ParCSRCommHandleCreate(1, comm_pkg, send_i.data(), offd_i.data());
+
+  // Diagonal block.
+  for (i = 0; i < nrows_local; i++)
+  {
+    double sr = 0.0, si = 0.0;
+    for (j = G_diag_i[i]; j < G_diag_i[i + 1]; j++)
+    {
+      const HYPRE_Int c = G_diag_j[j];
+      sr += G_diag_a[j] * XR[c] - diag_ai[j] * XI[c];
+      si += G_diag_a[j] * XI[c] + diag_ai[j] * XR[c];
+    }
+    YR[i] = add ? YR[i] + a * sr : a * sr;
+    YI[i] = add ? YI[i] + a * si : a * si;
+  }
+
+  // Off-diagonal block, once the off-processor entries of x are available.
+  hypre_ParCSRCommHandleDestroy(comm_handle_r);
+  hypre_ParCSRCommHandleDestroy(comm_handle_i);
+  for (i = 0; i < nrows_local; i++)
+  {
+    double sr = 0.0, si = 0.0;
+    for (j = G_offd_i[i]; j < G_offd_i[i + 1]; j++)
+    {
+      const HYPRE_Int c = G_offd_j[j];
+      sr += G_offd_a[j] * offd_r[c] - offd_ai[j] * offd_i[c];
+      si += G_offd_a[j] * offd_i[c] + offd_ai[j] * offd_r[c];
+    }
+    YR[i] += a * sr;
+    YI[i] += a * si;
+  }
+}
+
+void HypreParMatrixSum::MultTransposeInternal(const mfem::Vector &xr,
+                                              const mfem::Vector &xi, mfem::Vector &yr,
+                                              mfem::Vector &yi, double a, bool add) const
+{
+  // Computes y = a Aᵀ x or y += a Aᵀ x (non-Hermitian transpose).
+  hypre_ParCSRMatrix *hG = *G;
+
+  hypre_CSRMatrix *G_diag = hypre_ParCSRMatrixDiag(hG);
+  const HYPRE_Real *G_diag_a = hypre_CSRMatrixData(G_diag);
+  HYPRE_Int *G_diag_i = hypre_CSRMatrixI(G_diag);
+  HYPRE_Int *G_diag_j = hypre_CSRMatrixJ(G_diag);
+
+  hypre_CSRMatrix *G_offd = hypre_ParCSRMatrixOffd(hG);
+  const HYPRE_Real *G_offd_a = hypre_CSRMatrixData(G_offd);
+  HYPRE_Int *G_offd_i = hypre_CSRMatrixI(G_offd);
+  HYPRE_Int *G_offd_j = hypre_CSRMatrixJ(G_offd);
+
+  hypre_ParCSRCommPkg *comm_pkg = hypre_ParCSRMatrixCommPkg(hG);
+  HYPRE_Int num_sends = hypre_ParCSRCommPkgNumSends(comm_pkg);
+  HYPRE_Int *send_map = hypre_ParCSRCommPkgSendMapElmts(comm_pkg);
+  HYPRE_Int send_size = hypre_ParCSRCommPkgSendMapStart(comm_pkg, num_sends);
+
+  HYPRE_Int nrows_local = hypre_CSRMatrixNumRows(G_diag);
+
+  HYPRE_Int i, j;
+
+  const double *XR = xr.HostRead();
+  const double *XI = xi.HostRead();
+  double *YR = add ? yr.HostReadWrite() : yr.HostWrite();
+  double *YI = add ? yi.HostReadWrite() : yi.HostWrite();
+
+  // Off-diagonal block contributions to off-processor entries of y, which are sent back to
+  // their owners.
+  std::fill(offd_r.begin(), offd_r.end(), 0.0);
+  std::fill(offd_i.begin(), offd_i.end(), 0.0);
+  for (i = 0; i < nrows_local; i++)
+  {
+    const double xr_i = a * XR[i], xi_i = a * XI[i];
+    for (j = G_offd_i[i]; j < G_offd_i[i + 1]; j++)
+    {
+      const HYPRE_Int c = G_offd_j[j];
+      offd_r[c] += G_offd_a[j] * xr_i - offd_ai[j] * xi_i;
+      offd_i[c] += G_offd_a[j] * xi_i + offd_ai[j] * xr_i;
+    }
+  }
+  hypre_ParCSRCommHandle *comm_handle_r =
+      hypre_ParCSRCommHandleCreate(2, comm_pkg, offd_r.data(), send_r.data());
+  hypre_ParCSRCommHandle *comm_handle_i =
+      hypre_ParCSRCommHandleCreate(2, comm_pkg, offd_i.data(), send_i.data());
+
+  // Diagonal block.
+  if (!add)
+  {
+    for (i = 0; i < nrows_local; i++)
+    {
+      YR[i] = YI[i] = 0.0;
+    }
+  }
+  for (i = 0; i < nrows_local; i++)
+  {
+    const double xr_i = a * XR[i], xi_i = a * XI[i];
+    for (j = G_diag_i[i]; j < G_diag_i[i + 1]; j++)
+    {
+      const HYPRE_Int c = G_diag_j[j];
+      YR[c] += G_diag_a[j] * xr_i - diag_ai[j] * xi_i;
+      YI[c] += G_diag_a[j] * xi_i + diag_ai[j] * xr_i;
+    }
+  }
+
+  // Accumulate the received off-processor contributions.
+  hypre_ParCSRCommHandleDestroy(comm_handle_r);
+  hypre_ParCSRCommHandleDestroy(comm_handle_i);
+  for (i = 0; i < send_size; i++)
+  {
+    YR[send_map[i]] += send_r[i];
+    YI[send_map[i]] += send_i[i];
+  }
+}
+
+void HypreParMatrixSum::ArrayMultInternal(const mfem::Array<const mfem::Vector *> &X,
+                                          mfem::Array<mfem::Vector *> &Y, double a,
+                                          bool add, bool transpose) const
+{
+  MFEM_VERIFY(X.Size() == Y.Size() && X.Size() % 2 == 0,
+              "HypreParMatrixSum requires (real, imaginary) pairs of vectors!");
+  for (int j = 0; j < X.Size(); j += 2)
+  {
+    if (transpose)
+    {
+      MultTransposeInternal(*X[j], *X[j + 1], *Y[j], *Y[j + 1], a, add);
+    }
+    else
+    {
+      MultInternal(*X[j], *X[j + 1], *Y[j], *Y[j + 1], a, add);
+    }
+  }
+}
+
 }  // namespace palace::hypre
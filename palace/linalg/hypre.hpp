@@ -4,6 +4,10 @@
 #ifndef PALACE_HYPRE_HPP
 #define PALACE_HYPRE_HPP
 
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include <mfem.hpp>
 
 namespace mfem
@@ -65,6 +69,174 @@ void hypreParCSRRowSums(hypre_ParCSRMatrix *A, mfem::Vector &rowsums);
 // imaginary parts, for sparsity(Ai) ⊆ sparsity(Ar).
 void hypreParCSRInfNorm(hypre_ParCSRMatrix *Ar, hypre_ParCSRMatrix *Ai, HYPRE_Real *norm);
 
+//
+// Persistent storage for repeated parallel assembly of a bilinear form with unchanging
+// sparsity. Keeps the local CSR graph, the assembled parallel matrix (including its
+// communication package), the map from the entries of the local matrix to those of the
+// parallel matrix, and the positions of the entries eliminated for essential boundary
+// conditions, so that reassembly only refills the numeric values without recomputing the
+// triple product with the prolongation matrix.
+//
+class PersistentParMatrix
+{
+private:
+  // Sparsity pattern of the local (unassembled) matrix.
+  std::unique_ptr<mfem::SparseMatrix> sparsity;
+
+  // The persistent parallel matrix.
+  std::unique_ptr<mfem::HypreParMatrix> A;
+
+  // Map from the entries of the local matrix to the entries of the parallel matrix
+  // A = Pᵀ A_local P. Local entry k contributes with weights rap_coef to the positions
+  // rap_pos[rap_ptr[k]:rap_ptr[k + 1]], which index the diagonal block, then the
+  // off-diagonal block, then the buffer of values sent to the processes owning the rows.
+  // Received values are added at the positions recv_pos. The offsets and positions are
+  // 64-bit, since they range over all local contributions.
+  std::vector<std::size_t> rap_ptr;
+  std::vector<std::int64_t> rap_pos, recv_pos;
+  std::vector<HYPRE_Real> rap_coef;
+  std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+  const mfem::ParFiniteElementSpace *rap_fespace = nullptr;
+  long rap_sequence = -1;
+  bool rap_valid = false;
+
+  // Positions of eliminated off-diagonal entries in the diagonal and off-diagonal blocks,
+  // and of the diagonal entries for eliminated rows.
+  std::vector<HYPRE_Int> elim_diag, elim_offd, elim_diag_diag;
+  mfem::Array<int> elim_tdof_list;
+  bool elim_valid = false;
+
+  // Check if B has the same parallel sparsity pattern as the stored matrix.
+  bool HasSameStructure(const mfem::HypreParMatrix &B) const;
+
+  // Compute the map from local matrix entries to parallel matrix entries for the bilinear
+  // form, after the stored matrix has been assembled from it.
+  void SetUpParallelAssembly(mfem::ParBilinearForm &a);
+
+  // Refill the values of the stored matrix from the local matrix using the stored map.
+  void RefillValues(const mfem::SparseMatrix &S);
+
+  // Compute the positions of entries to eliminate for the given essential true dofs.
+  void SetUpElimination(const mfem::Array<int> &ess_tdof_list);
+
+  // Eliminate the rows and columns of the stored matrix for essential true dofs.
+  mfem::HypreParMatrix &EliminateBC(const mfem::Array<int> &ess_tdof_list,
+                                    mfem::Operator::DiagonalPolicy diag_policy);
+
+public:
+  // Prepare a bilinear form for assembly, reusing the stored local sparsity pattern if
+  // available. Must be called before mfem::ParBilinearForm::Assemble.
+  void UseSparsity(mfem::ParBilinearForm &a) const;
+
+  // Assemble the parallel matrix from the (assembled and finalized) bilinear form and
+  // eliminate the rows and columns for essential true dofs. Returns a reference to the
+  // stored matrix, whose values are overwritten by the next call.
+  mfem::HypreParMatrix &Assemble(mfem::ParBilinearForm &a,
+                                 const mfem::Array<int> &ess_tdof_list,
+                                 mfem::Operator::DiagonalPolicy diag_policy);
+
+  // Same as above, but for an already parallel assembled matrix (for example from a LOR
+  // discretization).
+  mfem::HypreParMatrix &Assemble(std::unique_ptr<mfem::HypreParMatrix> &&B,
+                                 const mfem::Array<int> &ess_tdof_list,
+                                 mfem::Operator::DiagonalPolicy diag_policy);
+
+  // Return a non-owning view of the stored matrix.
+  std::unique_ptr<mfem::HypreParMatrix> GetView() const;
+};
+
+//
+// A weighted sum of parallel matrices A = Σₖ wₖ Aₖ with complex weights wₖ. The sum is
+// stored on a single shared local CSR graph (the union of the sparsity patterns of the
+// matrices) with complex values, so an application of A streams the graph and the input
+// and output vectors once regardless of the number of terms. The matrices are not copied:
+// the position of each of their nonzeros in the shared graph is stored, and the values of
+// the sum are recomputed from them when the weights are updated. The matrices must remain
+// valid for the lifetime of the sum. The operator acts on complex vectors stored as
+// consecutive (real, imaginary) pairs of real vectors through the ArrayMult interface. All
+// matrices must have the same row and column partitioning. Specialized for host operation
+// currently.
+//
+class HypreParMatrixSum : public mfem::Operator
+{
+private:
+  // Shared sparsity pattern and communication package. The values of the shared graph
+  // hold the real part of the sum.
+  std::unique_ptr<mfem::HypreParMatrix> G;
+
+  // Imaginary part of the sum for the diagonal and off-diagonal blocks of the shared graph.
+  std::vector<HYPRE_Real> diag_ai, offd_ai;
+
+  // Matrices in the sum (not owned) and the positions of their nonzeros in the diagonal and
+  // off-diagonal blocks of the shared graph.
+  std::vector<const mfem::HypreParMatrix *> mats;
+  std::vector<std::vector<HYPRE_Int>> diag_pos, offd_pos;
+
+  // Temporary storage for communication of off-processor vector entries.
+  mutable std::vector<HYPRE_Real> send_r, send_i, offd_r, offd_i;
+
+  // Compute the positions of the nonzeros of A in the shared graph, returning false if the
+  // sparsity of A is not contained in the shared sparsity pattern.
+  bool GetPositions(const mfem::HypreParMatrix &A, std::vector<HYPRE_Int> &dpos,
+                    std::vector<HYPRE_Int> &opos) const;
+
+  void MultInternal(const mfem::Vector &xr, const mfem::Vector &xi, mfem::Vector &yr,
+                    mfem::Vector &yi, double a, bool add) const;
+  void MultTransposeInternal(const mfem::Vector &xr, const mfem::Vector &xi,
+                             mfem::Vector &yr, mfem::Vector &yi, double a, bool add) const;
+  void ArrayMultInternal(const mfem::Array<const mfem::Vector *> &X,
+                         mfem::Array<mfem::Vector *> &Y, double a, bool add,
+                         bool transpose) const;
+
+public:
+  HypreParMatrixSum(const std::vector<const mfem::HypreParMatrix *> &A,
+                    const std::vector<std::complex<double>> &w);
+
+  // Returns the number of matrices in the sum.
+  int GetNumTerms() const { return static_cast<int>(mats.size()); }
+
+  // Update the weights of the matrices in the sum (in the order of construction).
+  void SetWeights(const std::vector<std::complex<double>> &w);
+
+  // Update the matrices and weights of the sum, reusing the shared sparsity pattern. Only
+  // matrices which differ from the current ones are located in the shared graph again.
+  // Returns false, leaving the sum unchanged, if the number of matrices differs or the
+  // sparsity of any of the new matrices is not contained in the shared sparsity pattern.
+  bool Update(const std::vector<const mfem::HypreParMatrix *> &A,
+              const std::vector<std::complex<double>> &w);
+
+  void Mult(const mfem::Vector &x, mfem::Vector &y) const override
+  {
+    MFEM_ABORT("HypreParMatrixSum only supports application to (real, imaginary) pairs of "
+               "vectors with ArrayMult!");
+  }
+
+  void ArrayMult(const mfem::Array<const mfem::Vector *> &X,
+                 mfem::Array<mfem::Vector *> &Y) const override
+  {
+    ArrayMultInternal(X, Y, 1.0, false, false);
+  }
+
+  void ArrayMultTranspose(const mfem::Array<const mfem::Vector *> &X,
+                          mfem::Array<mfem::Vector *> &Y) const override
+  {
+    ArrayMultInternal(X, Y, 1.0, false, true);
+  }
+
+  void ArrayAddMult(const mfem::Array<const mfem::Vector *> &X,
+                    mfem::Array<mfem::Vector *> &Y, const double a = 1.0) const override
+  {
+    ArrayMultInternal(X, Y, a, true, false);
+  }
+
+  void ArrayAddMultTranspose(const mfem::Array<const mfem::Vector *> &X,
+                             mfem::Array<mfem::Vector *> &Y,
+                             const double a = 1.0) const override
+  {
+    ArrayMultInternal(X, Y, a, true, true);
+  }
+};
+
 }  // namespace palace::hypre
 
 #endif  // PALACE_HYPRE_HPP
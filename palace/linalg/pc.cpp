@@ -6,6 +6,7 @@
 #include <petsc.h>
 #include "linalg/amg.hpp"
 #include "linalg/ams.hpp"
+#include "linalg/complex.hpp"
 #include "linalg/gmg.hpp"
 #include "linalg/mumps.hpp"
 #include "linalg/strumpack.hpp"
@@ -99,6 +100,18 @@ ConfigurePreconditioner(const IoData &iodata, const mfem::Array<int> &dbc_marker
       MFEM_ABORT("Unexpected type for KspPreconditioner configuration!");
       break;
   }
+  if (iodata.solver.linear.mat_complex)
+  {
+    // The coarse level solve for complex-valued preconditioning uses the real equivalent
+    // block system, so requires a sparse direct solver.
+    MFEM_VERIFY(type == config::LinearSolverData::Type::SUPERLU ||
+                    type == config::LinearSolverData::Type::STRUMPACK ||
+                    type == config::LinearSolverData::Type::STRUMPACK_MP ||
+                    type == config::LinearSolverData::Type::MUMPS,
+                "Complex-valued preconditioning requires a sparse direct solver for the "
+                "coarse level!");
+    pc = std::make_unique<ComplexBlockSolver>(std::move(pc));
+  }
   if (iodata.solver.linear.mat_gmg)
   {
     // This will construct the multigrid hierarchy using pc as the coarse solver
@@ -116,7 +129,8 @@ ConfigurePreconditioner(const IoData &iodata, const mfem::Array<int> &dbc_marker
 
 void KspPreconditioner::Init(int n)
 {
-  // Set up temporary vector storage.
+  // Set up temporary vector storage for the split real and imaginary parts. Without
+  // complex scalars, the preconditioner is applied directly to the PETSc storage.
 #if defined(PETSC_USE_COMPLEX)
   if (x_.Size() == 2 * n && y_.Size() == 2 * n)
   {
@@ -124,13 +138,6 @@ void KspPreconditioner::Init(int n)
   }
   x_.SetSize(2 * n);
   y_.SetSize(2 * n);
-#else
-  if (x_.Size() == n && y_.Size() == n)
-  {
-    return;
-  }
-  x_.SetSize(n);
-  y_.SetSize(n);
 #endif
 }
 
@@ -176,10 +183,12 @@ void KspPreconditioner::Mult(const petsc::PetscParVector &x, petsc::PetscParVect
   pc_->ArrayMult(X, Y);
   y.SetFromVectors(yr_, yi_);
 #else
-  // y_ = 0.0;
-  x.GetToVector(x_);
-  pc_->Mult(x_, y_);
-  y.SetFromVector(y_);
+  mfem::Vector xv, yv;
+  x.GetVectorRead(xv);
+  y.GetVector(yv);
+  pc_->Mult(xv, yv);
+  y.RestoreVector(yv);
+  x.RestoreVectorRead(xv);
 #endif
 }
 
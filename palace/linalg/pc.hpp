@@ -30,7 +30,7 @@ private:
   // The actual preconditioner solver.
   std::unique_ptr<mfem::Solver> pc_;
 
-  // Temporary vectors for preconditioner application.
+  // Temporary vectors for preconditioner application with complex scalars.
   mutable mfem::Vector x_, y_;
 
   // Helper function for setup.
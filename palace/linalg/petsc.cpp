@@ -6,7 +6,7 @@
 #include <petsc.h>
 #include <petscblaslapack.h>
 #include <general/forall.hpp>
-// #include "linalg/hypre.hpp"
+#include "linalg/hypre.hpp"
 #include "linalg/slepc.hpp"
 #include "utils/communication.hpp"
 
@@ -18,6 +18,9 @@ static PetscErrorCode __mat_shell_apply_hermitian_transpose(Mat, Vec, Vec);
 static PetscErrorCode __mat_shell_apply_add(Mat, Vec, Vec);
 static PetscErrorCode __mat_shell_apply_transpose_add(Mat, Vec, Vec);
 static PetscErrorCode __mat_shell_apply_hermitian_transpose_add(Mat, Vec, Vec);
+static PetscErrorCode __mat_shell_apply_internal(Mat, Vec, Vec, bool);
+static PetscErrorCode __mat_shell_apply_transpose_internal(Mat, Vec, Vec, bool);
+static PetscErrorCode __mat_shell_apply_hermitian_transpose_internal(Mat, Vec, Vec, bool);
 #if defined(PETSC_USE_COMPLEX)
 static PetscErrorCode __mat_shell_apply(Mat, const mfem::Vector &, Vec);
 static PetscErrorCode __mat_shell_apply_transpose(Mat, const mfem::Vector &, Vec);
@@ -311,6 +314,30 @@ void PetscParVector::ResetArray()
   PalacePetscCall(VecResetArray(x));
 }
 
+#if !defined(PETSC_USE_COMPLEX)
+void PetscParVector::GetVector(mfem::Vector &v)
+{
+  v.SetDataAndSize(GetArray(), GetSize());
+}
+
+void PetscParVector::GetVectorRead(mfem::Vector &v) const
+{
+  v.SetDataAndSize(const_cast<PetscScalar *>(GetArrayRead()), GetSize());
+}
+
+void PetscParVector::RestoreVector(mfem::Vector &v)
+{
+  RestoreArray(v.GetData());
+  v.Destroy();
+}
+
+void PetscParVector::RestoreVectorRead(mfem::Vector &v) const
+{
+  RestoreArrayRead(v.GetData());
+  v.Destroy();
+}
+#endif
+
 PetscInt PetscParVector::GetSize() const
 {
   PetscInt n;
@@ -1120,6 +1147,22 @@ PetscShellMatrix::PetscShellMatrix(MPI_Comm comm, std::unique_ptr<mfem::Operator
   PalacePetscCall(MatCreateShell(comm, m, n, PETSC_DECIDE, PETSC_DECIDE, (void *)ctx, &A));
   __mat_shell_init(A);
 }
+
+PetscShellMatrix::PetscShellMatrix(MPI_Comm comm,
+                                   std::unique_ptr<hypre::HypreParMatrixSum> &&B)
+{
+  MFEM_VERIFY(B, "Cannot construct PETSc shell from an empty matrix!");
+  PetscInt m = (PetscInt)B->Height();
+  PetscInt n = (PetscInt)B->Width();
+
+  PetscMatShellCtx *ctx = new PetscMatShellCtx;
+  ctx->Ac = std::move(B);
+  ctx->x.SetSize(2 * n);
+  ctx->y.SetSize(2 * m);
+
+  PalacePetscCall(MatCreateShell(comm, m, n, PETSC_DECIDE, PETSC_DECIDE, (void *)ctx, &A));
+  __mat_shell_init(A);
+}
 #endif
 
 PetscMatShellCtx *PetscShellMatrix::GetContext() const
@@ -1284,6 +1327,8 @@ void PetscShellMatrix::PrintImag(const char *fname) const
 #if defined(PETSC_USE_COMPLEX)
 bool PetscShellMatrix::HasReal() const
 {
+  // The real and imaginary parts of a sum on a shared sparsity pattern are not available
+  // as separate operators.
   PetscMatShellCtx *ctx = GetContext();
   return (ctx->Ar != nullptr);
 }
@@ -1304,6 +1349,8 @@ PetscShellMatrix::GetOperator() const
 {
   PetscMatShellCtx *ctx = GetContext();
 #if defined(PETSC_USE_COMPLEX)
+  MFEM_VERIFY(!ctx->Ac, "Invalid use of GetOperator for a shell matrix without separate "
+                        "real and imaginary parts!");
   if (struc == ExtractStructure::REAL)
   {
     MFEM_VERIFY(ctx->Ar, "Invalid use of GetOperator, no real matrix component defined!");
@@ -1617,6 +1664,126 @@ PetscReal PetscDenseMatrix::OrthonormalizeColumnInternal(
   return norm;
 }
 
+void PetscDenseMatrix::OrthonormalizeColumns(PetscInt j, PetscInt n)
+{
+  OrthonormalizeColumnsInternal(j, n, nullptr);
+}
+
+void PetscDenseMatrix::OrthonormalizeColumns(PetscInt j, PetscInt n,
+                                             const PetscParMatrix &B)
+{
+  OrthonormalizeColumnsInternal(j, n, &B);
+}
+
+void PetscDenseMatrix::OrthonormalizeColumnsInternal(PetscInt j, PetscInt n,
+                                                     const PetscParMatrix *B)
+{
+  MFEM_VERIFY(j >= 0 && n >= 0 && j + n <= GetGlobalNumCols(),
+              "Column index out of range!");
+  if (n == 0)
+  {
+    return;
+  }
+  PetscInt m = GetNumRows(), lda;
+  PetscBLASInt bm, bn, bj, ldaA, info;
+  PetscScalar One = 1.0, Zero = 0.0, MinusOne = -1.0;
+  PetscBLASIntCast(m, &bm);
+  PetscBLASIntCast(n, &bn);
+  PetscBLASIntCast(j, &bj);
+  PalacePetscCall(MatDenseGetLDA(A, &lda));
+  PetscBLASIntCast(lda, &ldaA);
+
+  // Workspace for the products of B with the block W, the projection coefficients onto
+  // the preceding columns Q, and the Gram matrix of the block.
+  std::vector<PetscScalar> BW((B) ? lda * n : 0), H(j * n), G(n * n);
+  PetscScalar *pA = GetArray();
+  PetscScalar *pW = pA + j * lda;
+  auto ApplyB = [&]() -> const PetscScalar *
+  {
+    if (!B)
+    {
+      return pW;
+    }
+    for (PetscInt k = 0; k < n; k++)
+    {
+      PetscParVector w(GetComm(), m, PETSC_DECIDE, pW + k * lda);
+      PetscParVector Bw(GetComm(), m, PETSC_DECIDE, BW.data() + k * lda);
+      B->Mult(w, Bw);
+    }
+    return BW.data();
+  };
+
+  // Project out the preceding columns with two passes of block classical Gram-Schmidt:
+  // H = Qᴴ B W, W = W - Q H.
+  if (j > 0)
+  {
+    for (int l = 0; l < 2; l++)
+    {
+      const PetscScalar *pBW = ApplyB();
+      BLASgemm_("C", "N", &bj, &bn, &bm, &One, pA, &ldaA, pBW, &ldaA, &Zero, H.data(),
+                &bj);
+      MPI_Allreduce(MPI_IN_PLACE, H.data(), j * n, MPIU_SCALAR, MPIU_SUM, GetComm());
+      BLASgemm_("N", "N", &bm, &bn, &bj, &MinusOne, pA, &ldaA, H.data(), &bj, &One, pW,
+                &ldaA);
+    }
+  }
+
+  // Orthonormalize the block with two passes of Cholesky QR: G = Wᴴ B W = Rᴴ R,
+  // W = W R⁻¹. The Gram matrix is identical on all processes, so the factorization
+  // succeeds or fails consistently. A first pass which leaves the block far from
+  // orthonormal indicates a numerically rank deficient block.
+  bool success = true;
+  for (int l = 0; l < 2; l++)
+  {
+    const PetscScalar *pBW = ApplyB();
+    BLASgemm_("C", "N", &bn, &bn, &bm, &One, pW, &ldaA, pBW, &ldaA, &Zero, G.data(), &bn);
+    MPI_Allreduce(MPI_IN_PLACE, G.data(), n * n, MPIU_SCALAR, MPIU_SUM, GetComm());
+    if (l > 0)
+    {
+      for (PetscInt k = 0; k < n * n; k++)
+      {
+        if (PetscAbsScalar(G[k] - ((k % (n + 1) == 0) ? 1.0 : 0.0)) > 0.5)
+        {
+          success = false;
+        }
+      }
+      if (!success)
+      {
+        break;
+      }
+    }
+    LAPACKpotrf_("U", &bn, G.data(), &bn, &info);
+    if (info != 0)
+    {
+      success = false;
+      break;
+    }
+    BLAStrsm_("R", "U", "N", "N", &bm, &bn, &One, G.data(), &bn, pW, &ldaA);
+  }
+  RestoreArray(pA);
+
+  if (!success)
+  {
+    // The block spans the same space as on input, so orthonormalize it column by column.
+    bool mgs = false, cgs2 = true;
+    if (B)
+    {
+      PetscParVector Bv(*B);
+      for (PetscInt k = j; k < j + n; k++)
+      {
+        OrthonormalizeColumn(k, mgs, cgs2, *B, Bv);
+      }
+    }
+    else
+    {
+      for (PetscInt k = j; k < j + n; k++)
+      {
+        OrthonormalizeColumn(k, mgs, cgs2);
+      }
+    }
+  }
+}
+
 void PetscDenseMatrix::MatMult(const PetscDenseMatrix &X, PetscDenseMatrix &Y) const
 {
   MFEM_VERIFY(X.GetNumRows() == GetNumCols() && Y.GetNumRows() == GetNumRows(),
@@ -1770,7 +1937,7 @@ PetscErrorCode __mat_shell_destroy(Mat A)
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode __mat_shell_apply_add(Mat A, Vec x, Vec y)
+PetscErrorCode __mat_shell_apply_internal(Mat A, Vec x, Vec y, bool add)
 {
   palace::petsc::PetscMatShellCtx *ctx;
   palace::petsc::PetscParVector xx(x, true), yy(y, true);
@@ -1786,35 +1953,67 @@ PetscErrorCode __mat_shell_apply_add(Mat A, Vec x, Vec y)
     yr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
     yi.MakeRef(ctx->y, ctx->y.Size() / 2, ctx->y.Size() / 2);
     xx.GetToVectors(xr, xi);
-    if (ctx->Ar)
+    if (ctx->Ac)
     {
-      ctx->Ar->Mult(xr, yr);
-      ctx->Ar->Mult(xi, yi);
+      mfem::Array<const mfem::Vector *> X(2);
+      mfem::Array<mfem::Vector *> Y(2);
+      X[0] = &xr;
+      X[1] = &xi;
+      Y[0] = &yr;
+      Y[1] = &yi;
+      ctx->Ac->ArrayMult(X, Y);
     }
     else
     {
-      yr = 0.0;
-      yi = 0.0;
+      if (ctx->Ar)
+      {
+        ctx->Ar->Mult(xr, yr);
+        ctx->Ar->Mult(xi, yi);
+      }
+      else
+      {
+        yr = 0.0;
+        yi = 0.0;
+      }
+      if (ctx->Ai)
+      {
+        ctx->Ai->AddMult(xi, yr, -1.0);
+        ctx->Ai->AddMult(xr, yi, 1.0);
+      }
     }
-    if (ctx->Ai)
+    if (add)
     {
-      ctx->Ai->AddMult(xi, yr, -1.0);
-      ctx->Ai->AddMult(xr, yi, 1.0);
+      yy.AddFromVectors(yr, yi);
+    }
+    else
+    {
+      yy.SetFromVectors(yr, yi);
     }
-    yy.AddFromVectors(yr, yi);
   }
 #else
   {
-    xx.GetToVector(ctx->x);
-    if (ctx->Ar)
+    // Operate directly on the PETSc storage.
+    mfem::Vector xv, yv;
+    xx.GetVectorRead(xv);
+    yy.GetVector(yv);
+    if (!ctx->Ar)
     {
-      ctx->Ar->Mult(ctx->x, ctx->y);
+      if (!add)
+      {
+        yv = 0.0;
+      }
+    }
+    else if (add)
+    {
+      ctx->Ar->Mult(xv, ctx->y);
+      yv += ctx->y;
     }
     else
     {
-      ctx->y = 0.0;
+      ctx->Ar->Mult(xv, yv);
     }
-    yy.AddFromVector(ctx->y);
+    yy.RestoreVector(yv);
+    xx.RestoreVectorRead(xv);
   }
 #endif
   PetscFunctionReturn(0);
@@ -1822,11 +2021,15 @@ PetscErrorCode __mat_shell_apply_add(Mat A, Vec x, Vec y)
 
 PetscErrorCode __mat_shell_apply(Mat A, Vec x, Vec y)
 {
-  PetscCall(VecZeroEntries(y));
-  return __mat_shell_apply_add(A, x, y);
+  return __mat_shell_apply_internal(A, x, y, false);
 }
 
-PetscErrorCode __mat_shell_apply_transpose_add(Mat A, Vec x, Vec y)
+PetscErrorCode __mat_shell_apply_add(Mat A, Vec x, Vec y)
+{
+  return __mat_shell_apply_internal(A, x, y, true);
+}
+
+PetscErrorCode __mat_shell_apply_transpose_internal(Mat A, Vec x, Vec y, bool add)
 {
   palace::petsc::PetscMatShellCtx *ctx;
   palace::petsc::PetscParVector xx(x, true), yy(y, true);
@@ -1838,7 +2041,7 @@ PetscErrorCode __mat_shell_apply_transpose_add(Mat A, Vec x, Vec y)
   PetscCall(MatIsSymmetricKnown(A, &flg, &sym));
   if (flg == PETSC_TRUE && sym == PETSC_TRUE)
   {
-    PetscCall(__mat_shell_apply_add(A, x, y));
+    PetscCall(__mat_shell_apply_internal(A, x, y, add));
     PetscFunctionReturn(0);
   }
 #if defined(PETSC_USE_COMPLEX)
@@ -1849,35 +2052,67 @@ PetscErrorCode __mat_shell_apply_transpose_add(Mat A, Vec x, Vec y)
     yr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
     yi.MakeRef(ctx->x, ctx->x.Size() / 2, ctx->x.Size() / 2);
     xx.GetToVectors(xr, xi);
-    if (ctx->Ar)
+    if (ctx->Ac)
     {
-      ctx->Ar->MultTranspose(xr, yr);
-      ctx->Ar->MultTranspose(xi, yi);
+      mfem::Array<const mfem::Vector *> X(2);
+      mfem::Array<mfem::Vector *> Y(2);
+      X[0] = &xr;
+      X[1] = &xi;
+      Y[0] = &yr;
+      Y[1] = &yi;
+      ctx->Ac->ArrayMultTranspose(X, Y);
     }
     else
     {
-      yr = 0.0;
-      yi = 0.0;
+      if (ctx->Ar)
+      {
+        ctx->Ar->MultTranspose(xr, yr);
+        ctx->Ar->MultTranspose(xi, yi);
+      }
+      else
+      {
+        yr = 0.0;
+        yi = 0.0;
+      }
+      if (ctx->Ai)
+      {
+        ctx->Ai->AddMultTranspose(xi, yr, -1.0);
+        ctx->Ai->AddMultTranspose(xr, yi, 1.0);
+      }
     }
-    if (ctx->Ai)
+    if (add)
+    {
+      yy.AddFromVectors(yr, yi);
+    }
+    else
     {
-      ctx->Ai->AddMultTranspose(xi, yr, -1.0);
-      ctx->Ai->AddMultTranspose(xr, yi, 1.0);
+      yy.SetFromVectors(yr, yi);
     }
-    yy.AddFromVectors(yr, yi);
   }
 #else
   {
-    xx.GetToVector(ctx->y);
-    if (ctx->Ar)
+    // Operate directly on the PETSc storage.
+    mfem::Vector xv, yv;
+    xx.GetVectorRead(xv);
+    yy.GetVector(yv);
+    if (!ctx->Ar)
     {
-      ctx->Ar->MultTranspose(ctx->y, ctx->x);
+      if (!add)
+      {
+        yv = 0.0;
+      }
+    }
+    else if (add)
+    {
+      ctx->Ar->MultTranspose(xv, ctx->x);
+      yv += ctx->x;
     }
     else
     {
-      ctx->x = 0.0;
+      ctx->Ar->MultTranspose(xv, yv);
     }
-    yy.AddFromVector(ctx->x);
+    yy.RestoreVector(yv);
+    xx.RestoreVectorRead(xv);
   }
 #endif
   PetscFunctionReturn(0);
@@ -1885,11 +2120,16 @@ PetscErrorCode __mat_shell_apply_transpose_add(Mat A, Vec x, Vec y)
 
 PetscErrorCode __mat_shell_apply_transpose(Mat A, Vec x, Vec y)
 {
-  PetscCall(VecZeroEntries(y));
-  return __mat_shell_apply_transpose_add(A, x, y);
+  return __mat_shell_apply_transpose_internal(A, x, y, false);
 }
 
-PetscErrorCode __mat_shell_apply_hermitian_transpose_add(Mat A, Vec x, Vec y)
+PetscErrorCode __mat_shell_apply_transpose_add(Mat A, Vec x, Vec y)
+{
+  return __mat_shell_apply_transpose_internal(A, x, y, true);
+}
+
+PetscErrorCode __mat_shell_apply_hermitian_transpose_internal(Mat A, Vec x, Vec y,
+                                                              bool add)
 {
 #if defined(PETSC_USE_COMPLEX)
   palace::petsc::PetscMatShellCtx *ctx;
@@ -1902,15 +2142,50 @@ PetscErrorCode __mat_shell_apply_hermitian_transpose_add(Mat A, Vec x, Vec y)
   PetscCall(MatIsHermitianKnown(A, &flg, &sym));
   if (flg == PETSC_TRUE && sym == PETSC_TRUE)
   {
-    PetscCall(__mat_shell_apply_add(A, x, y));
+    PetscCall(__mat_shell_apply_internal(A, x, y, add));
     PetscFunctionReturn(0);
   }
-  if (!ctx->Ai)
+  if (!ctx->Ai && !ctx->Ac)
   {
-    PetscCall(__mat_shell_apply_transpose_add(A, x, y));
+    PetscCall(__mat_shell_apply_transpose_internal(A, x, y, add));
     PetscFunctionReturn(0);
   }
   PetscCall(MatIsSymmetricKnown(A, &flg, &sym));
+  if (ctx->Ac)
+  {
+    // Aᴴ x = conj(Aᵀ conj(x)).
+    mfem::Vector xr, xi, yr, yi;
+    xr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
+    xi.MakeRef(ctx->y, ctx->y.Size() / 2, ctx->y.Size() / 2);
+    yr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
+    yi.MakeRef(ctx->x, ctx->x.Size() / 2, ctx->x.Size() / 2);
+    xx.GetToVectors(xr, xi);
+    xi.Neg();
+    mfem::Array<const mfem::Vector *> X(2);
+    mfem::Array<mfem::Vector *> Y(2);
+    X[0] = &xr;
+    X[1] = &xi;
+    Y[0] = &yr;
+    Y[1] = &yi;
+    if (flg == PETSC_TRUE && sym == PETSC_TRUE)
+    {
+      ctx->Ac->ArrayMult(X, Y);
+    }
+    else
+    {
+      ctx->Ac->ArrayMultTranspose(X, Y);
+    }
+    yi.Neg();
+    if (add)
+    {
+      yy.AddFromVectors(yr, yi);
+    }
+    else
+    {
+      yy.SetFromVectors(yr, yi);
+    }
+    PetscFunctionReturn(0);
+  }
   {
     mfem::Vector xr, xi, yr, yi;
     xr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
@@ -1949,18 +2224,29 @@ PetscErrorCode __mat_shell_apply_hermitian_transpose_add(Mat A, Vec x, Vec y)
         ctx->Ai->AddMultTranspose(xr, yi, -1.0);
       }
     }
-    yy.AddFromVectors(yr, yi);
+    if (add)
+    {
+      yy.AddFromVectors(yr, yi);
+    }
+    else
+    {
+      yy.SetFromVectors(yr, yi);
+    }
   }
+  PetscFunctionReturn(0);
 #else
-  PetscCall(__mat_shell_apply_transpose_add(A, x, y));
+  return __mat_shell_apply_transpose_internal(A, x, y, add);
 #endif
-  PetscFunctionReturn(0);
 }
 
 PetscErrorCode __mat_shell_apply_hermitian_transpose(Mat A, Vec x, Vec y)
 {
-  PetscCall(VecZeroEntries(y));
-  return __mat_shell_apply_hermitian_transpose_add(A, x, y);
+  return __mat_shell_apply_hermitian_transpose_internal(A, x, y, false);
+}
+
+PetscErrorCode __mat_shell_apply_hermitian_transpose_add(Mat A, Vec x, Vec y)
+{
+  return __mat_shell_apply_hermitian_transpose_internal(A, x, y, true);
 }
 
 #if defined(PETSC_USE_COMPLEX)
@@ -1972,6 +2258,25 @@ PetscErrorCode __mat_shell_apply(Mat A, const mfem::Vector &x, Vec y)
 
   PetscCall(MatShellGetContext(A, (void **)&ctx));
   MFEM_VERIFY(ctx, "Invalid PETSc shell matrix context!");
+  if (ctx->Ac)
+  {
+    mfem::Vector xr, xi, yr, yi;
+    xr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
+    xi.MakeRef(ctx->x, ctx->x.Size() / 2, ctx->x.Size() / 2);
+    yr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
+    yi.MakeRef(ctx->y, ctx->y.Size() / 2, ctx->y.Size() / 2);
+    xr = x;
+    xi = 0.0;
+    mfem::Array<const mfem::Vector *> X(2);
+    mfem::Array<mfem::Vector *> Y(2);
+    X[0] = &xr;
+    X[1] = &xi;
+    Y[0] = &yr;
+    Y[1] = &yi;
+    ctx->Ac->ArrayMult(X, Y);
+    yy.SetFromVectors(yr, yi);
+    PetscFunctionReturn(0);
+  }
   {
     mfem::Vector yr, yi;
     yr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
@@ -2012,6 +2317,25 @@ PetscErrorCode __mat_shell_apply_transpose(Mat A, const mfem::Vector &x, Vec y)
     PetscCall(__mat_shell_apply(A, x, y));
     PetscFunctionReturn(0);
   }
+  if (ctx->Ac)
+  {
+    mfem::Vector xr, xi, yr, yi;
+    xr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
+    xi.MakeRef(ctx->y, ctx->y.Size() / 2, ctx->y.Size() / 2);
+    yr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
+    yi.MakeRef(ctx->x, ctx->x.Size() / 2, ctx->x.Size() / 2);
+    xr = x;
+    xi = 0.0;
+    mfem::Array<const mfem::Vector *> X(2);
+    mfem::Array<mfem::Vector *> Y(2);
+    X[0] = &xr;
+    X[1] = &xi;
+    Y[0] = &yr;
+    Y[1] = &yi;
+    ctx->Ac->ArrayMultTranspose(X, Y);
+    yy.SetFromVectors(yr, yi);
+    PetscFunctionReturn(0);
+  }
   {
     mfem::Vector yr, yi;
     yr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
@@ -2052,11 +2376,40 @@ PetscErrorCode __mat_shell_apply_hermitian_transpose(Mat A, const mfem::Vector &
     PetscCall(__mat_shell_apply(A, x, y));
     PetscFunctionReturn(0);
   }
-  if (!ctx->Ai)
+  if (!ctx->Ai && !ctx->Ac)
   {
     PetscCall(__mat_shell_apply_transpose(A, x, y));
     PetscFunctionReturn(0);
   }
+  if (ctx->Ac)
+  {
+    // Aᴴ x = conj(Aᵀ x) for real x.
+    mfem::Vector xr, xi, yr, yi;
+    xr.MakeRef(ctx->y, 0, ctx->y.Size() / 2);
+    xi.MakeRef(ctx->y, ctx->y.Size() / 2, ctx->y.Size() / 2);
+    yr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
+    yi.MakeRef(ctx->x, ctx->x.Size() / 2, ctx->x.Size() / 2);
+    xr = x;
+    xi = 0.0;
+    mfem::Array<const mfem::Vector *> X(2);
+    mfem::Array<mfem::Vector *> Y(2);
+    X[0] = &xr;
+    X[1] = &xi;
+    Y[0] = &yr;
+    Y[1] = &yi;
+    PetscCall(MatIsSymmetricKnown(A, &flg, &sym));
+    if (flg == PETSC_TRUE && sym == PETSC_TRUE)
+    {
+      ctx->Ac->ArrayMult(X, Y);
+    }
+    else
+    {
+      ctx->Ac->ArrayMultTranspose(X, Y);
+    }
+    yi.Neg();
+    yy.SetFromVectors(yr, yi);
+    PetscFunctionReturn(0);
+  }
   {
     mfem::Vector yr, yi;
     yr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
@@ -2108,6 +2461,8 @@ PetscErrorCode __mat_shell_get_diagonal(Mat A, Vec diag)
   PetscCall(MatShellGetContext(A, (void **)&ctx));
   MFEM_VERIFY(ctx, "Invalid PETSc shell matrix context!");
 #if defined(PETSC_USE_COMPLEX)
+  MFEM_VERIFY(!ctx->Ac, "MatGetDiagonal is not supported for shell matrices without "
+                        "separate real and imaginary parts!");
   {
     mfem::Vector xr, xi;
     xr.MakeRef(ctx->x, 0, ctx->x.Size() / 2);
@@ -2407,6 +2762,8 @@ PetscErrorCode __mat_shell_real_part(Mat Y)
   PetscCall(MatShellGetContext(Y, (void **)&ctx));
   MFEM_VERIFY(ctx, "Invalid PETSc shell matrix context!");
 #if defined(PETSC_USE_COMPLEX)
+  MFEM_VERIFY(!ctx->Ac, "MatRealPart is not supported for shell matrices without separate "
+                        "real and imaginary parts!");
   ctx->Ai.reset();
 #endif
   PetscFunctionReturn(0);
@@ -2420,6 +2777,8 @@ PetscErrorCode __mat_shell_imag_part(Mat Y)
   PetscCall(MatShellGetContext(Y, (void **)&ctx));
   MFEM_VERIFY(ctx, "Invalid PETSc shell matrix context!");
 #if defined(PETSC_USE_COMPLEX)
+  MFEM_VERIFY(!ctx->Ac, "MatImaginaryPart is not supported for shell matrices without "
+                        "separate real and imaginary parts!");
   ctx->Ar = std::move(ctx->Ai);
 #endif
   PetscFunctionReturn(0);
@@ -35,6 +35,13 @@ typedef struct _p_PC *PC;
 // PETSC_COMM_WORLD communicator.
 #define PalacePetscCall(...) PetscCallAbort(PETSC_COMM_WORLD, __VA_ARGS__)
 
+namespace palace::hypre
+{
+
+class HypreParMatrixSum;
+
+}  // namespace palace::hypre
+
 namespace palace::petsc
 {
 
@@ -135,6 +142,17 @@ public:
   void PlaceArray(const PetscScalar *data);
   void ResetArray();
 
+#if !defined(PETSC_USE_COMPLEX)
+  // Access the local data array of the vector as an MFEM Vector referencing the PETSc
+  // storage, without copying. The MFEM Vector must be restored before the PETSc vector is
+  // used again. Not available for complex scalars, where PETSc stores the real and
+  // imaginary parts interleaved.
+  void GetVector(mfem::Vector &v);
+  void GetVectorRead(mfem::Vector &v) const;
+  void RestoreVector(mfem::Vector &v);
+  void RestoreVectorRead(mfem::Vector &v) const;
+#endif
+
   // Copy entries of y to x.
   void Copy(const PetscParVector &y);
 
@@ -451,6 +469,10 @@ struct PetscMatShellCtx
   mfem::Vector x, y;
 #if defined(PETSC_USE_COMPLEX)
   std::unique_ptr<mfem::Operator> Ai;
+
+  // Complex-valued operator acting on (real, imaginary) pairs of vectors with ArrayMult,
+  // used in place of the separate real and imaginary parts.
+  std::unique_ptr<mfem::Operator> Ac;
 #endif
 };
 
@@ -470,6 +492,11 @@ public:
 #if defined(PETSC_USE_COMPLEX)
   PetscShellMatrix(MPI_Comm comm, std::unique_ptr<mfem::Operator> &&Br,
                    std::unique_ptr<mfem::Operator> &&Bi);
+
+  // Create a PETSc shell matrix wrapping a weighted sum of matrices on a shared sparsity
+  // pattern, which is applied to the real and imaginary parts of a vector in a single
+  // pass.
+  PetscShellMatrix(MPI_Comm comm, std::unique_ptr<hypre::HypreParMatrixSum> &&B);
 #endif
 
   // Returns the number of nonzeros.
@@ -501,7 +528,8 @@ public:
   void PrintImag(const char *fname) const override;
 #endif
 
-  // Test whether or not a shell matrix has a real or imaginary parts.
+  // Test whether or not a shell matrix has a real or imaginary parts. Both are false for a
+  // shell wrapping a HypreParMatrixSum, whose parts cannot be extracted.
 #if defined(PETSC_USE_COMPLEX)
   bool HasReal() const override;
   bool HasImag() const override;
@@ -562,6 +590,10 @@ private:
           &VecDot,
       const std::function<PetscReal(PetscParVector &)> &Normalize);
 
+  // Helper method for block column orthonormalization, with an optional matrix B for the
+  // inner product.
+  void OrthonormalizeColumnsInternal(PetscInt j, PetscInt n, const PetscParMatrix *B);
+
 public:
   // Create a parallel or sequential PETSc dense matrix. Option to specify an existing data
   // array.
@@ -601,6 +633,15 @@ public:
   PetscReal OrthonormalizeColumn(PetscInt j, bool mgs, bool cgs2, const PetscParMatrix &B,
                                  PetscParVector &Bv);
 
+  // Orthonormalize the block of columns j, ..., j + n - 1 of the matrix against the
+  // preceding columns and each other, using block classical Gram-Schmidt with
+  // reorthogonalization (BCGS2) and Cholesky QR within the block. The projections are
+  // computed with dense matrix-matrix products and require a fixed number of global
+  // reductions independent of the block size. Falls back to column-wise classical
+  // Gram-Schmidt if the block is numerically rank deficient.
+  void OrthonormalizeColumns(PetscInt j, PetscInt n);
+  void OrthonormalizeColumns(PetscInt j, PetscInt n, const PetscParMatrix &B);
+
   // Dense matrix-matrix multiplication.
   void MatMult(const PetscDenseMatrix &X, PetscDenseMatrix &Y) const;
   void MatMultTranspose(const PetscDenseMatrix &X, PetscDenseMatrix &Y) const;
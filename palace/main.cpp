@@ -172,15 +172,30 @@ int main(int argc, char *argv[])
   }
 
   // Read the mesh from file, refine, partition, and distribute it. Then nondimensionalize
-  // it and the input parameters.
+  // it and the input parameters. Reading, partitioning, and refinement are skipped when
+  // loading the mesh from a cache created by a previous simulation.
   std::vector<std::unique_ptr<mfem::ParMesh>> mesh;
-  mesh.push_back(mesh::ReadMesh(world_comm, iodata, false, true, true, false, timer));
+  mesh::MeshCache cache(world_comm, iodata);
+  bool refined = cache.Load(world_comm, iodata, mesh, timer);
+  bool cached = !mesh.empty();
+  if (!cached)
+  {
+    mesh.push_back(mesh::ReadMesh(world_comm, iodata, true, true, false, timer));
+  }
   iodata.NondimensionalizeInputs(*mesh[0]);
-  mesh::RefineMesh(iodata, mesh);
+  if (!refined)
+  {
+    mesh::RefineMesh(iodata, mesh);
+  }
+  if (!cached)
+  {
+    cache.Save(iodata, mesh, timer);
+  }
+  mesh::PrintMeshInfo(iodata, mesh);
   timer.init_time += timer.Lap() - timer.io_time;
 
   // Run the problem driver.
-  solver->Solve(mesh, timer);
+  solver->SolveEstimateMarkRefine(mesh, timer);
   timer.Reduce(world_comm);
   timer.Print(world_comm);
   solver->SaveMetadata(timer);
@@ -0,0 +1,513 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "asyncdatacollection.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include "utils/communication.hpp"
+#include "utils/filesystem.hpp"
+
+namespace palace
+{
+
+namespace
+{
+
+double RoundMantissa(double val, int bits)
+{
+  // Round to nearest in single precision, keeping the given number of mantissa bits.
+  // Infinite and NaN values, and values outside of the single precision range, are
+  // unchanged. Values which would overflow when rounded up are truncated instead.
+  constexpr int float_bits = 23;
+  if (!std::isfinite(val) || std::abs(val) > std::numeric_limits<float>::max())
+  {
+    return val;
+  }
+  float f = static_cast<float>(val);
+  if (bits <= 0 || bits >= float_bits)
+  {
+    return f;
+  }
+  const int shift = float_bits - bits;
+  const std::uint32_t mask = (1u << shift) - 1u;
+  std::uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  const std::uint32_t r = (u + (1u << (shift - 1))) & ~mask;
+  u = ((r & 0x7f800000u) == 0x7f800000u) ? (u & ~mask) : r;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+std::unique_ptr<mfem::Mesh> GetOutputMesh(mfem::Mesh &mesh, const std::vector<int> &elems,
+                                          bool bdr)
+{
+  // Construct a local mesh of the given elements (or boundary elements). The vertices keep
+  // the order of the original mesh and each element keeps its vertex ordering, so the
+  // reference coordinates of a point are the same in the original element.
+  const int dim = bdr ? mesh.Dimension() - 1 : mesh.Dimension();
+  const int sdim = mesh.SpaceDimension();
+  auto GetElement = [&mesh, bdr](int e)
+  { return bdr ? mesh.GetBdrElement(e) : mesh.GetElement(e); };
+  auto GetTransformation = [&mesh, bdr](int e)
+  { return bdr ? mesh.GetBdrElementTransformation(e) : mesh.GetElementTransformation(e); };
+  std::vector<int> vertex_map(mesh.GetNV(), -1);
+  mfem::Array<int> verts;
+  for (const auto e : elems)
+  {
+    GetElement(e)->GetVertices(verts);
+    for (const auto v : verts)
+    {
+      vertex_map[v] = 0;
+    }
+  }
+  int nv = 0;
+  for (auto &v : vertex_map)
+  {
+    if (v >= 0)
+    {
+      v = nv++;
+    }
+  }
+  auto output_mesh =
+      std::make_unique<mfem::Mesh>(dim, nv, static_cast<int>(elems.size()), 0, sdim);
+  for (int v = 0; v < mesh.GetNV(); v++)
+  {
+    if (vertex_map[v] >= 0)
+    {
+      output_mesh->AddVertex(mesh.GetVertex(v));
+    }
+  }
+  for (const auto e : elems)
+  {
+    const mfem::Element *el = GetElement(e);
+    el->GetVertices(verts);
+    for (auto &v : verts)
+    {
+      v = vertex_map[v];
+    }
+    mfem::Element *new_el = output_mesh->NewElement(el->GetGeometryType());
+    new_el->SetVertices(verts.GetData());
+    new_el->SetAttribute(el->GetAttribute());
+    output_mesh->AddElement(new_el);
+  }
+  output_mesh->FinalizeTopology(false);
+  output_mesh->Finalize(false, false);
+
+  // Curved meshes are interpolated at the nodes of the same order of finite element space.
+  if (const mfem::GridFunction *nodes = mesh.GetNodes())
+  {
+    const mfem::FiniteElementSpace &fespace = *nodes->FESpace();
+    const bool discont =
+        (dynamic_cast<const mfem::L2_FECollection *>(fespace.FEColl()) != nullptr);
+    output_mesh->SetCurvature(fespace.FEColl()->GetOrder(), discont, sdim,
+                              fespace.GetOrdering());
+    mfem::GridFunction &output_nodes = *output_mesh->GetNodes();
+    const mfem::FiniteElementSpace &output_fespace = *output_nodes.FESpace();
+    mfem::Array<int> vdofs;
+    mfem::DenseMatrix pmat;
+    for (int i = 0; i < output_mesh->GetNE(); i++)
+    {
+      const mfem::FiniteElement &fe = *output_fespace.GetFE(i);
+      output_fespace.GetElementVDofs(i, vdofs);
+      GetTransformation(elems[i])->Transform(fe.GetNodes(), pmat);
+      for (int d = 0; d < sdim; d++)
+      {
+        for (int j = 0; j < fe.GetDof(); j++)
+        {
+          output_nodes(vdofs[d * fe.GetDof() + j]) = pmat(d, j);
+        }
+      }
+    }
+  }
+  return output_mesh;
+}
+
+// Evaluation of fields on the output mesh: Coefficients are evaluated on the corresponding
+// element of the original mesh when the output is restricted, and values are rounded to
+// the given number of mantissa bits.
+class OutputTransform
+{
+private:
+  mfem::Mesh *mesh;
+  const std::vector<int> &elems;
+  const bool bdr;
+  const int bits;
+
+public:
+  OutputTransform(mfem::Mesh *mesh, const std::vector<int> &elems, bool bdr, int bits)
+    : mesh(mesh), elems(elems), bdr(bdr), bits(bits)
+  {
+  }
+
+  mfem::ElementTransformation &Map(mfem::ElementTransformation &T,
+                                   const mfem::IntegrationPoint &ip) const
+  {
+    if (!mesh)
+    {
+      return T;
+    }
+    mfem::ElementTransformation *T_orig =
+        bdr ? mesh->GetBdrElementTransformation(elems[T.ElementNo])
+            : mesh->GetElementTransformation(elems[T.ElementNo]);
+    T_orig->SetIntPoint(&ip);
+    return *T_orig;
+  }
+
+  double Round(double val) const { return (bits > 0) ? RoundMantissa(val, bits) : val; }
+};
+
+class OutputCoefficient : public mfem::Coefficient
+{
+private:
+  std::unique_ptr<mfem::Coefficient> gf_coeff;
+  mfem::Coefficient &coeff;
+  const OutputTransform transform;
+
+public:
+  OutputCoefficient(mfem::Coefficient &coeff, const OutputTransform &transform)
+    : coeff(coeff), transform(transform)
+  {
+  }
+  OutputCoefficient(mfem::GridFunction &gf, const OutputTransform &transform)
+    : gf_coeff(std::make_unique<mfem::GridFunctionCoefficient>(&gf)), coeff(*gf_coeff),
+      transform(transform)
+  {
+  }
+
+  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  {
+    return transform.Round(coeff.Eval(transform.Map(T, ip), ip));
+  }
+};
+
+class OutputVectorCoefficient : public mfem::VectorCoefficient
+{
+private:
+  std::unique_ptr<mfem::VectorCoefficient> gf_coeff;
+  mfem::VectorCoefficient &coeff;
+  const OutputTransform transform;
+
+public:
+  OutputVectorCoefficient(mfem::VectorCoefficient &coeff, const OutputTransform &transform)
+    : mfem::VectorCoefficient(coeff.GetVDim()), coeff(coeff), transform(transform)
+  {
+  }
+  OutputVectorCoefficient(mfem::GridFunction &gf, const OutputTransform &transform)
+    : mfem::VectorCoefficient(gf.VectorDim()),
+      gf_coeff(std::make_unique<mfem::VectorGridFunctionCoefficient>(&gf)),
+      coeff(*gf_coeff), transform(transform)
+  {
+  }
+
+  void Eval(mfem::Vector &V, mfem::ElementTransformation &T,
+            const mfem::IntegrationPoint &ip) override
+  {
+    coeff.Eval(V, transform.Map(T, ip), ip);
+    for (int i = 0; i < V.Size(); i++)
+    {
+      V(i) = transform.Round(V(i));
+    }
+  }
+};
+
+}  // namespace
+
+AsyncParaViewDataCollection::AsyncParaViewDataCollection(const std::string &name,
+                                                         mfem::ParMesh *mesh,
+                                                         int max_queue)
+  : mfem::ParaViewDataCollection(name, mesh), comm(mesh->GetComm()), max_queue(max_queue),
+    bdr(false), levels(1), parent_mesh(*mesh), mantissa_bits(0), done(false)
+{
+  MFEM_VERIFY(max_queue >= 0,
+              "Maximum number of queued output snapshots must be non-negative!");
+  if (max_queue > 0)
+  {
+    writer = std::thread(&AsyncParaViewDataCollection::WriteSnapshots, this);
+  }
+}
+
+AsyncParaViewDataCollection::~AsyncParaViewDataCollection()
+{
+  if (writer.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done = true;
+    }
+    cv.notify_all();
+    writer.join();
+  }
+}
+
+void AsyncParaViewDataCollection::SetBoundaryOutput(bool bdr_output)
+{
+  MFEM_VERIFY(!output_mesh, "Boundary output must be set before restricting the output!");
+  mfem::ParaViewDataCollection::SetBoundaryOutput(bdr_output);
+  bdr = bdr_output;
+}
+
+void AsyncParaViewDataCollection::SetLevelsOfDetail(int levels_of_detail)
+{
+  mfem::ParaViewDataCollection::SetLevelsOfDetail(levels_of_detail);
+  levels = levels_of_detail;
+}
+
+void AsyncParaViewDataCollection::SetOutputElements(const std::vector<int> &elems)
+{
+  // The output mesh of the selected elements is written as a domain mesh, also for
+  // boundary output.
+  MFEM_VERIFY(GetFieldMap().empty() && GetCoeffFieldMap().empty() &&
+                  GetVCoeffFieldMap().empty(),
+              "Output elements must be set before registering fields!");
+  MFEM_VERIFY(!output_mesh, "Output elements can only be set once!");
+  elements = elems;
+  output_mesh = GetOutputMesh(parent_mesh, elements, bdr);
+  mfem::ParaViewDataCollection::SetMesh(comm, output_mesh.get());
+  mfem::ParaViewDataCollection::SetBoundaryOutput(false);
+}
+
+void AsyncParaViewDataCollection::SetMantissaBits(int bits)
+{
+  MFEM_VERIFY(bits >= 0, "Number of mantissa bits for output must be non-negative!");
+  MFEM_VERIFY(GetFieldMap().empty() && GetCoeffFieldMap().empty() &&
+                  GetVCoeffFieldMap().empty(),
+              "Output precision must be set before registering fields!");
+  mantissa_bits = bits;
+}
+
+void AsyncParaViewDataCollection::RegisterOutputField(
+    const std::string &field_name, std::unique_ptr<mfem::Coefficient> &&coeff)
+{
+  mfem::ParaViewDataCollection::RegisterCoeffField(field_name, coeff.get());
+  output_coeffs[field_name] = std::move(coeff);
+}
+
+void AsyncParaViewDataCollection::RegisterOutputField(
+    const std::string &field_name, std::unique_ptr<mfem::VectorCoefficient> &&vcoeff)
+{
+  mfem::ParaViewDataCollection::RegisterVCoeffField(field_name, vcoeff.get());
+  output_vcoeffs[field_name] = std::move(vcoeff);
+}
+
+void AsyncParaViewDataCollection::RegisterField(const std::string &field_name,
+                                                mfem::GridFunction *gf)
+{
+  if (!output_mesh && mantissa_bits == 0)
+  {
+    mfem::ParaViewDataCollection::RegisterField(field_name, gf);
+    return;
+  }
+  const OutputTransform transform(output_mesh ? &parent_mesh : nullptr, elements, bdr,
+                                  mantissa_bits);
+  if (gf->VectorDim() == 1)
+  {
+    RegisterOutputField(field_name, std::make_unique<OutputCoefficient>(*gf, transform));
+  }
+  else
+  {
+    RegisterOutputField(field_name,
+                        std::make_unique<OutputVectorCoefficient>(*gf, transform));
+  }
+}
+
+void AsyncParaViewDataCollection::RegisterCoeffField(const std::string &field_name,
+                                                     mfem::Coefficient *coeff)
+{
+  if (!output_mesh && mantissa_bits == 0)
+  {
+    mfem::ParaViewDataCollection::RegisterCoeffField(field_name, coeff);
+    return;
+  }
+  const OutputTransform transform(output_mesh ? &parent_mesh : nullptr, elements, bdr,
+                                  mantissa_bits);
+  RegisterOutputField(field_name, std::make_unique<OutputCoefficient>(*coeff, transform));
+}
+
+void AsyncParaViewDataCollection::RegisterVCoeffField(const std::string &field_name,
+                                                      mfem::VectorCoefficient *vcoeff)
+{
+  if (!output_mesh && mantissa_bits == 0)
+  {
+    mfem::ParaViewDataCollection::RegisterVCoeffField(field_name, vcoeff);
+    return;
+  }
+  const OutputTransform transform(output_mesh ? &parent_mesh : nullptr, elements, bdr,
+                                  mantissa_bits);
+  RegisterOutputField(field_name,
+                      std::make_unique<OutputVectorCoefficient>(*vcoeff, transform));
+}
+
+void AsyncParaViewDataCollection::DeregisterField(const std::string &field_name)
+{
+  // Wrapped grid functions are registered as coefficients.
+  mfem::ParaViewDataCollection::DeregisterField(field_name);
+  DeregisterCoeffField(field_name);
+  DeregisterVCoeffField(field_name);
+}
+
+void AsyncParaViewDataCollection::DeregisterCoeffField(const std::string &field_name)
+{
+  mfem::ParaViewDataCollection::DeregisterCoeffField(field_name);
+  output_coeffs.erase(field_name);
+}
+
+void AsyncParaViewDataCollection::DeregisterVCoeffField(const std::string &field_name)
+{
+  mfem::ParaViewDataCollection::DeregisterVCoeffField(field_name);
+  output_vcoeffs.erase(field_name);
+}
+
+void AsyncParaViewDataCollection::Save()
+{
+  if (max_queue == 0)
+  {
+    mfem::ParaViewDataCollection::Save();
+    return;
+  }
+  MFEM_VERIFY(GetQFieldMap().empty(),
+              "QuadratureFunction output is not supported for asynchronous ParaView "
+              "output!");
+
+  // The directory for this cycle is created by the root process before any process queues
+  // files to be written in it.
+  const std::string col_path = GenerateCollectionPath();
+  const std::string vtu_path = GenerateVTUPath();
+  const std::string vtu_prefix = col_path + "/" + vtu_path + "/";
+  if (Mpi::Root(comm))
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(vtu_prefix, ec);
+    MFEM_VERIFY(!ec, "Error creating directory \"" << vtu_prefix << "\"!");
+  }
+  Mpi::Barrier(comm);
+
+  // Evaluate and encode the local part of the mesh and fields. The root process also writes
+  // the PVTU file pointing to the VTU files of all processes, and the updated PVD file
+  // listing all snapshots. This follows the file layout of ParaViewDataCollection::Save.
+  Snapshot snapshot;
+  {
+    std::ostringstream fo;
+    fo.precision(precision);
+    SaveDataVTU(fo, levels);
+    snapshot.emplace_back(vtu_prefix + GenerateVTUFileName("proc", myid), fo.str());
+  }
+  if (Mpi::Root(comm))
+  {
+    auto WritePDataArray = [this](std::ostream &fo, const std::string &name, int vdim)
+    {
+      fo << "<PDataArray type=\"" << GetDataTypeString() << "\" Name=\"" << name
+         << "\" NumberOfComponents=\"" << vdim << "\" "
+         << "format=\"" << GetDataFormatString() << "\" />\n";
+    };
+    std::ostringstream fo;
+    WritePVTUHeader(fo);
+    fo << "<PPointData>\n";
+    for (const auto &[name, gf] : GetFieldMap())
+    {
+      WritePDataArray(fo, name, gf->VectorDim());
+    }
+    for (const auto &[name, coeff] : GetCoeffFieldMap())
+    {
+      WritePDataArray(fo, name, 1);
+    }
+    for (const auto &[name, vcoeff] : GetVCoeffFieldMap())
+    {
+      WritePDataArray(fo, name, vcoeff->GetVDim());
+    }
+    fo << "</PPointData>\n";
+    fo << "<PCellData>\n";
+    fo << "\t<PDataArray type=\"Int32\" Name=\"attribute\" NumberOfComponents=\"1\""
+       << " format=\"" << GetDataFormatString() << "\"/>\n";
+    fo << "</PCellData>\n";
+    WritePVTUFooter(fo, "proc");
+    snapshot.emplace_back(vtu_prefix + GeneratePVTUFileName("data"), fo.str());
+
+    std::ostringstream entry;
+    entry << "<DataSet timestep=\"" << time << "\" group=\"\" part=\"0\" file=\""
+          << vtu_path + "/" + GeneratePVTUFileName("data") << "\" name=\"" << vtu_path
+          << "\"/>\n";
+    pvd_entries += entry.str();
+    std::ostringstream pvd;
+    pvd << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\""
+        << mfem::VTKByteOrder() << "\">\n"
+        << "<Collection>\n"
+        << pvd_entries << "</Collection>\n"
+        << "</VTKFile>\n";
+    snapshot.emplace_back(col_path + "/" + GetCollectionName() + ".pvd", pvd.str());
+  }
+
+  // Write the snapshot now for synchronous output, or otherwise queue it, waiting if the
+  // maximum number of snapshots are already queued.
+  if (max_queue == 0)
+  {
+    const std::string msg = WriteSnapshot(snapshot);
+    MFEM_VERIFY(msg.empty(), msg);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [this]
+          { return static_cast<int>(queue.size()) < max_queue || !error.empty(); });
+  MFEM_VERIFY(error.empty(), error);
+  queue.push_back(std::move(snapshot));
+  lock.unlock();
+  cv.notify_all();
+}
+
+void AsyncParaViewDataCollection::Flush()
+{
+  if (max_queue == 0)
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [this] { return queue.empty(); });
+  MFEM_VERIFY(error.empty(), error);
+}
+
+std::string AsyncParaViewDataCollection::WriteSnapshot(const Snapshot &snapshot)
+{
+  std::string msg;
+  for (const auto &[path, data] : snapshot)
+  {
+    std::ofstream fo(path, std::ios::binary);
+    fo.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!fo.good() && msg.empty())
+    {
+      msg = "Error writing ParaView output file \"" + path + "\"!";
+    }
+  }
+  return msg;
+}
+
+void AsyncParaViewDataCollection::WriteSnapshots()
+{
+  // Write the queued snapshots in order. The queue is only locked to access its front,
+  // since references to the elements of a std::deque remain valid when pushing to its back.
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    cv.wait(lock, [this] { return !queue.empty() || done; });
+    if (queue.empty())
+    {
+      break;
+    }
+    const Snapshot &snapshot = queue.front();
+    lock.unlock();
+    const std::string msg = WriteSnapshot(snapshot);
+    lock.lock();
+    if (!msg.empty() && error.empty())
+    {
+      error = msg;
+    }
+    queue.pop_front();
+    cv.notify_all();
+  }
+}
+
+}  // namespace palace
@@ -0,0 +1,117 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PALACE_ASYNC_DATA_COLLECTION_HPP
+#define PALACE_ASYNC_DATA_COLLECTION_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <mfem.hpp>
+
+namespace palace
+{
+
+//
+// A ParaView data collection which can write its output files asynchronously. On each
+// save, the fields are evaluated and encoded into memory buffers on the calling thread and
+// the buffers are queued for a background thread which writes them to disk. The caller
+// only blocks for the evaluation, or when the maximum number of snapshots are already
+// queued. With a maximum of zero snapshots, output is written synchronously. The output
+// can also be restricted to a subset of the mesh elements, and the field values can be
+// rounded to reduced precision to improve compression. In these cases the registered
+// fields are wrapped by coefficients which are evaluated on the output mesh.
+//
+class AsyncParaViewDataCollection : public mfem::ParaViewDataCollection
+{
+private:
+  // Files written for a single snapshot, as pairs of file path and contents.
+  using Snapshot = std::vector<std::pair<std::string, std::string>>;
+
+  // Communicator for the mesh and maximum number of queued snapshots.
+  MPI_Comm comm;
+  const int max_queue;
+
+  // Output options (private in the base class).
+  bool bdr;
+  int levels;
+
+  // Mesh on which the fields are defined, and the local mesh of the elements (or boundary
+  // elements for boundary output) to write when the output is restricted to them.
+  mfem::ParMesh &parent_mesh;
+  std::vector<int> elements;
+  std::unique_ptr<mfem::Mesh> output_mesh;
+
+  // Number of single precision mantissa bits to keep for field values (zero for all), and
+  // the coefficients wrapping the registered fields for restricted or rounded output.
+  int mantissa_bits;
+  std::map<std::string, std::unique_ptr<mfem::Coefficient>> output_coeffs;
+  std::map<std::string, std::unique_ptr<mfem::VectorCoefficient>> output_vcoeffs;
+
+  // Entries of the PVD file listing all saved snapshots (only used on the root process).
+  std::string pvd_entries;
+
+  // Background writer thread and the queue of snapshots to write. The snapshot at the front
+  // of the queue is the one being written, and is removed once it is on disk.
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Snapshot> queue;
+  std::string error;
+  bool done;
+
+  // Register the wrapped field for restricted or rounded output.
+  void RegisterOutputField(const std::string &field_name,
+                           std::unique_ptr<mfem::Coefficient> &&coeff);
+  void RegisterOutputField(const std::string &field_name,
+                           std::unique_ptr<mfem::VectorCoefficient> &&vcoeff);
+
+  // Write the files of a snapshot to disk, returning an error message on failure.
+  static std::string WriteSnapshot(const Snapshot &snapshot);
+  void WriteSnapshots();
+
+public:
+  AsyncParaViewDataCollection(const std::string &name, mfem::ParMesh *mesh,
+                              int max_queue = 0);
+  ~AsyncParaViewDataCollection() override;
+
+  // Set the output options, which shadow those of the base class in order to track their
+  // values.
+  void SetBoundaryOutput(bool bdr_output);
+  void SetLevelsOfDetail(int levels_of_detail);
+
+  // Restrict the output to the given local elements, or boundary elements for boundary
+  // output. This must be called before registering any fields.
+  void SetOutputElements(const std::vector<int> &elems);
+
+  // Round the written field values to the given number of mantissa bits in single
+  // precision, for output which is only used for visualization. Zero keeps all bits. This
+  // must be called before registering any fields.
+  void SetMantissaBits(int bits);
+
+  // Register and deregister fields, which are wrapped for restricted or rounded output.
+  void RegisterField(const std::string &field_name, mfem::GridFunction *gf) override;
+  void RegisterCoeffField(const std::string &field_name, mfem::Coefficient *coeff) override;
+  void RegisterVCoeffField(const std::string &field_name,
+                           mfem::VectorCoefficient *vcoeff) override;
+  void DeregisterField(const std::string &field_name) override;
+  void DeregisterCoeffField(const std::string &field_name) override;
+  void DeregisterVCoeffField(const std::string &field_name) override;
+
+  // Save the registered fields for the current cycle and time, queuing the output files
+  // for writing when asynchronous.
+  void Save() override;
+
+  // Block until all queued snapshots have been written to disk.
+  void Flush();
+};
+
+}  // namespace palace
+
+#endif  // PALACE_ASYNC_DATA_COLLECTION_HPP
@@ -118,6 +118,10 @@ void ProblemData::SetUp(json &config)
               "Invalid value for config[\"Problem\"][\"Type\"] in configuration file!");
   verbose = problem->value("Verbose", verbose);
   output = problem->value("Output", output);
+  async_output = problem->value("AsyncOutput", async_output);
+  MFEM_VERIFY(async_output >= 0,
+              "Number of queued asynchronous output snapshots must be non-negative!");
+  field_output.SetUp(*problem);
 
   // Check for provided solver configuration data (not required for electrostatics or
   // magnetostatics since defaults can be used for every option).
@@ -159,6 +163,8 @@ void ProblemData::SetUp(json &config)
   problem->erase("Type");
   problem->erase("Verbose");
   problem->erase("Output");
+  problem->erase("AsyncOutput");
+  problem->erase("FieldOutput");
   MFEM_VERIFY(problem->empty(),
               "Found an unsupported configuration file keyword under \"Problem\"!\n"
                   << problem->dump(2));
@@ -167,6 +173,92 @@ void ProblemData::SetUp(json &config)
   // std::cout << "Type: " << type << '\n';
   // std::cout << "Verbose: " << verbose << '\n';
   // std::cout << "Output: " << output << '\n';
+  // std::cout << "AsyncOutput: " << async_output << '\n';
+}
+
+// Helper for converting string keys to enum for FieldOutputData::DataFormat.
+NLOHMANN_JSON_SERIALIZE_ENUM(FieldOutputData::DataFormat,
+                             {{FieldOutputData::DataFormat::INVALID, nullptr},
+                              {FieldOutputData::DataFormat::FLOAT64, "Float64"},
+                              {FieldOutputData::DataFormat::FLOAT32, "Float32"},
+                              {FieldOutputData::DataFormat::FLOAT16, "Float16"}})
+
+void FieldOutputData::SetUp(json &problem)
+{
+  auto output = problem.find("FieldOutput");
+  if (output == problem.end())
+  {
+    return;
+  }
+  fields = output->value("Fields", fields);
+  for (const auto &field : fields)
+  {
+    const std::vector<std::string> valid = {"E", "B", "V", "A", "Qs", "Js", "Ue", "Um"};
+    MFEM_VERIFY(std::find(valid.begin(), valid.end(), field) != valid.end(),
+                "Invalid value \"" << field
+                                   << "\" for config[\"Problem\"][\"FieldOutput\"]["
+                                      "\"Fields\"] in configuration file!");
+  }
+  attributes = output->value("Attributes", attributes);
+  bdr_attributes = output->value("BoundaryAttributes", bdr_attributes);
+  max_levels_of_detail = output->value("MaxLevelsOfDetail", max_levels_of_detail);
+  MFEM_VERIFY(max_levels_of_detail >= 0,
+              "Maximum levels of detail for field output must be non-negative!");
+  format = output->value("DataFormat", format);
+  MFEM_VERIFY(format != FieldOutputData::DataFormat::INVALID,
+              "Invalid value for config[\"Problem\"][\"FieldOutput\"][\"DataFormat\"] in "
+              "configuration file!");
+  auto boxes = output->find("Boxes");
+  if (boxes != output->end())
+  {
+    MFEM_VERIFY(boxes->is_array(),
+                "config[\"Problem\"][\"FieldOutput\"][\"Boxes\"] should specify an array "
+                "in the configuration file!");
+    for (auto it = boxes->begin(); it != boxes->end(); ++it)
+    {
+      for (const auto *key : {"XLimits", "YLimits", "ZLimits"})
+      {
+        auto lim = it->find(key);
+        MFEM_VERIFY(lim != it->end() && lim->is_array(),
+                    "Missing \"Boxes\" field output region \"X/Y/ZLimits\" in "
+                    "configuration file!");
+        std::vector<double> b = lim->get<std::vector<double>>();
+        MFEM_VERIFY(b.size() == 2,
+                    "config[\"Problem\"][\"FieldOutput\"][\"Boxes\"][\"X/Y/ZLimits\"] "
+                    "should specify an array of length 2 in the configuration file!");
+        if (b[1] < b[0])
+        {
+          std::swap(b[0], b[1]);
+        }
+        bbmin.push_back(b[0]);
+        bbmax.push_back(b[1]);
+        it->erase(key);
+      }
+      MFEM_VERIFY(it->empty(), "Found an unsupported configuration file keyword under "
+                               "config[\"Problem\"][\"FieldOutput\"][\"Boxes\"]!\n"
+                                   << it->dump(2));
+    }
+  }
+
+  // Cleanup
+  output->erase("Fields");
+  output->erase("Attributes");
+  output->erase("BoundaryAttributes");
+  output->erase("Boxes");
+  output->erase("MaxLevelsOfDetail");
+  output->erase("DataFormat");
+  MFEM_VERIFY(output->empty(),
+              "Found an unsupported configuration file keyword under \"FieldOutput\"!\n"
+                  << output->dump(2));
+
+  // Debug
+  // std::cout << "Fields: " << fields << '\n';
+  // std::cout << "Attributes: " << attributes << '\n';
+  // std::cout << "BoundaryAttributes: " << bdr_attributes << '\n';
+  // std::cout << "BoxMin: " << bbmin << '\n';
+  // std::cout << "BoxMax: " << bbmax << '\n';
+  // std::cout << "MaxLevelsOfDetail: " << max_levels_of_detail << '\n';
+  // std::cout << "DataFormat: " << format << '\n';
 }
 
 void RefinementData::SetUp(json &model)
@@ -179,6 +271,15 @@ void RefinementData::SetUp(json &model)
   uniform_ref_levels = refinement->value("UniformLevels", uniform_ref_levels);
   MFEM_VERIFY(uniform_ref_levels >= 0,
               "Number of uniform mesh refinement levels must be non-negative!");
+  tol = refinement->value("Tol", tol);
+  max_it = refinement->value("MaxIts", max_it);
+  max_size = refinement->value("MaxSize", max_size);
+  update_fraction = refinement->value("UpdateFraction", update_fraction);
+  nonconformal = refinement->value("Nonconformal", nonconformal);
+  MFEM_VERIFY(max_it >= 0,
+              "Number of adaptive mesh refinement iterations must be non-negative!");
+  MFEM_VERIFY(update_fraction > 0.0 && update_fraction <= 1.0,
+              "Adaptive mesh refinement update fraction must be in the range (0, 1]!");
   auto boxes = refinement->find("Boxes");
   if (boxes != refinement->end())
   {
@@ -293,6 +394,11 @@ void RefinementData::SetUp(json &model)
 
   // Cleanup
   refinement->erase("UniformLevels");
+  refinement->erase("Tol");
+  refinement->erase("MaxIts");
+  refinement->erase("MaxSize");
+  refinement->erase("UpdateFraction");
+  refinement->erase("Nonconformal");
   refinement->erase("Boxes");
   refinement->erase("Spheres");
   MFEM_VERIFY(refinement->empty(),
@@ -301,8 +407,20 @@ void RefinementData::SetUp(json &model)
 
   // Debug
   // std::cout << "UniformLevels: " << uniform_ref_levels << '\n';
+  // std::cout << "Tol: " << tol << '\n';
+  // std::cout << "MaxIts: " << max_it << '\n';
+  // std::cout << "MaxSize: " << max_size << '\n';
+  // std::cout << "UpdateFraction: " << update_fraction << '\n';
+  // std::cout << "Nonconformal: " << nonconformal << '\n';
 }
 
+// Helper for converting string keys to enum for ModelData::ReorderType.
+NLOHMANN_JSON_SERIALIZE_ENUM(ModelData::ReorderType,
+                             {{ModelData::ReorderType::INVALID, nullptr},
+                              {ModelData::ReorderType::NONE, "None"},
+                              {ModelData::ReorderType::HILBERT, "Hilbert"},
+                              {ModelData::ReorderType::RCM, "RCM"}})
+
 void ModelData::SetUp(json &config)
 {
   auto model = config.find("Model");
@@ -313,7 +431,16 @@ void ModelData::SetUp(json &config)
   L0 = model->value("L0", L0);
   Lc = model->value("Lc", Lc);
   partition = model->value("Partition", partition);
+  weighted_partition = model->value("WeightedPartitioning", weighted_partition);
+  localize_ports = model->value("LocalizePorts", localize_ports);
+  export_partition = model->value("ExportPartition", export_partition);
+  export_mesh = model->value("ExportPartitionedMesh", export_mesh);
+  mesh_cache = model->value("MeshCache", mesh_cache);
   reorient_tet = model->value("ReorientTetMesh", reorient_tet);
+  reorder = model->value("ReorderElements", reorder);
+  MFEM_VERIFY(reorder != ReorderType::INVALID,
+              "Invalid value for config[\"Model\"][\"ReorderElements\"] in configuration "
+              "file!");
   refinement.SetUp(*model);
 
   // Cleanup
@@ -321,7 +448,13 @@ void ModelData::SetUp(json &config)
   model->erase("L0");
   model->erase("Lc");
   model->erase("Partition");
+  model->erase("WeightedPartitioning");
+  model->erase("LocalizePorts");
+  model->erase("ExportPartition");
+  model->erase("ExportPartitionedMesh");
+  model->erase("MeshCache");
   model->erase("ReorientTetMesh");
+  model->erase("ReorderElements");
   model->erase("Refinement");
   MFEM_VERIFY(model->empty(),
               "Found an unsupported configuration file keyword under \"Model\"!\n"
@@ -332,7 +465,13 @@ void ModelData::SetUp(json &config)
   // std::cout << "L0: " << L0 << '\n';
   // std::cout << "Lc: " << Lc << '\n';
   // std::cout << "Partition: " << partition << '\n';
+  // std::cout << "WeightedPartitioning: " << weighted_partition << '\n';
+  // std::cout << "LocalizePorts: " << localize_ports << '\n';
+  // std::cout << "ExportPartition: " << export_partition << '\n';
+  // std::cout << "ExportPartitionedMesh: " << export_mesh << '\n';
+  // std::cout << "MeshCache: " << mesh_cache << '\n';
   // std::cout << "ReorientTetMesh: " << reorient_tet << '\n';
+  // std::cout << "ReorderElements: " << reorder << '\n';
 }
 
 void MaterialDomainData::SetUp(json &domains)
@@ -453,6 +592,59 @@ void ProbePostData::SetUp(json &postpro)
   }
 }
 
+void SamplingPostData::SetUp(json &postpro)
+{
+  auto sampling = postpro.find("Sampling");
+  if (sampling == postpro.end())
+  {
+    return;
+  }
+  MFEM_VERIFY(sampling->is_array(),
+              "\"Sampling\" should specify an array in the configuration file!");
+  for (auto it = sampling->begin(); it != sampling->end(); ++it)
+  {
+    MFEM_VERIFY(it->find("Index") != it->end(),
+                "Missing \"Sampling\" region \"Index\" in configuration file!");
+    MFEM_VERIFY(it->find("Origin") != it->end() && it->find("Axes") != it->end() &&
+                    it->find("Points") != it->end(),
+                "Missing \"Sampling\" region \"Origin\", \"Axes\", or \"Points\" in "
+                "configuration file!");
+    auto ret = mapdata.insert(std::make_pair(it->at("Index"), SamplingData()));
+    MFEM_VERIFY(ret.second, "Repeated \"Index\" found when processing \"Sampling\" "
+                            "regions in configuration file!");
+    SamplingData &data = ret.first->second;
+    data.origin = it->at("Origin");                                        // Required
+    data.axes = it->at("Axes").get<std::vector<std::array<double, 3>>>();  // Required
+    data.npts = it->at("Points").get<std::vector<int>>();                  // Required
+    MFEM_VERIFY(!data.axes.empty() && data.axes.size() <= 3,
+                "config[\"Sampling\"][\"Axes\"] should specify an array of 1, 2, or 3 "
+                "axes in the configuration file!");
+    MFEM_VERIFY(data.npts.size() == data.axes.size(),
+                "config[\"Sampling\"][\"Points\"] should specify the number of points "
+                "along each of the \"Axes\" in the configuration file!");
+    for (auto n : data.npts)
+    {
+      MFEM_VERIFY(n > 0, "Number of sample points along each \"Sampling\" axis must be "
+                         "positive!");
+    }
+
+    // Debug
+    // std::cout << "Index: " << ret.first->first << '\n';
+    // std::cout << "Origin: " << data.origin << '\n';
+    // std::cout << "Axes: " << data.axes << '\n';
+    // std::cout << "Points: " << data.npts << '\n';
+
+    // Cleanup
+    it->erase("Index");
+    it->erase("Origin");
+    it->erase("Axes");
+    it->erase("Points");
+    MFEM_VERIFY(it->empty(),
+                "Found an unsupported configuration file keyword under \"Sampling\"!\n"
+                    << it->dump(2));
+  }
+}
+
 void DomainPostData::SetUp(json &domains)
 {
   auto postpro = domains.find("Postprocessing");
@@ -462,6 +654,7 @@ void DomainPostData::SetUp(json &domains)
   }
   dielectric.SetUp(*postpro);
   probe.SetUp(*postpro);
+  sampling.SetUp(*postpro);
 
   // Store all unique postprocessing domain attributes.
   for (const auto &[idx, data] : dielectric)
@@ -472,6 +665,7 @@ void DomainPostData::SetUp(json &domains)
   // Cleanup
   postpro->erase("Dielectric");
   postpro->erase("Probe");
+  postpro->erase("Sampling");
   MFEM_VERIFY(postpro->empty(),
               "Found an unsupported configuration file keyword under \"Postprocessing\"!\n"
                   << postpro->dump(2));
@@ -1570,6 +1764,7 @@ void LinearSolverData::SetUp(json &solver)
   mat_gmg = linear->value("UseGMG", mat_gmg);
   mat_lor = linear->value("UseLOR", mat_lor);
   mat_shifted = linear->value("UsePCShifted", mat_shifted);
+  mat_complex = linear->value("UsePCComplex", mat_complex);
   mg_cycle_it = linear->value("MGCycleIts", mg_cycle_it);
   mg_smooth_it = linear->value("MGSmoothIts", mg_smooth_it);
   mg_smooth_order = linear->value("MGSmoothOrder", mg_smooth_order);
@@ -1608,6 +1803,7 @@ void LinearSolverData::SetUp(json &solver)
   linear->erase("UseGMG");
   linear->erase("UseLOR");
   linear->erase("UsePCShifted");
+  linear->erase("UsePCComplex");
   linear->erase("MGCycleIts");
   linear->erase("MGSmoothIts");
   linear->erase("MGSmoothOrder");
@@ -1638,6 +1834,7 @@ void LinearSolverData::SetUp(json &solver)
   // std::cout << "UseGMG: " << mat_gmg << '\n';
   // std::cout << "UseLOR: " << mat_lor << '\n';
   // std::cout << "UsePCShifted: " << mat_shifted << '\n';
+  // std::cout << "UsePCComplex: " << mat_complex << '\n';
   // std::cout << "MGCycleIts: " << mg_cycle_it << '\n';
   // std::cout << "MGSmoothIts: " << mg_smooth_it << '\n';
   // std::cout << "MGSmoothOrder: " << mg_smooth_order << '\n';
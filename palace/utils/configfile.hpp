@@ -62,6 +62,35 @@ public:
 
 }  // namespace internal
 
+struct FieldOutputData
+{
+public:
+  // Names of the fields written for visualization (all fields if empty).
+  std::vector<std::string> fields = {};
+
+  // Domain and boundary attributes for which the fields are written (all if empty).
+  std::vector<int> attributes = {}, bdr_attributes = {};
+
+  // Bounding box limits of the regions in which the fields are written, stored as three
+  // values for each box [m] (entire domain if empty).
+  std::vector<double> bbmin = {}, bbmax = {};
+
+  // Maximum levels of detail for high-order output (zero for the element order).
+  int max_levels_of_detail = 0;
+
+  // Precision of the written field values.
+  enum class DataFormat
+  {
+    FLOAT64,
+    FLOAT32,
+    FLOAT16,
+    INVALID = -1
+  };
+  DataFormat format = DataFormat::FLOAT32;
+
+  void SetUp(json &problem);
+};
+
 struct ProblemData
 {
 public:
@@ -83,6 +112,13 @@ public:
   // Output path for storing results.
   std::string output = "";
 
+  // Maximum number of field output snapshots queued for writing to disk by a background
+  // thread (zero for synchronous output).
+  int async_output = 0;
+
+  // Options for the field output for visualization.
+  FieldOutputData field_output = {};
+
   void SetUp(json &config);
 };
 
@@ -113,6 +149,20 @@ public:
   // Parallel uniform mesh refinement levels.
   int uniform_ref_levels = 0;
 
+  // Adaptive mesh refinement: relative error estimate tolerance, maximum number of
+  // iterations, and maximum global problem size (number of degrees of freedom).
+  double tol = 1.0e-2;
+  int max_it = 0;
+  long long int max_size = 0;
+
+  // Fraction of the total squared error estimate to be contained in the elements marked
+  // for refinement in each iteration of adaptive mesh refinement.
+  double update_fraction = 0.7;
+
+  // Use nonconforming refinement for adaptive and region-based mesh refinement (required
+  // for rebalancing).
+  bool nonconformal = true;
+
 private:
   // Refinement data for mesh regions.
   std::vector<BoxRefinementData> boxlist = {};
@@ -144,9 +194,37 @@ public:
   // Partitioning file (if specified, does not compute a new partitioning).
   std::string partition = "";
 
+  // Weight elements by their estimated cost when computing the partitioning, and
+  // optionally keep the elements adjacent to each port in as few subdomains as possible.
+  bool weighted_partition = false;
+  bool localize_ports = false;
+
+  // File to which the computed partitioning is written, for reuse by subsequent
+  // simulations.
+  std::string export_partition = "";
+
+  // Directory to which the partitioned and preprocessed parallel mesh is written (one file
+  // per process), for reading in parallel in subsequent simulations.
+  std::string export_mesh = "";
+
+  // Directory for caching the partitioned (and refined) parallel mesh for reuse by
+  // subsequent simulations.
+  std::string mesh_cache = "";
+
   // Call MFEM's ReorientTetMesh as a check of mesh orientation after partitioning.
   bool reorient_tet = false;
 
+  // Reordering of mesh elements and vertices after partitioning, which determines the
+  // local ordering of the degrees of freedom on each process.
+  enum class ReorderType
+  {
+    NONE,
+    HILBERT,
+    RCM,
+    INVALID = -1
+  };
+  ReorderType reorder = ReorderType::NONE;
+
   // Object controlling mesh refinement.
   RefinementData refinement = {};
 
@@ -229,6 +307,24 @@ public:
   void SetUp(json &postpro);
 };
 
+struct SamplingData
+{
+public:
+  // Physical space coordinates for the origin of the sampling grid [m].
+  std::array<double, 3> origin = {0.0, 0.0, 0.0};
+
+  // Axes spanning the sampling grid from its origin (one for a line, two for a plane, or
+  // three for a volume) [m], and number of sample points along each axis.
+  std::vector<std::array<double, 3>> axes = {};
+  std::vector<int> npts = {};
+};
+
+struct SamplingPostData : public internal::DataMap<SamplingData>
+{
+public:
+  void SetUp(json &postpro);
+};
+
 struct DomainPostData
 {
 public:
@@ -238,6 +334,7 @@ public:
   // Domain postprocessing objects.
   DomainDielectricPostData dielectric;
   ProbePostData probe;
+  SamplingPostData sampling;
 
   void SetUp(json &domains);
 };
@@ -763,6 +860,11 @@ public:
   // (makes the preconditoner matrix SPD).
   int mat_shifted = -1;
 
+  // For frequency domain driven problems, precondition linear systems with the complex
+  // system matrix using complex-valued geometric multigrid and smoothers. Requires a sparse
+  // direct solver for the coarse level.
+  bool mat_complex = false;
+
   // Number of iterations for preconditioners which support it. For multigrid, this is the
   // number of V-cycles per Krylov solver iteration.
   int mg_cycle_it = 1;
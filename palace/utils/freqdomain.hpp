@@ -4,7 +4,10 @@
 #ifndef PALACE_FREQ_DOMAIN_HPP
 #define PALACE_FREQ_DOMAIN_HPP
 
+#include <complex>
+#include <vector>
 #include <mfem.hpp>
+#include "linalg/hypre.hpp"
 #include "linalg/petsc.hpp"
 #include "utils/mfemoperators.hpp"
 
@@ -15,12 +18,66 @@ namespace palace::utils
 // Some utility methods for frequency domain problems.
 //
 
+// Collect the real and imaginary parts of the matrices making up the frequency domain
+// operator K + iω C - ω² M + A2(ω), along with their complex weights. Returns false if any
+// of the parts is not a Hypre parallel matrix. The order of the terms only depends on which
+// parts are present, so the weights for a different ω can be computed by calling this
+// again with the same matrices.
+inline bool GetSystemMatrixTerms(double omega, const petsc::PetscParMatrix &K,
+                                 const petsc::PetscParMatrix &M,
+                                 const petsc::PetscParMatrix *C,
+                                 const petsc::PetscParMatrix *A2,
+                                 std::vector<const mfem::HypreParMatrix *> &mats,
+                                 std::vector<std::complex<double>> &weights)
+{
+  constexpr auto ExtractReal = petsc::PetscParMatrix::ExtractStructure::REAL;
+  constexpr auto ExtractImag = petsc::PetscParMatrix::ExtractStructure::IMAGINARY;
+  mats.clear();
+  weights.clear();
+  bool valid = true;
+  auto AddTerm = [&](const petsc::PetscParMatrix *A, std::complex<double> w)
+  {
+    if (!A)
+    {
+      return;
+    }
+    for (const auto struc : {ExtractReal, ExtractImag})
+    {
+      if ((struc == ExtractReal) ? A->HasReal() : A->HasImag())
+      {
+        const auto *hA = dynamic_cast<const mfem::HypreParMatrix *>(A->GetOperator(struc));
+        valid = valid && hA;
+        mats.push_back(hA);
+        weights.push_back((struc == ExtractReal) ? w : std::complex<double>(0.0, 1.0) * w);
+      }
+    }
+  };
+  AddTerm(&K, 1.0);
+  AddTerm(&M, -omega * omega);
+  AddTerm(C, std::complex<double>(0.0, omega));
+  AddTerm(A2, 1.0);
+  return valid;
+}
+
 // Convinience method for constructing a the frequency domain matrix-vector product with the
-// operator K + iω C - ω² M + A2(ω).
+// operator K + iω C - ω² M + A2(ω). When all of the matrices are Hypre parallel matrices,
+// their sum is stored on a shared sparsity pattern and applied in a single pass. In either
+// case, the returned operator references the matrices, which must outlive it.
 inline std::unique_ptr<petsc::PetscParMatrix> GetSystemMatrixShell(
     double omega, const petsc::PetscParMatrix &K, const petsc::PetscParMatrix &M,
     const petsc::PetscParMatrix *C = nullptr, const petsc::PetscParMatrix *A2 = nullptr)
 {
+  {
+    std::vector<const mfem::HypreParMatrix *> mats;
+    std::vector<std::complex<double>> weights;
+    if (GetSystemMatrixTerms(omega, K, M, C, A2, mats, weights))
+    {
+      auto A = std::make_unique<petsc::PetscShellMatrix>(
+          K.GetComm(), std::make_unique<hypre::HypreParMatrixSum>(mats, weights));
+      A->SetSymmetric();
+      return A;
+    }
+  }
   constexpr auto ExtractReal = petsc::PetscParMatrix::ExtractStructure::REAL;
   constexpr auto ExtractImag = petsc::PetscParMatrix::ExtractStructure::IMAGINARY;
   auto Ar = std::make_unique<SumOperator>(K.GetNumRows(), K.GetNumCols());
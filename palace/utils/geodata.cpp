@@ -3,17 +3,30 @@
 
 #include "geodata.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
 #include <limits>
-#include <map>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <mfem.hpp>
+#if defined(MFEM_USE_METIS_5)
+#include <metis.h>
+#endif
 #include "utils/communication.hpp"
 #include "utils/filesystem.hpp"
 #include "utils/iodata.hpp"
 #include "utils/meshio.hpp"
 #include "utils/timer.hpp"
+#include "utils/zlib.hpp"
 
 namespace palace
 {
@@ -25,76 +38,300 @@ namespace
 // lost!
 const auto MSH_FLT_PRECISION = std::numeric_limits<double>::max_digits10;
 
+// Version of the converted mesh cache, to be incremented when changes to the mesh
+// converters modify their output.
+constexpr int MESH_CACHE_VERSION = 2;
+
+// Header identifying binary mesh partitioning files.
+constexpr char PARTITION_HEADER[] = "PALACE_PART";
+
 // Load the serial mesh from disk.
 std::unique_ptr<mfem::Mesh> LoadMesh(const std::string &);
 
-// Optionally reorder mesh elements based on MFEM's internal reordeing tools for improved
-// cache usage.
-void ReorderMesh(mfem::Mesh &);
+// Get the name of the cache file for a converted mesh, keyed by a hash of the contents of
+// the original mesh file.
+std::string GetMeshCacheFilename(const std::filesystem::path &);
+
+// Write a converted mesh to the cache in MFEM's native format.
+void WriteMeshCache(const std::string &, const mfem::Mesh &);
+
+// Optionally reorder mesh elements (and vertices) for improved cache usage, permuting the
+// element partitioning accordingly.
+void ReorderMesh(mfem::Mesh &, const IoData &, std::unique_ptr<int[]> &);
+
+// Compute a reverse Cuthill-McKee ordering of the element dual graph.
+void GetRCMElementOrdering(mfem::Mesh &, mfem::Array<int> &);
 
 // Generate element-based mesh partitioning, using either a provided file or METIS.
-std::unique_ptr<int[]> GetMeshPartitioning(mfem::Mesh &, int, const std::string &);
+std::unique_ptr<int[]> GetMeshPartitioning(mfem::Mesh &, int, const IoData &);
+
+// Generate element-based mesh partitioning with METIS, where the elements are weighted by
+// their estimated cost after region-based refinement and including boundary integrators.
+// Returns nullptr if the weighted partitioning is not available.
+std::unique_ptr<int[]> GetWeightedMeshPartitioning(mfem::Mesh &, int, const IoData &);
+
+// Read a mesh partitioning from a file, in either text or binary format.
+std::unique_ptr<int[]> ReadMeshPartitioning(const std::string &, int, int);
+
+// Write a mesh partitioning to a file in binary format.
+void WriteMeshPartitioning(const std::string &, const int *, int, int);
+
+// Cleanup the provided serial mesh by removing domain elements with no associated material
+// and the boundary elements which are no longer attached to the domain. Returns the index
+// in the original mesh of each remaining element, or an empty vector if no elements were
+// removed.
+std::vector<int> CleanMesh(std::unique_ptr<mfem::Mesh> &, const IoData &);
+
+// Check the boundary attributes of the distributed (or serial) mesh, and add boundary
+// elements for material interfaces and exterior boundaries, and for subdomain interfaces.
+template <typename MeshType>
+void CheckMesh(std::unique_ptr<MeshType> &, const IoData &, bool, bool);
+
+// Serial or parallel mesh which allows adding boundary elements on existing faces of a
+// conforming mesh, without reconstructing the mesh.
+template <typename MeshType>
+class BoundaryMesh : public MeshType
+{
+public:
+  BoundaryMesh(MeshType &&mesh) : MeshType(std::move(mesh)) {}
+
+  // Add a boundary element for the given local face, with the orientation of the face.
+  void AddBdrFace(int f, int attr);
 
-// Cleanup the provided serial mesh by removing unnecessary domain and elements, adding
-// boundary elements for material interfaces and exterior boundaries, and adding boundary
-// elements for subdomain interfaces.
-std::map<int, std::array<int, 2>> CheckMesh(std::unique_ptr<mfem::Mesh> &,
-                                            const std::unique_ptr<int[]> &, const IoData &,
-                                            bool, bool, bool);
+  // Update the boundary element connectivity and the global boundary attribute list after
+  // adding new boundary elements.
+  void FinalizeBoundary();
+};
+
+// Check whether the serial mesh is made nonconforming before it is distributed, which is
+// required for nonconforming refinement of the parallel mesh.
+bool UseNonconformingMesh(const IoData &);
+
+// Serialize a conforming serial mesh into a binary string of its vertex, element, and
+// boundary element arrays and high-order nodes, and construct a mesh from the result.
+std::string SerializeMesh(const mfem::Mesh &);
+std::unique_ptr<mfem::Mesh> DeserializeMesh(const std::string &);
 
 // Given a serial mesh on the root processor and element partitioning, create a parallel
 // mesh oer the given communicator.
 std::unique_ptr<mfem::ParMesh> DistributeMesh(MPI_Comm, std::unique_ptr<mfem::Mesh> &,
-                                              std::unique_ptr<int[]> &);
+                                              std::unique_ptr<int[]> &, bool);
 
 // Get list of domain and boundary attribute markers used in configuration file for mesh
 // cleaning.
 void GetUsedAttributeMarkers(const IoData &, int, int, mfem::Array<int> &,
                              mfem::Array<int> &);
 
+// Bounding volume hierarchy over a set of axis-aligned bounding boxes, for fast queries of
+// the boxes which overlap a given box.
+class RegionBVH
+{
+private:
+  // Tree nodes, with the range of leaf box indices or the child node indices.
+  struct Node
+  {
+    std::array<double, 3> bbmin, bbmax;
+    int begin, end, left, right;
+  };
+  std::vector<Node> nodes;
+  std::vector<int> index;
+
+  // Box bounds, stored contiguously for each box.
+  int dim;
+  std::vector<double> bbmin, bbmax;
+
+  int Build(int begin, int end);
+
+public:
+  RegionBVH(int dim, std::vector<double> &&bbmin, std::vector<double> &&bbmax);
+
+  // Call the provided function with the index of each box which overlaps the given box,
+  // until the function returns false.
+  template <typename T>
+  void Query(const double *qmin, const double *qmax, T &&Callback) const
+  {
+    auto Overlaps = [this, qmin, qmax](const double *min, const double *max)
+    {
+      for (int d = 0; d < dim; d++)
+      {
+        if (qmax[d] < min[d] || qmin[d] > max[d])
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+    if (nodes.empty())
+    {
+      return;
+    }
+    std::vector<int> stack = {0};
+    while (!stack.empty())
+    {
+      const Node &node = nodes[stack.back()];
+      stack.pop_back();
+      if (!Overlaps(node.bbmin.data(), node.bbmax.data()))
+      {
+        continue;
+      }
+      if (node.left < 0)
+      {
+        for (int k = node.begin; k < node.end; k++)
+        {
+          if (Overlaps(&bbmin[index[k] * dim], &bbmax[index[k] * dim]) &&
+              !Callback(index[k]))
+          {
+            return;
+          }
+        }
+      }
+      else
+      {
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+      }
+    }
+  }
+};
+
+// Get the name of the partitioned mesh file for the given process.
+std::string GetPartitionedMeshFilename(const std::string &, int);
+
+// Read a mesh which has already been partitioned and preprocessed, from a directory with
+// one file per process, directly into a parallel mesh. Each process reads only its own
+// partition.
+std::unique_ptr<mfem::ParMesh> LoadPartitionedMesh(MPI_Comm, const std::string &);
+
+// Write the parallel mesh to a directory with one file per process, in a format which can
+// be read back with LoadPartitionedMesh.
+void WritePartitionedMesh(const std::string &, const mfem::ParMesh &);
+
 }  // namespace
 
 namespace mesh
 {
 
-std::unique_ptr<mfem::ParMesh> ReadMesh(MPI_Comm comm, const IoData &iodata, bool reorder,
-                                        bool clean, bool add_bdr, bool unassembled,
-                                        Timer &timer)
+std::unique_ptr<mfem::ParMesh> ReadMesh(MPI_Comm comm, const IoData &iodata, bool clean,
+                                        bool add_bdr, bool unassembled, Timer &timer)
 {
+  // If the mesh has already been partitioned and preprocessed by a previous simulation,
+  // each process reads its own partition in parallel and the serial mesh is never
+  // constructed.
+  auto t0 = timer.Now();
+  if (std::filesystem::is_directory(iodata.model.mesh))
+  {
+    std::unique_ptr<mfem::ParMesh> mesh = LoadPartitionedMesh(comm, iodata.model.mesh);
+    Mpi::Barrier(comm);
+    timer.io_time += timer.Now() - t0;
+    return mesh;
+  }
+
   // On root, read the serial mesh (converting format if necessary), and do all necessary
   // serial preprocessing. When finished, distribute the mesh to all processes. Count disk
   // I/O time separately for the mesh read from file.
   std::unique_ptr<mfem::Mesh> smesh;
-  auto t0 = timer.Now();
   if (Mpi::Root(comm))
   {
-    // Optionally reorder elements (and vertices) based on spatial location after loading
-    // the serial mesh.
     smesh = LoadMesh(iodata.model.mesh);
-    if (reorder)
-    {
-      ReorderMesh(*smesh);
-    }
   }
   Mpi::Barrier(comm);
   timer.io_time += timer.Now() - t0;
 
   std::unique_ptr<int[]> partitioning;
+  const bool nonconforming = UseNonconformingMesh(iodata);
   if (Mpi::Root(comm))
   {
-    // Generate the parallel mesh partitioning on the root process.
-    partitioning = GetMeshPartitioning(*smesh, Mpi::Size(comm), iodata.model.partition);
+    // Partitioning files always refer to the elements of the original mesh file, so a
+    // partitioning from file is read before the mesh is cleaned.
+    const int size = Mpi::Size(comm), orig_ne = smesh->GetNE();
+    if (!iodata.model.partition.empty())
+    {
+      partitioning = ReadMeshPartitioning(iodata.model.partition, orig_ne, size);
+      Mpi::Print("Read mesh partitioning into {:d} subdomain{} from disk\n", size,
+                 (size > 1) ? "s" : "");
+    }
+
+    // Clean up unused domain elements from the mesh before it is partitioned. A new serial
+    // mesh is only constructed if elements are removed, in which case a partitioning from
+    // file is restricted to the remaining elements.
+    std::vector<int> orig_elems;
+    if (clean)
+    {
+      orig_elems = CleanMesh(smesh, iodata);
+    }
+    if (partitioning && !orig_elems.empty())
+    {
+      auto clean_partitioning = std::make_unique<int[]>(smesh->GetNE());
+      for (int e = 0; e < smesh->GetNE(); e++)
+      {
+        clean_partitioning[e] = partitioning[orig_elems[e]];
+      }
+      partitioning = std::move(clean_partitioning);
+    }
+
+    // Generate the parallel mesh partitioning on the root process. An exported
+    // partitioning refers to the elements of the original mesh file, where removed
+    // elements are assigned to the first subdomain.
+    if (!partitioning)
+    {
+      partitioning = GetMeshPartitioning(*smesh, size, iodata);
+    }
+    if (!iodata.model.export_partition.empty())
+    {
+      if (orig_elems.empty())
+      {
+        WriteMeshPartitioning(iodata.model.export_partition, partitioning.get(), orig_ne,
+                              size);
+      }
+      else
+      {
+        std::vector<int> orig_partitioning(orig_ne, 0);
+        for (int e = 0; e < smesh->GetNE(); e++)
+        {
+          orig_partitioning[orig_elems[e]] = partitioning[e];
+        }
+        WriteMeshPartitioning(iodata.model.export_partition, orig_partitioning.data(),
+                              orig_ne, size);
+      }
+    }
+
+    // Optionally reorder elements (and vertices) after partitioning. The elements of each
+    // subdomain keep their relative order when the mesh is distributed, so the local
+    // elements and degrees of freedom on each process (and on all refined levels) follow
+    // the new ordering.
+    ReorderMesh(*smesh, iodata, partitioning);
 
-    // Clean up unused domain elements from the mesh, add new boundary elements for material
-    // interfaces if not present, and optionally (when running unassembled) add subdomain
-    // interface boundary elements.
-    std::map<int, std::array<int, 2>> attr_map =
-        CheckMesh(smesh, partitioning, iodata, clean, add_bdr, unassembled);
+    // A mesh which is made nonconforming is checked before it is distributed, since
+    // boundary elements added to the parallel mesh would not be part of its nonconforming
+    // refinement hierarchy.
+    if (nonconforming)
+    {
+      CheckMesh(smesh, iodata, add_bdr, unassembled);
+    }
   }
 
   // Construct the parallel mesh data structure by distributing the serial mesh from the
   // root process. The serial mesh and partitioning are deleted inside.
-  std::unique_ptr<mfem::ParMesh> mesh = DistributeMesh(comm, smesh, partitioning);
+  std::unique_ptr<mfem::ParMesh> mesh =
+      DistributeMesh(comm, smesh, partitioning, nonconforming);
+
+  // Check the boundary attributes, add new boundary elements for material interfaces if
+  // not present, and optionally (when running unassembled) add subdomain interface
+  // boundary elements. This is done on the distributed mesh so the root process never
+  // holds a second copy of the serial mesh.
+  if (!nonconforming)
+  {
+    CheckMesh(mesh, iodata, add_bdr, unassembled);
+  }
+
+  // Optionally write the partitioned mesh for parallel reading in subsequent simulations.
+  if (!iodata.model.export_mesh.empty())
+  {
+    t0 = timer.Now();
+    WritePartitionedMesh(iodata.model.export_mesh, *mesh);
+    Mpi::Barrier(comm);
+    timer.io_time += timer.Now() - t0;
+  }
 
 #if 0
   {
@@ -110,7 +347,8 @@ std::unique_ptr<mfem::ParMesh> ReadMesh(MPI_Comm comm, const IoData &iodata, boo
     }
     int width = 1 + static_cast<int>(std::log10(Mpi::Size(comm)-1));
     std::unique_ptr<mfem::Mesh> gsmesh = LoadMesh(iodata.model.mesh);
-    std::unique_ptr<int[]> gpartitioning = GetMeshPartitioning(*gsmesh, Mpi::Size(comm));
+    std::unique_ptr<int[]> gpartitioning =
+        GetMeshPartitioning(*gsmesh, Mpi::Size(comm), iodata);
     mfem::ParMesh gpmesh(comm, *gsmesh, gpartitioning.get(), 0);
     {
       std::string pfile = mfem::MakeParFilename(tmp + "part.", Mpi::Rank(comm), ".mesh", width);
@@ -164,7 +402,7 @@ void RefineMesh(const IoData &iodata, std::vector<std::unique_ptr<mfem::ParMesh>
   // reorient only the coarse mesh so that the refinements are still true refinements of
   // the original mesh (required for geometric multigrid). Otherwise, it happens after
   // refinement.
-  if (iodata.model.reorient_tet && mesh.capacity() > 1)
+  if (iodata.model.reorient_tet && mesh.capacity() > 1 && !mesh[0]->Nonconforming())
   {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -185,16 +423,14 @@ void RefineMesh(const IoData &iodata, std::vector<std::unique_ptr<mfem::ParMesh>
 
   // Proceed with region-based refinement, level-by-level for all regions. Currently support
   // box and sphere region shapes. Any overlap between regions is ignored (take the union,
-  // don't double-refine).
-  if (max_region_ref_levels > 0 &&
+  // don't double-refine). The refinement is nonconforming if the mesh was made
+  // nonconforming before it was distributed, and otherwise conforming refinement is only
+  // available for simplex meshes.
+  if (max_region_ref_levels > 0 && !mesh[0]->Nonconforming() &&
       (mesh[0]->MeshGenerator() & 2 || mesh[0]->MeshGenerator() & 4 ||
        mesh[0]->MeshGenerator() & 8))
   {
-    // XX TODO: Region-based refinement won't work if the ParMesh has been constructed from
-    //          a conforming mesh, but non-conforming refinement is needed. Unclear if the
-    //          current mesh distribution scheme will work even for a conforming serial mesh
-    //          which is a NCMesh after Mesh::EnsureNCMesh is called.
-    MFEM_ABORT("Region-based refinement is currently only supported for simplex meshes!");
+    MFEM_ABORT("Conforming region-based refinement is only supported for simplex meshes!");
   }
   int region_ref_level = 0;
   bool use_nodes = (mesh.back()->GetNodes() != nullptr);
@@ -202,99 +438,141 @@ void RefineMesh(const IoData &iodata, std::vector<std::unique_ptr<mfem::ParMesh>
   int dim = mesh.back()->SpaceDimension();
   while (region_ref_level < max_region_ref_levels)
   {
+    // Collect the bounding boxes of the refinement regions active at this level into a
+    // bounding volume hierarchy. Regions are numbered with boxes first, then spheres.
+    const auto &boxes = iodata.model.refinement.GetBoxes();
+    const auto &spheres = iodata.model.refinement.GetSpheres();
+    std::vector<int> region_ids;
+    std::vector<double> region_bbmin, region_bbmax;
+    for (std::size_t k = 0; k < boxes.size(); k++)
+    {
+      if (region_ref_level < boxes[k].ref_levels)
+      {
+        region_ids.push_back(static_cast<int>(k));
+        region_bbmin.insert(region_bbmin.end(), boxes[k].bbmin.begin(),
+                            boxes[k].bbmin.begin() + dim);
+        region_bbmax.insert(region_bbmax.end(), boxes[k].bbmax.begin(),
+                            boxes[k].bbmax.begin() + dim);
+      }
+    }
+    for (std::size_t k = 0; k < spheres.size(); k++)
+    {
+      if (region_ref_level < spheres[k].ref_levels)
+      {
+        region_ids.push_back(static_cast<int>(boxes.size() + k));
+        for (int d = 0; d < dim; d++)
+        {
+          region_bbmin.push_back(spheres[k].center[d] - spheres[k].r);
+          region_bbmax.push_back(spheres[k].center[d] + spheres[k].r);
+        }
+      }
+    }
+    const RegionBVH bvh(dim, std::move(region_bbmin), std::move(region_bbmax));
+
+    // Check if the point is inside the given refinement region.
+    auto InsideRegion = [&boxes, &spheres, dim](const double *x, int k)
+    {
+      if (k < static_cast<int>(boxes.size()))
+      {
+        const auto &box = boxes[k];
+        for (int d = 0; d < dim; d++)
+        {
+          if (x[d] < box.bbmin[d] || x[d] > box.bbmax[d])
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+      const auto &sphere = spheres[k - boxes.size()];
+      double dist = 0.0;
+      for (int d = 0; d < dim; d++)
+      {
+        double s = x[d] - sphere.center[d];
+        dist += s * s;
+      }
+      return (dist <= sphere.r * sphere.r);
+    };
+
+    // The refined reference points for curved elements are generated up front for all
+    // element geometries.
+    std::array<const mfem::IntegrationRule *, mfem::Geometry::NUM_GEOMETRIES> ref_pts = {};
+    if (use_nodes)
+    {
+      mfem::Array<mfem::Geometry::Type> geoms;
+      mesh.back()->GetGeometries(mesh.back()->Dimension(), geoms);
+      for (auto geo : geoms)
+      {
+        ref_pts[geo] = &mfem::GlobGeometryRefiner.Refine(geo, ref)->RefPts;
+      }
+    }
+
     // Mark elements for refinement in all regions. An element is marked for refinement if
-    // any of its vertices are inside any refinement region for the given level.
-    mfem::Array<mfem::Refinement> refs;
-    for (int i = 0; i < mesh.back()->GetNE(); i++)
+    // any of its vertices (or refined points for curved elements) are inside any
+    // refinement region for the given level. Only the regions whose bounding boxes overlap
+    // the element bounding box are tested. Evaluating the transformation of a curved
+    // element uses shared state of the mesh nodal finite element space which is not
+    // thread-safe, so the loop only runs threaded when using the element vertices.
+    const mfem::ParMesh &pmesh = *mesh.back();
+    std::vector<char> marked(pmesh.GetNE(), 0);
+#if defined(MFEM_USE_OPENMP)
+#pragma omp parallel for schedule(dynamic, 1024) if (!use_nodes)
+#endif
+    for (int i = 0; i < pmesh.GetNE(); i++)
     {
-      bool refine = false;
       mfem::DenseMatrix pointmat;
       if (use_nodes)
       {
-        mfem::ElementTransformation *T = mesh.back()->GetElementTransformation(i);
-        mfem::Geometry::Type geo = mesh.back()->GetElementGeometry(i);
-        mfem::RefinedGeometry *RefG = mfem::GlobGeometryRefiner.Refine(geo, ref);
-        T->Transform(RefG->RefPts, pointmat);
+        mfem::IsoparametricTransformation T;
+        pmesh.GetElementTransformation(i, &T);
+        T.Transform(*ref_pts[pmesh.GetElementGeometry(i)], pointmat);
       }
       else
       {
         mfem::Array<int> verts;
-        mesh.back()->GetElementVertices(i, verts);
+        pmesh.GetElementVertices(i, verts);
         pointmat.SetSize(dim, verts.Size());
         for (int j = 0; j < verts.Size(); j++)
         {
-          const double *coord = mesh.back()->GetVertex(verts[j]);
+          const double *coord = pmesh.GetVertex(verts[j]);
           for (int d = 0; d < dim; d++)
           {
             pointmat(d, j) = coord[d];
           }
         }
       }
-      for (const auto &box : iodata.model.refinement.GetBoxes())
-      {
-        if (region_ref_level < box.ref_levels)
-        {
-          for (int j = 0; j < pointmat.Width(); j++)
-          {
-            // Check if the point is inside the box.
-            int d = 0;
-            for (; d < pointmat.Height(); d++)
-            {
-              if (pointmat(d, j) < box.bbmin[d] || pointmat(d, j) > box.bbmax[d])
-              {
-                break;
-              }
-            }
-            if (d == dim)
-            {
-              refine = true;
-              break;
-            }
-          }
-          if (refine)
-          {
-            break;
-          }
-        }
-      }
-      if (refine)
-      {
-        refs.Append(mfem::Refinement(i));
-        continue;
-      }
-      for (const auto &sphere : iodata.model.refinement.GetSpheres())
+      double elem_bbmin[3], elem_bbmax[3];
+      for (int d = 0; d < dim; d++)
       {
-        if (region_ref_level < sphere.ref_levels)
+        elem_bbmin[d] = mfem::infinity();
+        elem_bbmax[d] = -mfem::infinity();
+        for (int j = 0; j < pointmat.Width(); j++)
         {
-          for (int j = 0; j < pointmat.Width(); j++)
-          {
-            // Check if the point is inside the sphere.
-            double dist = 0.0;
-            for (int d = 0; d < pointmat.Height(); d++)
-            {
-              double s = pointmat(d, j) - sphere.center[d];
-              dist += s * s;
-            }
-            if (dist <= sphere.r * sphere.r)
-            {
-              refine = true;
-              break;
-            }
-          }
-          if (refine)
-          {
-            break;
-          }
+          elem_bbmin[d] = std::min(elem_bbmin[d], pointmat(d, j));
+          elem_bbmax[d] = std::max(elem_bbmax[d], pointmat(d, j));
         }
       }
-      if (refine)
+      bvh.Query(elem_bbmin, elem_bbmax,
+                [&](int r)
+                {
+                  for (int j = 0; j < pointmat.Width() && !marked[i]; j++)
+                  {
+                    marked[i] = InsideRegion(pointmat.GetColumn(j), region_ids[r]);
+                  }
+                  return !marked[i];
+                });
+    }
+    mfem::Array<mfem::Refinement> refs;
+    for (int i = 0; i < pmesh.GetNE(); i++)
+    {
+      if (marked[i])
       {
         refs.Append(mfem::Refinement(i));
       }
     }
 
-    // Do the refinement. For tensor element meshes, this may make the mesh nonconforming
-    // (adds hanging nodes).
+    // Do the refinement, which is nonconforming (adds hanging nodes) for a nonconforming
+    // mesh.
     if (mesh.capacity() > 1)
     {
       mesh.push_back(std::make_unique<mfem::ParMesh>(*mesh.back()));
@@ -302,21 +580,118 @@ void RefineMesh(const IoData &iodata, std::vector<std::unique_ptr<mfem::ParMesh>
     mesh.back()->GeneralRefinement(refs, -1);
     region_ref_level++;
   }
+  if (max_region_ref_levels > 0 && mesh.size() == 1 && mesh.back()->Nonconforming())
+  {
+    // Region refinement is localized and leaves the load unbalanced across processes, so
+    // redistribute the elements (not possible when keeping the hierarchy).
+    mesh.back()->Rebalance();
+  }
 
   // Prior to MFEM's PR #1046, the tetrahedral mesh required reorientation after all mesh
   // refinement in order to define higher-order Nedelec spaces on it. This is technically
   // not required after MFEM's PR #1046, but in case you want to be absolutely sure, we
   // reorient only the mesh after refinement if there is a single mesh (doesn't work with
   // h-refinement geometric multigrid).
-  if (iodata.model.reorient_tet && mesh.size() == 1)
+  if (iodata.model.reorient_tet && mesh.size() == 1 && !mesh[0]->Nonconforming())
   {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     mesh[0]->ReorientTetMesh();
 #pragma GCC diagnostic pop
   }
+}
+
+bool AdaptMesh(const IoData &iodata, const mfem::Vector &indicators,
+               std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+               const std::function<void()> &update)
+{
+  const mfem::ParMesh &fine = *mesh.back();
+  MPI_Comm comm = fine.GetComm();
+  MFEM_VERIFY(indicators.Size() == fine.GetNE(),
+              "Error indicators do not match the number of mesh elements!");
+  MFEM_VERIFY(fine.Nonconforming() || fine.MeshGenerator() == 1,
+              "Conforming adaptive mesh refinement is only available for simplex meshes!");
+
+  // Find the largest threshold for which the marked elements contain the requested fraction
+  // of the total squared error estimate, using bisection.
+  double total = 0.0, max = 0.0;
+  for (int e = 0; e < indicators.Size(); e++)
+  {
+    total += indicators(e);
+    max = std::max(max, indicators(e));
+  }
+  Mpi::GlobalSum(1, &total, comm);
+  Mpi::GlobalMax(1, &max, comm);
+  const double target = iodata.model.refinement.update_fraction * total;
+  double lo = 0.0, hi = max;
+  for (int it = 0; it < 64 && hi - lo > 1.0e-6 * max; it++)
+  {
+    const double mid = 0.5 * (lo + hi);
+    double sum = 0.0;
+    for (int e = 0; e < indicators.Size(); e++)
+    {
+      if (indicators(e) >= mid)
+      {
+        sum += indicators(e);
+      }
+    }
+    Mpi::GlobalSum(1, &sum, comm);
+    if (sum >= target)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  mfem::Array<mfem::Refinement> refs;
+  for (int e = 0; e < indicators.Size(); e++)
+  {
+    if (indicators(e) >= lo && indicators(e) > 0.0)
+    {
+      refs.Append(mfem::Refinement(e));
+    }
+  }
+  HYPRE_BigInt nmarked = refs.Size(), ne = fine.GetNE();
+  Mpi::GlobalSum(1, &nmarked, comm);
+  Mpi::GlobalSum(1, &ne, comm);
+  if (nmarked == 0)
+  {
+    return false;
+  }
+  Mpi::Print(comm, "\nMarked {:d}/{:d} elements for refinement\n", nmarked, ne);
+
+  // Refine the marked elements, keeping the previous mesh if it is part of the hierarchy
+  // for geometric multigrid. Otherwise, rebalance the nonconforming mesh since the
+  // refinement is usually localized to a few processes. The refinement is nonconforming
+  // if the mesh was made nonconforming before it was distributed, and conforming
+  // otherwise.
+  auto Update = [&update]()
+  {
+    if (update)
+    {
+      update();
+    }
+  };
+  if (iodata.solver.linear.mat_gmg)
+  {
+    mesh.push_back(std::make_unique<mfem::ParMesh>(*mesh.back()));
+    Update();
+  }
+  mesh.back()->GeneralRefinement(refs, -1);
+  Update();
+  if (!iodata.solver.linear.mat_gmg && mesh.back()->Nonconforming())
+  {
+    mesh.back()->Rebalance();
+    Update();
+  }
+  return true;
+}
 
-  // Print some mesh information.
+void PrintMeshInfo(const IoData &iodata,
+                   const std::vector<std::unique_ptr<mfem::ParMesh>> &mesh)
+{
   mfem::Vector bbmin, bbmax;
   mesh[0]->GetBoundingBox(bbmin, bbmax);
   const double Lc = iodata.DimensionalizeValue(IoData::ValueType::LENGTH, 1.0);
@@ -606,119 +981,817 @@ void GetSurfaceNormal(mfem::ParMesh &mesh, const mfem::Array<int> &marker,
   // }
 }
 
-}  // namespace mesh
-
-namespace
-{
-
-std::unique_ptr<mfem::Mesh> LoadMesh(const std::string &path)
+MeshCache::MeshCache(MPI_Comm comm, const IoData &iodata) : path(iodata.model.mesh_cache)
 {
-  // Read the (serial) mesh from the given mesh file. Handle preparation for refinement and
-  // orientations here to avoid possible reorientations and reordering later on. MFEM
-  // supports a native mesh format (.mesh), VTK/VTU, Gmsh, as well as some others. We use
-  // built-in converters for the types we know, otherwise rely on MFEM to do the conversion
-  // or error out if not supported.
-  std::filesystem::path mfile(path);
-  if (mfile.extension() == ".mphtxt" || mfile.extension() == ".mphbin" ||
-      mfile.extension() == ".nas" || mfile.extension() == ".bdf")
+  if (path.empty())
+  {
+    return;
+  }
+  if (path.back() != '/')
   {
-    // Put translated mesh in temporary string buffer.
-    std::stringstream fi(std::stringstream::in | std::stringstream::out);
-    // fi << std::fixed;
-    fi << std::scientific;
-    fi.precision(MSH_FLT_PRECISION);
+    path += '/';
+  }
 
-#if 0
-    // Put translated mesh in temporary storage (directory is created and destroyed in
-    // calling function).
-    std::string tmp = iodata.problem.output;
-    if (tmp.back() != '/')
+  // Record all settings which affect the cached mesh, with lengths in mesh units. The
+  // original mesh and partitioning files are identified by their paths, sizes, and
+  // modification times (for each file of a mesh given as a directory).
+  std::ostringstream os;
+  os.precision(MSH_FLT_PRECISION);
+  auto AddFiles = [&os](const std::string &name, const std::string &file)
+  {
+    std::filesystem::path pfile = std::filesystem::absolute(file);
+    os << name << ": " << pfile.string() << '\n';
+    std::vector<std::filesystem::path> files;
+    if (std::filesystem::is_directory(pfile))
     {
-      tmp += '/';
+      for (const auto &entry : std::filesystem::recursive_directory_iterator(pfile))
+      {
+        if (entry.is_regular_file())
+        {
+          files.push_back(entry.path());
+        }
+      }
+      std::sort(files.begin(), files.end());
     }
-    tmp += "tmp/serial.msh";
-    std::ofstream fo(tmp);
-    // mfem::ofgzstream fo(tmp, true);  // Use zlib compression if available
-    // fo << std::fixed;
-    fo << std::scientific;
-    fo.precision(MSH_FLT_PRECISION);
-#endif
-
-    if (mfile.extension() == ".mphtxt" || mfile.extension() == ".mphbin")
+    else if (std::filesystem::is_regular_file(pfile))
     {
-      mesh::ConvertMeshComsol(path, fi);
-      // mesh::ConvertMeshComsol(path, fo);
+      files.push_back(pfile);
     }
-    else
+    for (const auto &f : files)
     {
-      mesh::ConvertMeshNastran(path, fi);
-      // mesh::ConvertMeshNastran(path, fo);
+      os << "File: " << f.string() << ' ' << std::filesystem::file_size(f) << ' '
+         << std::filesystem::last_write_time(f).time_since_epoch().count() << '\n';
     }
-
-#if 0
-    std::ifstream fi(tmp);
-    // mfem::ifgzstream fi(tmp);
-    if (!fi.good())
+  };
+  auto AddAttributes = [&os](const std::string &name, const auto &attributes)
+  {
+    os << name << ':';
+    for (auto attr : attributes)
     {
-      MFEM_ABORT("Unable to open translated mesh file \"" << tmp << "\"!");
+      os << ' ' << attr;
     }
-#endif
-    return std::make_unique<mfem::Mesh>(fi, 1, 1, true);
-  }
-  // Otherwise, just rely on MFEM load the mesh.
-  std::ifstream fi(path);
-  if (!fi.good())
+    os << '\n';
+  };
+  AddFiles("Mesh", iodata.model.mesh);
+  if (!iodata.model.partition.empty())
   {
-    MFEM_ABORT("Unable to open mesh file \"" << path << "\"!");
+    AddFiles("Partition", iodata.model.partition);
   }
-  std::unique_ptr mesh = std::make_unique<mfem::Mesh>(fi, 1, 1, true);
-  mesh->EnsureNodes();
-  return mesh;
-}
-
-void ReorderMesh(mfem::Mesh &mesh)
-{
-  mfem::Array<int> ordering;
 
-#if 0
-  // Gecko reordering.
-  Mpi::Print(\n);
-  mfem::Array<int> tentative;
-  int outer = 3, inner = 3, window = 4, period = 2;
-  double best_cost = mfem::infinity();
-  for (int i = 0; i < outer; i++)
+  // Material and boundary attributes determine the elements removed from the mesh and
+  // the interface boundary elements added to it, and the boundaries with boundary
+  // integrators and the ports determine the weighted partitioning.
+  AddAttributes("Domains", iodata.domains.attributes);
+  AddAttributes("Boundaries", iodata.boundaries.attributes);
+  AddAttributes("Farfield", iodata.boundaries.farfield.attributes);
+  for (const auto &data : iodata.boundaries.conductivity)
   {
-    int seed = i+1;
-    double cost = mesh.GetGeckoElementOrdering(tentative, inner, window, eriod, seed, true);
-    if (cost < best_cost)
+    AddAttributes("Conductivity", data.attributes);
+  }
+  for (const auto &data : iodata.boundaries.impedance)
+  {
+    AddAttributes("Impedance", data.attributes);
+  }
+  for (const auto &[idx, data] : iodata.boundaries.lumpedport)
+  {
+    for (const auto &node : data.nodes)
     {
-      ordering = tentative;
-      best_cost = cost;
+      AddAttributes("LumpedPort " + std::to_string(idx), node.attributes);
     }
   }
-  Mpi::Print("Final cost: {:e}\n", best_cost);
-#endif
-
-  // (Faster) Hilbert reordering.
-  mesh.GetHilbertElementOrdering(ordering);
-  mesh.ReorderElements(ordering);
-}
-
-std::unique_ptr<int[]> GetMeshPartitioning(mfem::Mesh &mesh, int size,
-                                           const std::string &partition)
-{
-  MFEM_VERIFY(size <= mesh.GetNE(), "Mesh partitioning must have parts <= mesh elements ("
-                                        << size << " vs. " << mesh.GetNE() << ")!");
-  if (partition.length() == 0)
+  for (const auto &[idx, data] : iodata.boundaries.waveport)
   {
-    const int part_method = 1;
-    std::unique_ptr<int[]> partitioning(mesh.GeneratePartitioning(size, part_method));
-    Mpi::Print("Finished partitioning mesh into {:d} subdomain{}\n", size,
-               (size > 1) ? "s" : "");
+    AddAttributes("WavePort " + std::to_string(idx), data.attributes);
+  }
+  os << "Processes: " << Mpi::Size(comm) << '\n'
+     << "WeightedPartitioning: " << iodata.model.weighted_partition << ' '
+     << iodata.model.localize_ports << '\n'
+     << "L0: " << iodata.model.L0 << '\n'
+     << "Lc: " << iodata.model.Lc << '\n'
+     << "ReorientTetMesh: " << iodata.model.reorient_tet << '\n'
+     << "ReorderElements: " << static_cast<int>(iodata.model.reorder) << '\n'
+     << "GeometricMultigrid: " << iodata.solver.linear.mat_gmg << '\n'
+     << "Nonconforming: " << UseNonconformingMesh(iodata) << '\n'
+     << "UniformLevels: " << iodata.model.refinement.uniform_ref_levels << '\n';
+  for (const auto &box : iodata.model.refinement.GetBoxes())
+  {
+    os << "Box: " << box.ref_levels;
+    for (auto x : box.bbmin)
+    {
+      os << ' ' << x;
+    }
+    for (auto x : box.bbmax)
+    {
+      os << ' ' << x;
+    }
+    os << '\n';
+  }
+  for (const auto &sphere : iodata.model.refinement.GetSpheres())
+  {
+    os << "Sphere: " << sphere.ref_levels << ' ' << sphere.r;
+    for (auto x : sphere.center)
+    {
+      os << ' ' << x;
+    }
+    os << '\n';
+  }
+  key = os.str();
+}
+
+bool MeshCache::Load(MPI_Comm comm, IoData &iodata,
+                     std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const
+{
+  MFEM_VERIFY(mesh.empty(), "Mesh hierarchy should be empty before loading from cache!");
+  if (path.empty())
+  {
+    return false;
+  }
+
+  // Check on the root process that the cache exists and was created with the same
+  // settings. The metadata file contains a flag for whether the mesh is refined, the
+  // characteristic length in mesh units, and the settings.
+  auto t0 = timer.Now();
+  int refined = -1;
+  double Lc = 0.0;
+  if (Mpi::Root(comm))
+  {
+    std::ifstream fi(path + "cache.txt");
+    std::string line;
+    int r;
+    if (fi >> r >> Lc && std::getline(fi, line))
+    {
+      std::string saved((std::istreambuf_iterator<char>(fi)),
+                        std::istreambuf_iterator<char>());
+      refined = (saved == key) ? r : -1;
+    }
+  }
+  Mpi::Broadcast(1, &refined, 0, comm);
+  Mpi::Broadcast(1, &Lc, 0, comm);
+  if (refined < 0)
+  {
+    Mpi::Print(comm, "\nNo matching mesh cache found in \"{}\"\n", path);
+    return false;
+  }
+
+  std::string pfile = mfem::MakeParFilename(path + "mesh.", Mpi::Rank(comm), ".mesh", 6);
+  mfem::ifgzstream fi(pfile);
+  if (!fi.good())
+  {
+    MFEM_ABORT("Unable to open cached mesh file \"" << pfile << "\"!");
+  }
+  mesh.push_back(std::make_unique<mfem::ParMesh>(comm, fi));
+
+  // The cached mesh is nondimensionalized, so restore the mesh length units.
+  for (int i = 0; i < mesh[0]->GetNV(); i++)
+  {
+    double *v = mesh[0]->GetVertex(i);
+    std::transform(v, v + mesh[0]->SpaceDimension(), v, [Lc](double x) { return x * Lc; });
+  }
+  if (mesh[0]->GetNodes())
+  {
+    *mesh[0]->GetNodes() *= Lc;
+  }
+  iodata.model.Lc = Lc;
+  Mpi::Barrier(comm);
+  timer.io_time += timer.Now() - t0;
+  Mpi::Print(comm, "\nLoaded {} mesh from cache in \"{}\"\n",
+             refined ? "refined" : "coarse", path);
+  return refined;
+}
+
+void MeshCache::Save(const IoData &iodata,
+                     const std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+                     Timer &timer) const
+{
+  if (path.empty())
+  {
+    return;
+  }
+  const mfem::ParMesh &smesh = *mesh[0];
+  MPI_Comm comm = smesh.GetComm();
+  if (smesh.Nonconforming())
+  {
+    Mpi::Warning(comm, "Nonconforming meshes are not supported for mesh caching!\n");
+    return;
+  }
+
+  // Remove any existing metadata first and write it last, so that a partially written
+  // cache is never loaded.
+  auto t0 = timer.Now();
+  if (Mpi::Root(comm))
+  {
+    if (!std::filesystem::exists(path))
+    {
+      std::filesystem::create_directories(path);
+    }
+    std::filesystem::remove(path + "cache.txt");
+  }
+  Mpi::Barrier(comm);
+  {
+    std::string pfile = mfem::MakeParFilename(path + "mesh.", Mpi::Rank(comm), ".mesh", 6);
+    mfem::ofgzstream fo(pfile, true);  // Use zlib compression if available
+    if (!fo.good())
+    {
+      MFEM_ABORT("Unable to open cached mesh file \"" << pfile << "\" for writing!");
+    }
+    fo.precision(MSH_FLT_PRECISION);
+    smesh.ParPrint(fo);
+  }
+  Mpi::Barrier(comm);
+  if (Mpi::Root(comm))
+  {
+    std::ofstream fo(path + "cache.txt");
+    fo.precision(MSH_FLT_PRECISION);
+    fo << (mesh.size() == 1) << ' '
+       << iodata.DimensionalizeValue(IoData::ValueType::LENGTH, 1.0) / iodata.model.L0
+       << '\n'
+       << key;
+  }
+  Mpi::Barrier(comm);
+  timer.io_time += timer.Now() - t0;
+}
+
+}  // namespace mesh
+
+namespace
+{
+
+std::unique_ptr<mfem::Mesh> LoadMesh(const std::string &path)
+{
+  // Read the (serial) mesh from the given mesh file. Handle preparation for refinement and
+  // orientations here to avoid possible reorientations and reordering later on. MFEM
+  // supports a native mesh format (.mesh), VTK/VTU, Gmsh, as well as some others. We use
+  // built-in converters for the types we know, otherwise rely on MFEM to do the conversion
+  // or error out if not supported.
+  std::filesystem::path mfile(path);
+  if (mfile.extension() == ".mphtxt" || mfile.extension() == ".mphbin" ||
+      mfile.extension() == ".nas" || mfile.extension() == ".bdf")
+  {
+    // Converted meshes are cached next to the original mesh file, so repeated simulations
+    // on the same mesh skip the conversion. The cache is invalidated by any change to the
+    // original file since its name contains a hash of the file contents.
+    std::string cache = GetMeshCacheFilename(mfile);
+    if (std::filesystem::exists(cache))
+    {
+      mfem::ifgzstream fi(cache);
+      if (fi.good())
+      {
+        Mpi::Print("Loading converted mesh from cache file \"{}\"\n", cache);
+        return std::make_unique<mfem::Mesh>(fi, 1, 1, true);
+      }
+    }
+
+    // Read the mesh directly, without an intermediate Gmsh text format.
+    std::unique_ptr<mfem::Mesh> smesh;
+    if (mfile.extension() == ".mphtxt" || mfile.extension() == ".mphbin")
+    {
+      smesh = mesh::LoadMeshComsol(path);
+    }
+    else
+    {
+      smesh = mesh::LoadMeshNastran(path);
+    }
+    WriteMeshCache(cache, *smesh);
+    return smesh;
+  }
+  // Otherwise, just rely on MFEM load the mesh.
+  std::ifstream fi(path);
+  if (!fi.good())
+  {
+    MFEM_ABORT("Unable to open mesh file \"" << path << "\"!");
+  }
+  std::unique_ptr mesh = std::make_unique<mfem::Mesh>(fi, 1, 1, true);
+  mesh->EnsureNodes();
+  return mesh;
+}
+
+std::string GetMeshCacheFilename(const std::filesystem::path &mfile)
+{
+  // The hash of the mesh file contents is recorded in an index file next to the mesh file
+  // together with the file size and modification time, so the mesh file is only read
+  // again to compute the hash when these change.
+  const std::string prefix = "." + mfile.filename().string();
+  const std::filesystem::path index = mfile.parent_path() / (prefix + ".cache");
+  std::error_code ec_size, ec_time;
+  const auto size = std::filesystem::file_size(mfile, ec_size);
+  const auto mtime =
+      std::filesystem::last_write_time(mfile, ec_time).time_since_epoch().count();
+  MFEM_VERIFY(!ec_size && !ec_time,
+              "Unable to open mesh file \"" << mfile.string() << "\"!");
+  std::string key;
+  {
+    std::ifstream fi(index);
+    std::uintmax_t s;
+    decltype(mtime) m;
+    int v;
+    std::string k;
+    if (fi >> s >> m >> v >> k && s == size && m == mtime && v == MESH_CACHE_VERSION &&
+        k.length() == 16)
+    {
+      key = k;
+    }
+  }
+  if (key.empty())
+  {
+    // Compute a 64-bit FNV-1a hash of the mesh file contents and the cache version.
+    std::ifstream fi(mfile, std::ios::binary);
+    if (!fi.good())
+    {
+      MFEM_ABORT("Unable to open mesh file \"" << mfile.string() << "\"!");
+    }
+    std::uint64_t hash = 14695981039346656037ull;
+    auto Hash = [&hash](const char *data, std::size_t n)
+    {
+      for (std::size_t i = 0; i < n; i++)
+      {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+      }
+    };
+    std::vector<char> buffer(1 << 20);
+    while (fi.read(buffer.data(), buffer.size()) || fi.gcount() > 0)
+    {
+      Hash(buffer.data(), static_cast<std::size_t>(fi.gcount()));
+    }
+    const std::string version = std::to_string(MESH_CACHE_VERSION);
+    Hash(version.data(), version.length());
+    std::ostringstream os;
+    os << std::hex << std::setfill('0') << std::setw(16) << hash;
+    key = os.str();
+
+    // Failure to write the index is not an error.
+    std::ofstream fo(index);
+    fo << size << ' ' << mtime << ' ' << MESH_CACHE_VERSION << ' ' << key << '\n';
+  }
+  return (mfile.parent_path() / (prefix + "." + key + ".mesh")).string();
+}
+
+void WriteMeshCache(const std::string &cache, const mfem::Mesh &mesh)
+{
+  // Write to a temporary file which is then renamed, so that simulations running
+  // concurrently never read a partially written cache file. Failure to write the cache is
+  // not an error.
+  std::string tmp = cache + ".tmp" + std::to_string(std::random_device()());
+  {
+    mfem::ofgzstream fo(tmp, true);  // Use zlib compression if available
+    if (!fo.good())
+    {
+      Mpi::Warning("Unable to write converted mesh cache file \"{}\"!\n", cache);
+      return;
+    }
+    fo.precision(MSH_FLT_PRECISION);
+    mesh.Print(fo);
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, cache, ec);
+  if (ec)
+  {
+    std::filesystem::remove(tmp, ec);
+    Mpi::Warning("Unable to write converted mesh cache file \"{}\"!\n", cache);
+    return;
+  }
+
+  // Remove the cache files for previous versions of the same mesh file, named
+  // .<name>.<hash>.mesh with a 16 character hash.
+  const std::filesystem::path pcache(cache);
+  const std::string name = pcache.filename().string();
+  const std::string prefix = name.substr(0, name.length() - 22);
+  const std::filesystem::path dir =
+      pcache.parent_path().empty() ? std::filesystem::path(".") : pcache.parent_path();
+  for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+  {
+    const std::string file = entry.path().filename().string();
+    if (file != name && file.length() == name.length() &&
+        file.compare(0, prefix.length() + 1, prefix + ".") == 0 &&
+        file.compare(file.length() - 5, 5, ".mesh") == 0)
+    {
+      std::error_code ec_remove;
+      std::filesystem::remove(entry.path(), ec_remove);
+    }
+  }
+}
+
+void ReorderMesh(mfem::Mesh &mesh, const IoData &iodata,
+                 std::unique_ptr<int[]> &partitioning)
+{
+  if (iodata.model.reorder == ModelData::ReorderType::NONE)
+  {
+    return;
+  }
+  mfem::Array<int> ordering;
+
+#if 0
+  // Gecko reordering.
+  Mpi::Print(\n);
+  mfem::Array<int> tentative;
+  int outer = 3, inner = 3, window = 4, period = 2;
+  double best_cost = mfem::infinity();
+  for (int i = 0; i < outer; i++)
+  {
+    int seed = i+1;
+    double cost = mesh.GetGeckoElementOrdering(tentative, inner, window, eriod, seed, true);
+    if (cost < best_cost)
+    {
+      ordering = tentative;
+      best_cost = cost;
+    }
+  }
+  Mpi::Print("Final cost: {:e}\n", best_cost);
+#endif
+
+  if (iodata.model.reorder == ModelData::ReorderType::RCM)
+  {
+    // Bandwidth-reducing reordering based on element connectivity.
+    GetRCMElementOrdering(mesh, ordering);
+  }
+  else
+  {
+    // (Faster) Hilbert reordering.
+    mesh.GetHilbertElementOrdering(ordering);
+  }
+  mesh.ReorderElements(ordering);
+
+  // The ordering maps the original to the new element indices.
+  if (partitioning)
+  {
+    std::unique_ptr<int[]> new_partitioning = std::make_unique<int[]>(mesh.GetNE());
+    for (int e = 0; e < mesh.GetNE(); e++)
+    {
+      new_partitioning[ordering[e]] = partitioning[e];
+    }
+    partitioning = std::move(new_partitioning);
+  }
+}
+
+void GetRCMElementOrdering(mfem::Mesh &mesh, mfem::Array<int> &ordering)
+{
+  // Elements are connected in the dual graph if they share a face. Each connected component
+  // is numbered by a breadth-first search from a pseudo-peripheral element (George and
+  // Liu), visiting neighbors in order of increasing degree, and the final ordering is
+  // reversed.
+  const mfem::Table &elem_to_elem = mesh.ElementToElementTable();
+  const int ne = mesh.GetNE();
+  std::vector<int> perm, level, nbrs;
+  std::vector<int> mark(ne, -1);
+  std::vector<bool> numbered(ne, false);
+  perm.reserve(ne);
+  int stamp = 0;
+  auto BreadthFirstSearch = [&](int root, std::vector<int> &order, int &last_begin)
+  {
+    // Returns the number of levels of the level structure rooted at the given element and
+    // the index in the visitation order of the first element of the last level.
+    order.clear();
+    order.push_back(root);
+    mark[root] = stamp;
+    int depth = 0;
+    std::size_t begin = 0;
+    last_begin = 0;
+    while (begin < order.size())
+    {
+      const std::size_t end = order.size();
+      for (std::size_t i = begin; i < end; i++)
+      {
+        const int *row = elem_to_elem.GetRow(order[i]);
+        nbrs.clear();
+        for (int j = 0; j < elem_to_elem.RowSize(order[i]); j++)
+        {
+          if (!numbered[row[j]] && mark[row[j]] != stamp)
+          {
+            mark[row[j]] = stamp;
+            nbrs.push_back(row[j]);
+          }
+        }
+        std::sort(nbrs.begin(), nbrs.end(), [&elem_to_elem](int a, int b)
+                  { return elem_to_elem.RowSize(a) < elem_to_elem.RowSize(b); });
+        order.insert(order.end(), nbrs.begin(), nbrs.end());
+      }
+      last_begin = static_cast<int>(begin);
+      begin = end;
+      depth++;
+    }
+    stamp++;
+    return depth;
+  };
+  for (int e = 0; e < ne; e++)
+  {
+    if (numbered[e])
+    {
+      continue;
+    }
+
+    // Find a pseudo-peripheral element: restart from the element of minimum degree in the
+    // last level as long as the number of levels increases.
+    int last_begin;
+    int depth = BreadthFirstSearch(e, level, last_begin);
+    while (true)
+    {
+      int next = level[last_begin];
+      for (std::size_t i = last_begin; i < level.size(); i++)
+      {
+        if (elem_to_elem.RowSize(level[i]) < elem_to_elem.RowSize(next))
+        {
+          next = level[i];
+        }
+      }
+      std::vector<int> next_level;
+      int next_last_begin;
+      int next_depth = BreadthFirstSearch(next, next_level, next_last_begin);
+      if (next_depth <= depth)
+      {
+        break;
+      }
+      depth = next_depth;
+      level = std::move(next_level);
+      last_begin = next_last_begin;
+    }
+
+    // The level structure rooted at the pseudo-peripheral element is the Cuthill-McKee
+    // ordering for this component.
+    for (auto i : level)
+    {
+      numbered[i] = true;
+      perm.push_back(i);
+    }
+  }
+  MFEM_VERIFY(static_cast<int>(perm.size()) == ne,
+              "Reverse Cuthill-McKee ordering did not number all mesh elements!");
+  ordering.SetSize(ne);
+  for (int i = 0; i < ne; i++)
+  {
+    ordering[perm[ne - 1 - i]] = i;
+  }
+}
+
+std::unique_ptr<int[]> GetMeshPartitioning(mfem::Mesh &mesh, int size,
+                                           const IoData &iodata)
+{
+  MFEM_VERIFY(size <= mesh.GetNE(), "Mesh partitioning must have parts <= mesh elements ("
+                                        << size << " vs. " << mesh.GetNE() << ")!");
+  if (iodata.model.weighted_partition)
+  {
+    std::unique_ptr<int[]> partitioning = GetWeightedMeshPartitioning(mesh, size, iodata);
+    if (partitioning)
+    {
+      return partitioning;
+    }
+  }
+  const int part_method = 1;
+  std::unique_ptr<int[]> partitioning(mesh.GeneratePartitioning(size, part_method));
+  Mpi::Print("Finished partitioning mesh into {:d} subdomain{}\n", size,
+             (size > 1) ? "s" : "");
+  return partitioning;
+}
+
+std::unique_ptr<int[]> GetWeightedMeshPartitioning(mfem::Mesh &mesh, int size,
+                                                   const IoData &iodata)
+{
+#if defined(MFEM_USE_METIS_5)
+  // Relative costs of an element and of its faces on boundaries with boundary integrators.
+  // Elements adjacent to the same port are connected with a large edge weight when the
+  // ports are to be kept within as few subdomains as possible.
+  constexpr idx_t ELEM_WEIGHT = 4, BDR_WEIGHT = 1, WAVE_PORT_WEIGHT = 4;
+  constexpr idx_t PORT_EDGE_WEIGHT = 100;
+  const int dim = mesh.Dimension(), sdim = mesh.SpaceDimension();
+  const int ne = mesh.GetNE();
+
+  // Estimate the number of levels of region-based refinement for each element, based on
+  // its vertices in the original mesh. Each level of refinement multiplies the number of
+  // elements (and unknowns) by approximately 2ᵈ.
+  const auto &boxes = iodata.model.refinement.GetBoxes();
+  const auto &spheres = iodata.model.refinement.GetSpheres();
+  std::vector<int> levels(ne, 0);
+  if (!boxes.empty() || !spheres.empty())
+  {
+    mfem::Array<int> verts;
+    for (int e = 0; e < ne; e++)
+    {
+      mesh.GetElementVertices(e, verts);
+      for (int j = 0; j < verts.Size(); j++)
+      {
+        const double *coord = mesh.GetVertex(verts[j]);
+        for (const auto &box : boxes)
+        {
+          if (box.ref_levels > levels[e])
+          {
+            int d = 0;
+            for (; d < sdim; d++)
+            {
+              if (coord[d] < box.bbmin[d] || coord[d] > box.bbmax[d])
+              {
+                break;
+              }
+            }
+            if (d == sdim)
+            {
+              levels[e] = box.ref_levels;
+            }
+          }
+        }
+        for (const auto &sphere : spheres)
+        {
+          if (sphere.ref_levels > levels[e])
+          {
+            double dist = 0.0;
+            for (int d = 0; d < sdim; d++)
+            {
+              double s = coord[d] - sphere.center[d];
+              dist += s * s;
+            }
+            if (dist <= sphere.r * sphere.r)
+            {
+              levels[e] = sphere.ref_levels;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Boundary attributes with boundary integrators, and the port index for port boundaries.
+  const int n_bdr = mesh.bdr_attributes.Size() ? mesh.bdr_attributes.Max() : 0;
+  std::vector<idx_t> bdr_weight(n_bdr, 0);
+  std::vector<int> bdr_port(n_bdr, -1);
+  auto MarkBoundary = [&](const std::vector<int> &attributes, idx_t weight, int port)
+  {
+    for (auto attr : attributes)
+    {
+      if (attr > 0 && attr <= n_bdr)
+      {
+        bdr_weight[attr - 1] = std::max(bdr_weight[attr - 1], weight);
+        if (port >= 0)
+        {
+          bdr_port[attr - 1] = port;
+        }
+      }
+    }
+  };
+  MarkBoundary(iodata.boundaries.farfield.attributes, BDR_WEIGHT, -1);
+  for (const auto &data : iodata.boundaries.conductivity)
+  {
+    MarkBoundary(data.attributes, BDR_WEIGHT, -1);
+  }
+  for (const auto &data : iodata.boundaries.impedance)
+  {
+    MarkBoundary(data.attributes, BDR_WEIGHT, -1);
+  }
+  int port = 0;
+  for (const auto &[idx, data] : iodata.boundaries.lumpedport)
+  {
+    for (const auto &node : data.nodes)
+    {
+      MarkBoundary(node.attributes, BDR_WEIGHT, port);
+    }
+    port++;
+  }
+  for (const auto &[idx, data] : iodata.boundaries.waveport)
+  {
+    MarkBoundary(data.attributes, WAVE_PORT_WEIGHT, port++);
+  }
+
+  // Compute the element weights. The scaled weights are saturated such that the total
+  // weight over all elements still fits in idx_t, as required by METIS.
+  const std::int64_t max_weight =
+      std::max<std::int64_t>(std::numeric_limits<idx_t>::max() / (ne + 1), 1);
+  auto Scale = [max_weight](idx_t weight, int shift)
+  {
+    std::int64_t scaled = weight;
+    for (int k = 0; k < shift && scaled < max_weight; k++)
+    {
+      scaled <<= 1;
+    }
+    return std::min(scaled, max_weight);
+  };
+  std::vector<idx_t> vwgt(ne);
+  std::vector<int> elem_port(ne, -1);
+  for (int e = 0; e < ne; e++)
+  {
+    vwgt[e] = static_cast<idx_t>(Scale(ELEM_WEIGHT, dim * levels[e]));
+  }
+  for (int be = 0; be < mesh.GetNBE(); be++)
+  {
+    const int attr = mesh.GetBdrAttribute(be);
+    if (bdr_weight[attr - 1] == 0)
+    {
+      continue;
+    }
+    int f, o, e1, e2;
+    mesh.GetBdrElementFace(be, &f, &o);
+    mesh.GetFaceElements(f, &e1, &e2);
+    for (auto e : {e1, e2})
+    {
+      if (e >= 0)
+      {
+        vwgt[e] = static_cast<idx_t>(
+            std::min(vwgt[e] + Scale(bdr_weight[attr - 1], (dim - 1) * levels[e]),
+                     max_weight));
+        if (iodata.model.localize_ports && bdr_port[attr - 1] >= 0)
+        {
+          elem_port[e] = bdr_port[attr - 1];
+        }
+      }
+    }
+  }
+
+  // Construct the element dual graph (elements connected through faces) with edge weights.
+  const mfem::Table &e2e = mesh.ElementToElementTable();
+  std::vector<idx_t> xadj(e2e.GetI(), e2e.GetI() + ne + 1);
+  std::vector<idx_t> adjncy(e2e.GetJ(), e2e.GetJ() + e2e.Size_of_connections());
+  std::vector<idx_t> adjwgt(adjncy.size());
+  for (int e = 0; e < ne; e++)
+  {
+    for (idx_t k = xadj[e]; k < xadj[e + 1]; k++)
+    {
+      adjwgt[k] = (elem_port[e] >= 0 && elem_port[e] == elem_port[adjncy[k]])
+                      ? PORT_EDGE_WEIGHT
+                      : 1;
+    }
+  }
+
+  // Partition the weighted graph.
+  std::vector<idx_t> part(ne, 0);
+  if (size > 1)
+  {
+    idx_t nvtxs = ne, ncon = 1, nparts = size, objval;
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    int err = METIS_PartGraphKway(&nvtxs, &ncon, xadj.data(), adjncy.data(), vwgt.data(),
+                                  nullptr, adjwgt.data(), &nparts, nullptr, nullptr,
+                                  options, &objval, part.data());
+    if (err != METIS_OK)
+    {
+      Mpi::Warning("Weighted mesh partitioning failed (METIS error {:d}), using unweighted "
+                   "partitioning!\n",
+                   err);
+      return nullptr;
+    }
+  }
+  std::vector<idx_t> part_weight(size, 0);
+  for (int e = 0; e < ne; e++)
+  {
+    part_weight[part[e]] += vwgt[e];
+  }
+  if (std::find(part_weight.begin(), part_weight.end(), 0) != part_weight.end())
+  {
+    Mpi::Warning("Weighted mesh partitioning produced empty subdomains, using unweighted "
+                 "partitioning!\n");
+    return nullptr;
+  }
+  auto partitioning = std::make_unique<int[]>(ne);
+  std::copy(part.begin(), part.end(), partitioning.get());
+  const double avg_weight =
+      std::accumulate(part_weight.begin(), part_weight.end(), 0.0) / size;
+  Mpi::Print("Finished weighted partitioning of mesh into {:d} subdomain{} (max/avg "
+             "subdomain weight = {:.3f})\n",
+             size, (size > 1) ? "s" : "",
+             *std::max_element(part_weight.begin(), part_weight.end()) / avg_weight);
+  return partitioning;
+#else
+  Mpi::Warning("Weighted mesh partitioning requires MFEM built with METIS 5, using "
+               "unweighted partitioning!\n");
+  return nullptr;
+#endif
+}
+
+std::unique_ptr<int[]> ReadMeshPartitioning(const std::string &partition, int ne, int np)
+{
+  // Binary partitioning files, as written by WriteMeshPartitioning, are identified by a
+  // header string and have the format (native endianness):
+  //
+  //   PALACE_PART (including the terminating null character)
+  //   <NE> <NPART> (as int32_t)
+  //   <part[0]> ... <part[NE-1]> (as int32_t)
+  //
+  std::ifstream part_ifs(partition, std::ios::binary);
+  MFEM_VERIFY(part_ifs.good(),
+              "Unable to open mesh partitioning file " << partition << "!");
+  char header[sizeof(PARTITION_HEADER)] = {};
+  part_ifs.read(header, sizeof(header));
+  auto partitioning = std::make_unique<int[]>(ne);
+  if (part_ifs.gcount() == sizeof(header) &&
+      std::equal(header, header + sizeof(header), PARTITION_HEADER))
+  {
+    std::int32_t nel, npart;
+    part_ifs.read(reinterpret_cast<char *>(&nel), sizeof(nel));
+    part_ifs.read(reinterpret_cast<char *>(&npart), sizeof(npart));
+    MFEM_VERIFY(part_ifs.good() && nel == ne,
+                "Invalid partitioning file (number of elements)!");
+    MFEM_VERIFY(npart == np, "Invalid partitioning file (number of processors)!");
+    std::vector<std::int32_t> part(ne);
+    part_ifs.read(reinterpret_cast<char *>(part.data()),
+                  static_cast<std::streamsize>(ne * sizeof(std::int32_t)));
+    MFEM_VERIFY(part_ifs.good(), "Invalid partitioning file (unexpected end of file)!");
+    for (int i = 0; i < ne; i++)
+    {
+      MFEM_VERIFY(part[i] >= 0 && part[i] < np,
+                  "Invalid partitioning file (processor " << part[i] << " for element "
+                                                          << i << ")!");
+      partitioning[i] = part[i];
+    }
     return partitioning;
   }
-  // User can optionally specify a mesh partitioning file as generated from the MFEM
-  // mesh-explorer miniapp, for example. It has the format:
+
+  // Otherwise, the file is a text file as generated from the MFEM mesh-explorer miniapp,
+  // for example. It has the format:
   //
   //   number_of_elements <NE>
   //   number_of_processors <NPART>
@@ -726,247 +1799,116 @@ std::unique_ptr<int[]> GetMeshPartitioning(mfem::Mesh &mesh, int size,
   //     ...
   //   <part[NE-1]>
   //
-  int nel, np;
-  std::ifstream part_ifs(partition);
+  int nel, npart;
+  part_ifs.clear();
+  part_ifs.seekg(0);
   part_ifs.ignore(std::numeric_limits<std::streamsize>::max(), ' ');
   part_ifs >> nel;
-  if (nel != mesh.GetNE())
+  if (nel != ne)
   {
     MFEM_ABORT("Invalid partitioning file (number of elements)!");
   }
   part_ifs.ignore(std::numeric_limits<std::streamsize>::max(), ' ');
-  part_ifs >> np;
-  if (np != size)
+  part_ifs >> npart;
+  if (npart != np)
   {
     MFEM_ABORT("Invalid partitioning file (number of processors)!");
   }
-  auto partitioning = std::make_unique<int[]>(mesh.GetNE());
-  int i = 0;
-  while (i < mesh.GetNE())
+  for (int i = 0; i < ne; i++)
+  {
+    part_ifs >> partitioning[i];
+    MFEM_VERIFY(part_ifs && partitioning[i] >= 0 && partitioning[i] < np,
+                "Invalid partitioning file (processor for element " << i << ")!");
+  }
+  return partitioning;
+}
+
+void WriteMeshPartitioning(const std::string &partition, const int *partitioning, int ne,
+                           int np)
+{
+  std::vector<std::int32_t> part(partitioning, partitioning + ne);
+  const std::int32_t nel = ne, npart = np;
+  std::ofstream part_ofs(partition, std::ios::binary);
+  part_ofs.write(PARTITION_HEADER, sizeof(PARTITION_HEADER));
+  part_ofs.write(reinterpret_cast<const char *>(&nel), sizeof(nel));
+  part_ofs.write(reinterpret_cast<const char *>(&npart), sizeof(npart));
+  part_ofs.write(reinterpret_cast<const char *>(part.data()),
+                 static_cast<std::streamsize>(ne * sizeof(std::int32_t)));
+  if (!part_ofs.good())
   {
-    part_ifs >> partitioning[i++];
+    Mpi::Warning("Unable to write mesh partitioning file \"{}\"!\n", partition);
+    return;
   }
-  Mpi::Print("Read mesh partitioning into {:d} subdomain{} from disk\n", size,
-             (size > 1) ? "s" : "");
-  return partitioning;
+  Mpi::Print("Wrote mesh partitioning to \"{}\"\n", partition);
 }
 
-std::map<int, std::array<int, 2>> CheckMesh(std::unique_ptr<mfem::Mesh> &orig_mesh,
-                                            const std::unique_ptr<int[]> &partitioning,
-                                            const IoData &iodata, bool clean_elem,
-                                            bool add_bdr, bool add_subdomain)
+std::vector<int> CleanMesh(std::unique_ptr<mfem::Mesh> &orig_mesh, const IoData &iodata)
 {
-  // - Check that all external boundaries of the mesh have a corresponding boundary
-  //   condition.
-  // - If desired, create a new mesh which has added boundary elements for all material
-  //   interfaces if these elements do not yet exist.
-  // - If desired, create a new mesh which has removed all domain elements which do not have
-  //   an associated material property specified in the input file.
-  MFEM_VERIFY(orig_mesh->Dimension() == 3 && !orig_mesh->Nonconforming(),
-              "Nonconforming or 2D meshes have not been tested yet!");
+  // Delete domain and boundary elements which have no associated material or BC attribute
+  // from the mesh.
+  MFEM_VERIFY(!orig_mesh->Nonconforming(),
+              "Removing domain elements is not supported for nonconforming meshes!");
   mfem::Array<int> mat_marker, bdr_marker;
   GetUsedAttributeMarkers(iodata, orig_mesh->attributes.Max(),
                           orig_mesh->bdr_attributes.Max(), mat_marker, bdr_marker);
-  bool warn = false;
-  for (int be = 0; be < orig_mesh->GetNBE(); be++)
+  int new_ne = orig_mesh->GetNE();
+  mfem::Array<bool> elem_delete(orig_mesh->GetNE());
+  elem_delete = false;
+  for (int e = 0; e < orig_mesh->GetNE(); e++)
   {
-    int attr = orig_mesh->GetBdrAttribute(be);
-    if (!bdr_marker[attr - 1])
+    int attr = orig_mesh->GetAttribute(e);
+    if (!mat_marker[attr - 1])
     {
-      int f, o, e1, e2;
-      orig_mesh->GetBdrElementFace(be, &f, &o);
-      orig_mesh->GetFaceElements(f, &e1, &e2);
-      if (e1 < 0 || e2 < 0)  // Internal boundary elements are allowed to have no BC
-      {
-        warn = true;
-        break;
-      }
+      elem_delete[e] = true;
+      new_ne--;
     }
   }
-  if (warn)
-  {
-    Mpi::Warning("One or more external boundary attributes has no associated boundary "
-                 "condition!\n\"PMC\"/\"ZeroCharge\" condition is assumed!\n");
-  }
-
-  // Mapping from new interface boundary attribute tags to vector of neighboring domain
-  // attributes (when adding new boundary elements).
-  std::map<int, std::array<int, 2>> new_attr_map;
-  if (!clean_elem && !add_bdr && !add_subdomain)
+  if (new_ne == orig_mesh->GetNE())
   {
-    return new_attr_map;
+    return {};
   }
 
-  // Count deleted or added domain and boundary elements.
-  int new_ne = orig_mesh->GetNE();
+  // Make sure to remove any boundary elements which are no longer attached to elements in
+  // the domain.
   int new_nbdr = orig_mesh->GetNBE();
-  mfem::Array<bool> elem_delete, bdr_delete;
-  mfem::Array<int> orig_bdr_faces, add_bdr_faces;
-  elem_delete.SetSize(orig_mesh->GetNE(), false);
-  bdr_delete.SetSize(orig_mesh->GetNBE(), false);
-  orig_bdr_faces.SetSize(orig_mesh->GetNumFaces(), -1);
+  mfem::Array<bool> bdr_delete(orig_mesh->GetNBE());
+  bdr_delete = false;
   for (int be = 0; be < orig_mesh->GetNBE(); be++)
   {
-    int f, o;
+    int f, o, e1, e2;
     orig_mesh->GetBdrElementFace(be, &f, &o);
-    MFEM_VERIFY(orig_bdr_faces[f] < 0,
-                "Mesh should not define boundary elements multiple times!");
-    orig_bdr_faces[f] = be;
-  }
-  if (add_bdr || add_subdomain)
-  {
-    add_bdr_faces.SetSize(orig_mesh->GetNumFaces(), -1);
-  }
-
-  if (clean_elem)
-  {
-    // Delete domain and boundary elements which have no associated material or BC attribute
-    // from the mesh.
-    for (int e = 0; e < orig_mesh->GetNE(); e++)
-    {
-      int attr = orig_mesh->GetAttribute(e);
-      if (!mat_marker[attr - 1])
-      {
-        elem_delete[e] = true;
-        new_ne--;
-      }
-    }
-
-    // Make sure to remove any boundary elements which are no longer attached to elements in
-    // the domain.
-    for (int f = 0; f < orig_mesh->GetNumFaces(); f++)
-    {
-      const int &be = orig_bdr_faces[f];
-      if (be >= 0)
-      {
-        int e1, e2;
-        orig_mesh->GetFaceElements(f, &e1, &e2);
-        if ((e1 < 0 || elem_delete[e1]) && (e2 < 0 || elem_delete[e2]))
-        {
-          // Mpi::Print("Deleting an unattached boundary element!\n");
-          bdr_delete[be] = true;
-          new_nbdr--;
-        }
-      }
-    }
-    if (new_ne < orig_mesh->GetNE())
-    {
-      Mpi::Print("Removed {:d} unmarked domain elements from the mesh\n",
-                 orig_mesh->GetNE() - new_ne);
-    }
-    if (new_nbdr < orig_mesh->GetNBE())
-    {
-      Mpi::Print("Removed {:d} unattached boundary elements from the mesh\n",
-                 orig_mesh->GetNBE() - new_nbdr);
-    }
-  }
-  int new_ne_step1 = new_ne;
-  int new_nbdr_step1 = new_nbdr;
-
-  if (add_bdr)
-  {
-    // Add new boundary elements at material interfaces or on the exterior boundary of the
-    // simulation domain, if there is not already a boundary element present.
-    MFEM_VERIFY(!orig_mesh->Nonconforming(), "Adding material interface boundary elements "
-                                             "is not supported for nonconforming meshes!");
-    int add_bdr_ext = 0, add_bdr_int = 0;
-    for (int f = 0; f < orig_mesh->GetNumFaces(); f++)
-    {
-      const int &be = orig_bdr_faces[f];
-      if (be < 0 && add_bdr_faces[f] < 0)
-      {
-        int e1, e2;
-        orig_mesh->GetFaceElements(f, &e1, &e2);
-        if (e1 < 0 || elem_delete[e1] || e2 < 0 || elem_delete[e2])
-        {
-          // Mpi::Print("Adding exterior boundary element!\n");
-          add_bdr_faces[f] = 1;
-          add_bdr_ext++;
-        }
-        else if (orig_mesh->GetAttribute(e1) != orig_mesh->GetAttribute(e2))
-        {
-          // Add new boundary element at material interface between two domains.
-          // Mpi::Print("Adding material interface boundary element!\n");
-          add_bdr_faces[f] = 1;
-          add_bdr_int++;
-        }
-      }
-    }
-    new_nbdr += (add_bdr_ext + add_bdr_int);
-    if (add_bdr_ext > 0)
-    {
-      Mpi::Print("Added {:d} boundary elements for exterior boundaries to the mesh\n",
-                 add_bdr_ext);
-    }
-    if (add_bdr_int > 0)
+    orig_mesh->GetFaceElements(f, &e1, &e2);
+    if ((e1 < 0 || elem_delete[e1]) && (e2 < 0 || elem_delete[e2]))
     {
-      Mpi::Print("Added {:d} boundary elements for material interfaces to the mesh\n",
-                 add_bdr_int);
+      bdr_delete[be] = true;
+      new_nbdr--;
     }
   }
-  int new_ne_step2 = new_ne;
-  int new_nbdr_step2 = new_nbdr;
-
-  if (add_subdomain)
+  Mpi::Print("Removed {:d} unmarked domain elements from the mesh\n",
+             orig_mesh->GetNE() - new_ne);
+  if (new_nbdr < orig_mesh->GetNBE())
   {
-    // Add new boundary elements at interfaces between elements beloning to different
-    // subdomains. This uses similar code to mfem::Mesh::PrintWithPartitioning.
-    MFEM_VERIFY(partitioning, "Cannot add subdomain interface boundary elements without "
-                              "supplied mesh partitioning!");
-    MFEM_VERIFY(!orig_mesh->Nonconforming(), "Adding subdomain interface boundary elements "
-                                             "is not supported for nonconforming meshes!");
-    for (int f = 0; f < orig_mesh->GetNumFaces(); f++)
-    {
-      const int &be = orig_bdr_faces[f];
-      if (be < 0 && add_bdr_faces[f] < 0)
-      {
-        int e1, e2;
-        orig_mesh->GetFaceElements(f, &e1, &e2);
-        if (e1 >= 0 && !elem_delete[e1] && e2 >= 0 && !elem_delete[e2] &&
-            partitioning[e1] != partitioning[e2])
-        {
-          // Internal face is connected to two elements belonging to different subdomains
-          // (this works for conforming meshes).
-          add_bdr_faces[f] = 2;
-          new_nbdr += 2;
-        }
-      }
-      // else
-      // {
-      //   // This face is attached to a boundary element. We could define a new boundary
-      //   // element with opposite orientation to ensure both subdomains in the distributed
-      //   // ParMesh have the boundary element.
-      // }
-    }
-    if (new_nbdr > new_nbdr_step2)
-    {
-      Mpi::Print("Added boundary elements for subdomain interfaces to the mesh\n",
-                 new_nbdr - new_nbdr_step2);
-    }
+    Mpi::Print("Removed {:d} unattached boundary elements from the mesh\n",
+               orig_mesh->GetNBE() - new_nbdr);
   }
 
-  // Create the new mesh.
-  if (new_ne == new_ne_step1 && new_ne_step1 == new_ne_step2 &&
-      new_ne_step2 == orig_mesh->GetNE() && new_nbdr == new_nbdr_step1 &&
-      new_nbdr_step1 == new_nbdr_step2 && new_nbdr_step2 == orig_mesh->GetNBE())
-  {
-    return new_attr_map;
-  }
+  // Create the new mesh, copying vertices and non-deleted domain and boundary elements.
   std::unique_ptr<mfem::Mesh> new_mesh =
       std::make_unique<mfem::Mesh>(orig_mesh->Dimension(), orig_mesh->GetNV(), new_ne,
                                    new_nbdr, orig_mesh->SpaceDimension());
-
-  // Copy vertices and non-deleted domain and boundary elements.
   for (int v = 0; v < orig_mesh->GetNV(); v++)
   {
     new_mesh->AddVertex(orig_mesh->GetVertex(v));
   }
+  std::vector<int> orig_elems;
+  orig_elems.reserve(new_ne);
   for (int e = 0; e < orig_mesh->GetNE(); e++)
   {
     if (!elem_delete[e])
     {
       mfem::Element *ne = orig_mesh->GetElement(e)->Duplicate(new_mesh.get());
       new_mesh->AddElement(ne);
+      orig_elems.push_back(e);
     }
   }
   for (int be = 0; be < orig_mesh->GetNBE(); be++)
@@ -978,85 +1920,9 @@ std::map<int, std::array<int, 2>> CheckMesh(std::unique_ptr<mfem::Mesh> &orig_me
     }
   }
 
-  // Add new boundary elements.
-  if (add_bdr || add_subdomain)
-  {
-    auto FlipVertices = [](mfem::Element *e)
-    {
-      mfem::Array<int> v;
-      e->GetVertices(v);
-      int start = 0, end = v.Size() - 1;
-      while (start < end)
-      {
-        int t = v[start];
-        v[start] = v[end];
-        v[end] = t;
-        start++;
-        end--;
-      }
-      e->SetVertices(v.HostRead());
-    };
-
-    // 1-based, some boundary attributes may be empty since they were removed from the
-    // original mesh, but to keep indices the same as config file we don't compact the
-    // list.
-    int max_bdr_attr = orig_mesh->bdr_attributes.Max();
-    for (int f = 0; f < orig_mesh->GetNumFaces(); f++)
-    {
-      if (add_bdr_faces[f] > 0)
-      {
-        // Assign new unique attribute based on attached elements (we want the material
-        // properties on the face to average those on the elements). This is used later on
-        // when integrating the transmission condition on the subdomain interface. Save the
-        // inverse so that the attributes of e1 and e2 can be easily referenced using the
-        // new attribute. Since attributes are in 1-based indexing, a, b > 0.
-        int e1, e2, a = 0, b = 0;
-        orig_mesh->GetFaceElements(f, &e1, &e2);
-        if (e1 >= 0 && !elem_delete[e1] && e2 >= 0 && !elem_delete[e2])
-        {
-          a = std::max(orig_mesh->GetAttribute(e1), orig_mesh->GetAttribute(e2));
-          b = (a == orig_mesh->GetAttribute(e1)) ? orig_mesh->GetAttribute(e2)
-                                                 : orig_mesh->GetAttribute(e1);
-        }
-        else if (e1 >= 0 && !elem_delete[e1])
-        {
-          a = orig_mesh->GetAttribute(e1);
-          b = 0;
-        }
-        else if (e2 >= 0 && !elem_delete[e2])
-        {
-          a = orig_mesh->GetAttribute(e2);
-          b = 0;
-        }
-        MFEM_VERIFY(a + b > 0, "Invalid new boundary element attribute!");
-        int new_attr = max_bdr_attr + (a * (a - 1)) / 2 + b;  // At least max_bdr_attr+1
-        if (new_attr_map.find(new_attr) == new_attr_map.end())
-        {
-          new_attr_map.emplace(new_attr, std::array<int, 2>{a, b});
-        }
-
-        // Add the boundary elements with the new boundary attribute.
-        mfem::Element *ne = orig_mesh->GetFace(f)->Duplicate(new_mesh.get());
-        ne->SetAttribute(new_attr);
-        new_mesh->AddBdrElement(ne);
-        if (add_bdr_faces[f] > 1)
-        {
-          // Flip order of vertices to reverse normal direction of second added element.
-          ne = orig_mesh->GetFace(f)->Duplicate(new_mesh.get());
-          FlipVertices(ne);
-          ne->SetAttribute(new_attr);
-          new_mesh->AddBdrElement(ne);
-          // Mpi::Print("Adding two BE with attr {:d} from elements {:d} and {:d}\n",
-          //            new_attr, a, b);
-        }
-      }
-    }
-  }
-
   // Finalize new mesh and replace the old one. If a curved mesh, set up the new mesh by
-  // projecting nodes onto the new mesh for the non-trimmed vdofs (accounts for new
-  // boundary elements too since no new dofs are added). See the MFEM trimmer miniapp for
-  // reference.
+  // projecting nodes onto the new mesh for the non-trimmed vdofs. See the MFEM trimmer
+  // miniapp for reference.
   new_mesh->FinalizeTopology();
   new_mesh->Finalize();
   new_mesh->RemoveUnusedVertices();
@@ -1092,12 +1958,224 @@ std::map<int, std::array<int, 2>> CheckMesh(std::unique_ptr<mfem::Mesh> &orig_me
     }
   }
   orig_mesh = std::move(new_mesh);
-  return new_attr_map;
+  return orig_elems;
+}
+
+template <typename MeshType>
+void CheckMesh(std::unique_ptr<MeshType> &mesh, const IoData &iodata, bool add_bdr,
+               bool add_subdomain)
+{
+  // - Check that all external boundaries of the mesh have a corresponding boundary
+  //   condition.
+  // - If desired, add boundary elements for all material interfaces and exterior
+  //   boundaries if these elements do not yet exist.
+  // - If desired, add boundary elements for all interfaces between subdomains, which are
+  //   the faces shared between processes.
+  // The checks are local to each process except for faces shared with a neighboring
+  // process, for which the attribute of the neighboring element is required. A serial mesh
+  // has no shared faces, and is checked on a single process.
+  constexpr bool parallel = std::is_same_v<MeshType, mfem::ParMesh>;
+  MFEM_VERIFY(mesh->Dimension() == 3 && !mesh->Nonconforming(),
+              "Nonconforming or 2D meshes have not been tested yet!");
+  MFEM_VERIFY(parallel || !add_subdomain,
+              "Subdomain interface boundary elements require a distributed mesh!");
+  MPI_Comm comm = MPI_COMM_SELF;
+  if constexpr (parallel)
+  {
+    comm = mesh->GetComm();
+  }
+  mfem::Array<int> mat_marker, bdr_marker;
+  GetUsedAttributeMarkers(iodata, mesh->attributes.Max(), mesh->bdr_attributes.Max(),
+                          mat_marker, bdr_marker);
+
+  // Get the attribute of the second neighboring element of each face, which for faces
+  // shared with another process is the element on the neighboring process, and zero for
+  // faces on the exterior boundary. For shared faces, also mark whether this process owns
+  // the face (the one with the lower rank), which is the only one to add a boundary
+  // element for a material interface on the face.
+  mfem::Array<int> nbr_attr(mesh->GetNumFaces());
+  mfem::Array<bool> shared_face(mesh->GetNumFaces()), owned_face(mesh->GetNumFaces());
+  shared_face = false;
+  owned_face = true;
+  for (int f = 0; f < mesh->GetNumFaces(); f++)
+  {
+    int e1, e2;
+    mesh->GetFaceElements(f, &e1, &e2);
+    nbr_attr[f] = (e2 >= 0) ? mesh->GetAttribute(e2) : 0;
+  }
+  if constexpr (parallel)
+  {
+    const int rank = Mpi::Rank(comm);
+    mesh->ExchangeFaceNbrData();
+    for (int i = 0; i < mesh->GetNSharedFaces(); i++)
+    {
+      const int f = mesh->GetSharedFace(i);
+      mfem::FaceElementTransformations *T = mesh->GetSharedFaceTransformations(i);
+      nbr_attr[f] = T->Elem2->Attribute;
+      shared_face[f] = true;
+      const int nbr_el = T->Elem2No - mesh->GetNE();
+      const int fn =
+          static_cast<int>(std::upper_bound(mesh->face_nbr_elements_offset.begin(),
+                                            mesh->face_nbr_elements_offset.end(), nbr_el) -
+                           mesh->face_nbr_elements_offset.begin()) -
+          1;
+      owned_face[f] = (rank < mesh->GetFaceNbrRank(fn));
+    }
+  }
+
+  int warn = 0;
+  mfem::Array<int> orig_bdr_faces(mesh->GetNumFaces());
+  orig_bdr_faces = -1;
+  for (int be = 0; be < mesh->GetNBE(); be++)
+  {
+    int f, o;
+    mesh->GetBdrElementFace(be, &f, &o);
+    MFEM_VERIFY(orig_bdr_faces[f] < 0,
+                "Mesh should not define boundary elements multiple times!");
+    orig_bdr_faces[f] = be;
+    int attr = mesh->GetBdrAttribute(be);
+    if (!bdr_marker[attr - 1])
+    {
+      // Internal boundary elements, including those on faces shared with another process,
+      // are allowed to have no BC.
+      if (nbr_attr[f] == 0)
+      {
+        warn = 1;
+      }
+    }
+  }
+  Mpi::GlobalMax(1, &warn, comm);
+  if (warn)
+  {
+    Mpi::Warning(comm,
+                 "One or more external boundary attributes has no associated boundary "
+                 "condition!\n\"PMC\"/\"ZeroCharge\" condition is assumed!\n");
+  }
+
+  if (!add_bdr && !add_subdomain)
+  {
+    return;
+  }
+
+  // Mark faces for new boundary elements at material interfaces or on the exterior
+  // boundary of the simulation domain, and at interfaces between subdomains, if there is
+  // not already a boundary element present. A material interface on a shared face gets a
+  // single boundary element from the owning process, while a subdomain interface gets one
+  // element from each process, oriented with its local element (so the two elements have
+  // opposite orientations).
+  int add_bdr_ext = 0, add_bdr_int = 0, add_bdr_sub = 0;
+  mfem::Array<int> add_bdr_faces(mesh->GetNumFaces());
+  add_bdr_faces = -1;
+  for (int f = 0; f < mesh->GetNumFaces(); f++)
+  {
+    if (orig_bdr_faces[f] >= 0)
+    {
+      continue;
+    }
+    int e1, e2;
+    mesh->GetFaceElements(f, &e1, &e2);
+    if (add_bdr && nbr_attr[f] == 0)
+    {
+      add_bdr_faces[f] = 1;
+      add_bdr_ext++;
+    }
+    else if (add_bdr && mesh->GetAttribute(e1) != nbr_attr[f])
+    {
+      if (owned_face[f])
+      {
+        add_bdr_faces[f] = 1;
+        add_bdr_int++;
+      }
+    }
+    else if (add_subdomain && shared_face[f])
+    {
+      add_bdr_faces[f] = 1;
+      add_bdr_sub++;
+    }
+  }
+  int add_bdr_glob[3] = {add_bdr_ext, add_bdr_int, add_bdr_sub};
+  Mpi::GlobalSum(3, add_bdr_glob, comm);
+  if (add_bdr_glob[0] > 0)
+  {
+    Mpi::Print(comm, "Added {:d} boundary elements for exterior boundaries to the mesh\n",
+               add_bdr_glob[0]);
+  }
+  if (add_bdr_glob[1] > 0)
+  {
+    Mpi::Print(comm, "Added {:d} boundary elements for material interfaces to the mesh\n",
+               add_bdr_glob[1]);
+  }
+  if (add_bdr_glob[2] > 0)
+  {
+    Mpi::Print(comm, "Added {:d} boundary elements for subdomain interfaces to the mesh\n",
+               add_bdr_glob[2]);
+  }
+  if (add_bdr_glob[0] + add_bdr_glob[1] + add_bdr_glob[2] == 0)
+  {
+    return;
+  }
+
+  // Add the new boundary elements to the local mesh on each process, which is moved into a
+  // mesh allowing the addition. 1-based, some boundary attributes may be empty since they
+  // were removed from the original mesh, but to keep indices the same as config file we
+  // don't compact the list.
+  const int max_bdr_attr = mesh->bdr_attributes.Max();
+  auto new_mesh = std::make_unique<BoundaryMesh<MeshType>>(std::move(*mesh));
+  for (int f = 0; f < new_mesh->GetNumFaces(); f++)
+  {
+    if (add_bdr_faces[f] > 0)
+    {
+      // Assign new unique attribute based on attached elements (we want the material
+      // properties on the face to average those on the elements). This is used later on
+      // when integrating the transmission condition on the subdomain interface. Since
+      // attributes are in 1-based indexing, a, b > 0. The attribute is symmetric in the
+      // neighboring elements, so processes sharing a face agree.
+      int e1, e2;
+      new_mesh->GetFaceElements(f, &e1, &e2);
+      const int a = std::max(new_mesh->GetAttribute(e1), nbr_attr[f]);
+      const int b = std::min(new_mesh->GetAttribute(e1), nbr_attr[f]);
+      MFEM_VERIFY(a > 0, "Invalid new boundary element attribute!");
+      int new_attr = max_bdr_attr + (a * (a - 1)) / 2 + b;  // At least max_bdr_attr+1
+
+      // Add the boundary element with the new boundary attribute.
+      new_mesh->AddBdrFace(f, new_attr);
+    }
+  }
+  new_mesh->FinalizeBoundary();
+  mesh = std::move(new_mesh);
+}
+
+template <typename MeshType>
+void BoundaryMesh<MeshType>::AddBdrFace(int f, int attr)
+{
+  mfem::Element *be = this->faces[f]->Duplicate(this);
+  be->SetAttribute(attr);
+  this->boundary.SetSize(this->NumOfBdrElements);
+  this->boundary.Append(be);
+  this->be_to_face.SetSize(this->NumOfBdrElements);
+  this->be_to_face.Append(f);
+  this->NumOfBdrElements++;
+}
+
+template <typename MeshType>
+void BoundaryMesh<MeshType>::FinalizeBoundary()
+{
+  // The boundary element to face map is updated as elements are added, leaving only the
+  // boundary element to edge table. The new elements lie on existing faces, so no other
+  // topology (including the shared entities) changes.
+  if (this->bel_to_edge)
+  {
+    mfem::DSTable v_to_v(this->NumOfVertices);
+    this->GetVertexToVertexTable(v_to_v);
+    this->GetElementArrayEdgeTable(this->boundary, v_to_v, *this->bel_to_edge);
+  }
+  this->SetAttributes();
 }
 
 std::unique_ptr<mfem::ParMesh> DistributeMesh(MPI_Comm comm,
                                               std::unique_ptr<mfem::Mesh> &smesh,
-                                              std::unique_ptr<int[]> &partitioning)
+                                              std::unique_ptr<int[]> &partitioning,
+                                              bool nonconforming)
 {
   // Take a serial mesh and partitioning on the root process and construct the global
   // parallel mesh. For now, prefer the MPI-based version.
@@ -1157,55 +2235,170 @@ std::unique_ptr<mfem::ParMesh> DistributeMesh(MPI_Comm comm,
   }
 #endif
   {
-    // Send each processor's component as a byte string.
-    std::vector<std::string> so;
+    // Broadcast the serial mesh as a binary string, compressed when MFEM is built with
+    // zlib. Every process constructs the serial mesh directly from the binary arrays,
+    // without parsing a text mesh format, and then extracts its own part of the parallel
+    // mesh. The fastest compression level is used, since the mesh is compressed serially
+    // on the root process. A nonconforming mesh is constructed from the conforming serial
+    // mesh on each process.
+    std::string so;
     if (Mpi::Root(comm))
     {
-      mfem::MeshPartitioner partitioner(*smesh, Mpi::Size(comm), partitioning.get());
-      so.reserve(Mpi::Size(comm));
-      for (int i = 0; i < Mpi::Size(comm); i++)
-      {
-        mfem::MeshPart part;
-        partitioner.ExtractPart(i, part);
-        std::ostringstream fo(std::stringstream::out);
-        // fo << std::fixed;
-        fo << std::scientific;
-        fo.precision(MSH_FLT_PRECISION);
-        part.Print(fo);
-        so.push_back(fo.str());
-        // so.push_back((i > 0) ? zlib::CompressString(fo.str()) : fo.str());
-      }
+      so = utils::CompressString(SerializeMesh(*smesh), utils::ZLIB_BEST_SPEED);
+      smesh.reset();
     }
-
-    // Scatter the partitioned mesh files and generate the parallel mesh.
-    if (Mpi::Root(comm))
+    std::uint64_t len = so.length();
+    MPI_Bcast(&len, 1, MPI_UINT64_T, 0, comm);
+    so.resize(len);
+    constexpr std::uint64_t max_count = std::numeric_limits<int>::max();
+    for (std::uint64_t offset = 0; offset < len; offset += max_count)
     {
-      std::vector<MPI_Request> send_requests(Mpi::Size(comm) - 1, MPI_REQUEST_NULL);
-      for (int i = 1; i < Mpi::Size(comm); i++)
-      {
-        int ilen = static_cast<int>(so[i].length());
-        MFEM_VERIFY(so[i].length() == (std::size_t)ilen,
-                    "Overflow error distributing parallel mesh!");
-        MPI_Isend(so[i].c_str(), ilen, MPI_CHAR, i, i, comm, &send_requests[i - 1]);
-      }
-      std::istringstream fi(so[0]);  // This is never compressed
-      auto pmesh = std::make_unique<mfem::ParMesh>(comm, fi);
-      MPI_Waitall(static_cast<int>(send_requests.size()), send_requests.data(),
-                  MPI_STATUSES_IGNORE);
-      return pmesh;
-    }
-    int rlen;
-    MPI_Status status;
-    MPI_Probe(0, Mpi::Rank(comm), comm, &status);
-    MPI_Get_count(&status, MPI_CHAR, &rlen);
-
-    std::string si;
-    si.resize(rlen);
-    MPI_Recv(si.data(), rlen, MPI_CHAR, 0, Mpi::Rank(comm), comm, MPI_STATUS_IGNORE);
-    std::istringstream fi(si);
-    // std::istringstream fi(zlib::DecompressString(si));
-    return std::make_unique<mfem::ParMesh>(comm, fi);
+      MPI_Bcast(so.data() + offset, static_cast<int>(std::min(max_count, len - offset)),
+                MPI_CHAR, 0, comm);
+    }
+    smesh = DeserializeMesh(utils::DecompressString(so));
+    so.clear();
+    so.shrink_to_fit();
+    if (nonconforming)
+    {
+      smesh->EnsureNCMesh(true);
+    }
+    if (!Mpi::Root(comm))
+    {
+      partitioning = std::make_unique<int[]>(smesh->GetNE());
+    }
+    Mpi::Broadcast(smesh->GetNE(), partitioning.get(), 0, comm);
+    auto pmesh = std::make_unique<mfem::ParMesh>(comm, *smesh, partitioning.get());
+    smesh.reset();
+    partitioning.reset();
+    return pmesh;
+  }
+}
+
+bool UseNonconformingMesh(const IoData &iodata)
+{
+  // Adaptive and region-based refinement are nonconforming when enabled, which allows
+  // refining tensor element meshes and rebalancing the refined mesh across processes.
+  const auto &boxes = iodata.model.refinement.GetBoxes();
+  const auto &spheres = iodata.model.refinement.GetSpheres();
+  auto Refined = [](const auto &region) { return region.ref_levels > 0; };
+  return iodata.model.refinement.nonconformal &&
+         (iodata.model.refinement.max_it > 0 ||
+          std::any_of(boxes.begin(), boxes.end(), Refined) ||
+          std::any_of(spheres.begin(), spheres.end(), Refined));
+}
+
+std::string SerializeMesh(const mfem::Mesh &mesh)
+{
+  // The string contains the mesh dimensions and sizes, the vertex coordinates, the
+  // geometry, attribute, and vertices of each element and boundary element, and the
+  // optional nodal grid function with the name of its finite element collection.
+  MFEM_VERIFY(!mesh.NURBSext && !mesh.Nonconforming(),
+              "Only conforming, non-NURBS meshes can be serialized!");
+  std::string so;
+  auto Write = [&so](const auto *data, std::size_t n)
+  { so.append(reinterpret_cast<const char *>(data), n * sizeof(*data)); };
+  auto WriteElement = [&Write](const mfem::Element &el)
+  {
+    mfem::Array<int> verts;
+    el.GetVertices(verts);
+    const int data[2] = {el.GetGeometryType(), el.GetAttribute()};
+    Write(data, 2);
+    Write(verts.GetData(), verts.Size());
+  };
+  const int sdim = mesh.SpaceDimension();
+  const int header[5] = {mesh.Dimension(), sdim, mesh.GetNV(), mesh.GetNE(),
+                         mesh.GetNBE()};
+  Write(header, 5);
+  for (int i = 0; i < mesh.GetNV(); i++)
+  {
+    Write(mesh.GetVertex(i), sdim);
+  }
+  for (int i = 0; i < mesh.GetNE(); i++)
+  {
+    WriteElement(*mesh.GetElement(i));
+  }
+  for (int i = 0; i < mesh.GetNBE(); i++)
+  {
+    WriteElement(*mesh.GetBdrElement(i));
+  }
+  const mfem::GridFunction *nodes = mesh.GetNodes();
+  const int has_nodes = (nodes != nullptr);
+  Write(&has_nodes, 1);
+  if (nodes)
+  {
+    const mfem::FiniteElementSpace &fespace = *nodes->FESpace();
+    const std::string name = fespace.FEColl()->Name();
+    const int data[3] = {static_cast<int>(name.length()), fespace.GetVDim(),
+                         fespace.GetOrdering()};
+    Write(data, 3);
+    Write(name.data(), name.length());
+    Write(nodes->GetData(), nodes->Size());
+  }
+  return so;
+}
+
+std::unique_ptr<mfem::Mesh> DeserializeMesh(const std::string &si)
+{
+  // Construct the mesh in the same way as when reading it from a file, with the nodes
+  // attached before finalizing the mesh.
+  std::size_t pos = 0;
+  auto Read = [&si, &pos](auto *data, std::size_t n)
+  {
+    const std::size_t bytes = n * sizeof(*data);
+    MFEM_VERIFY(pos + bytes <= si.length(), "Unexpected end of serialized mesh!");
+    std::memcpy(data, si.data() + pos, bytes);
+    pos += bytes;
+  };
+  int header[5];
+  Read(header, 5);
+  const auto [dim, sdim, nv, ne, nbe] = header;
+  MFEM_VERIFY(sdim >= 1 && sdim <= 3, "Invalid space dimension in serialized mesh!");
+  auto mesh = std::make_unique<mfem::Mesh>(dim, nv, ne, nbe, sdim);
+  auto ReadElement = [&Read, &mesh]()
+  {
+    int data[2];
+    Read(data, 2);
+    MFEM_VERIFY(data[0] >= 0 && data[0] < mfem::Geometry::NumGeom,
+                "Invalid element geometry in serialized mesh!");
+    mfem::Element *el = mesh->NewElement(data[0]);
+    Read(el->GetVertices(), el->GetNVertices());
+    el->SetAttribute(data[1]);
+    return el;
+  };
+  for (int i = 0; i < nv; i++)
+  {
+    double coord[3];
+    Read(coord, sdim);
+    mesh->AddVertex(coord);
+  }
+  for (int i = 0; i < ne; i++)
+  {
+    mesh->AddElement(ReadElement());
+  }
+  for (int i = 0; i < nbe; i++)
+  {
+    mesh->AddBdrElement(ReadElement());
+  }
+  mesh->FinalizeTopology();
+  int has_nodes;
+  Read(&has_nodes, 1);
+  if (has_nodes)
+  {
+    int data[3];
+    Read(data, 3);
+    std::string name(data[0], '\0');
+    Read(name.data(), name.length());
+    mfem::FiniteElementCollection *fec = mfem::FiniteElementCollection::New(name.c_str());
+    auto *fespace = new mfem::FiniteElementSpace(mesh.get(), fec, data[1], data[2]);
+    auto *nodes = new mfem::GridFunction(fespace);
+    nodes->MakeOwner(fec);  // Also owns the finite element space
+    Read(nodes->GetData(), nodes->Size());
+    mesh->NewNodes(*nodes, true);
   }
+  MFEM_VERIFY(pos == si.length(), "Unexpected data at the end of serialized mesh!");
+  mesh->Finalize(true, true);
+  return mesh;
 }
 
 void GetUsedAttributeMarkers(const IoData &iodata, int n_mat, int n_bdr,
@@ -1226,6 +2419,124 @@ void GetUsedAttributeMarkers(const IoData &iodata, int n_mat, int n_bdr,
   mesh::AttrToMarker(n_bdr, bdr_attr, bdr_marker);
 }
 
+RegionBVH::RegionBVH(int dim, std::vector<double> &&bbmin, std::vector<double> &&bbmax)
+  : dim(dim), bbmin(std::move(bbmin)), bbmax(std::move(bbmax))
+{
+  const int n = static_cast<int>(this->bbmin.size()) / dim;
+  index.resize(n);
+  for (int k = 0; k < n; k++)
+  {
+    index[k] = k;
+  }
+  if (n > 0)
+  {
+    nodes.reserve(2 * n);
+    Build(0, n);
+  }
+}
+
+int RegionBVH::Build(int begin, int end)
+{
+  // Compute the node bounding box and split the boxes at the median of their centers along
+  // the longest axis, until only a few boxes remain.
+  constexpr int LEAF_SIZE = 4;
+  const int id = static_cast<int>(nodes.size());
+  nodes.emplace_back();
+  Node node;
+  node.bbmin.fill(mfem::infinity());
+  node.bbmax.fill(-mfem::infinity());
+  for (int k = begin; k < end; k++)
+  {
+    for (int d = 0; d < dim; d++)
+    {
+      node.bbmin[d] = std::min(node.bbmin[d], bbmin[index[k] * dim + d]);
+      node.bbmax[d] = std::max(node.bbmax[d], bbmax[index[k] * dim + d]);
+    }
+  }
+  node.begin = begin;
+  node.end = end;
+  node.left = node.right = -1;
+  if (end - begin > LEAF_SIZE)
+  {
+    int axis = 0;
+    for (int d = 1; d < dim; d++)
+    {
+      if (node.bbmax[d] - node.bbmin[d] > node.bbmax[axis] - node.bbmin[axis])
+      {
+        axis = d;
+      }
+    }
+    const int mid = (begin + end) / 2;
+    std::nth_element(index.begin() + begin, index.begin() + mid, index.begin() + end,
+                     [this, axis](int a, int b)
+                     {
+                       return (bbmin[a * dim + axis] + bbmax[a * dim + axis] <
+                               bbmin[b * dim + axis] + bbmax[b * dim + axis]);
+                     });
+    node.left = Build(begin, mid);
+    node.right = Build(mid, end);
+  }
+  nodes[id] = node;
+  return id;
+}
+
+std::string GetPartitionedMeshFilename(const std::string &path, int rank)
+{
+  // Fixed width so that the files do not depend on the number of processes.
+  std::string dir = path;
+  if (dir.back() != '/')
+  {
+    dir += '/';
+  }
+  return mfem::MakeParFilename(dir + "part.", rank, ".mesh", 6);
+}
+
+std::unique_ptr<mfem::ParMesh> LoadPartitionedMesh(MPI_Comm comm, const std::string &path)
+{
+  // The partitioned mesh contains the parallel communication groups, so it can only be read
+  // with the same number of processes as it was written with.
+  int exists = std::filesystem::exists(GetPartitionedMeshFilename(path, Mpi::Rank(comm)));
+  Mpi::GlobalMin(1, &exists, comm);
+  MFEM_VERIFY(exists, "Unable to find partitioned mesh files in \""
+                          << path << "\" for all " << Mpi::Size(comm) << " processes!");
+  if (Mpi::Root(comm))
+  {
+    MFEM_VERIFY(!std::filesystem::exists(GetPartitionedMeshFilename(path, Mpi::Size(comm))),
+                "Partitioned mesh in \"" << path << "\" was written for more than "
+                                         << Mpi::Size(comm) << " processes!");
+  }
+  std::string pfile = GetPartitionedMeshFilename(path, Mpi::Rank(comm));
+  std::ifstream fi(pfile);
+  if (!fi.good())
+  {
+    MFEM_ABORT("Unable to open partitioned mesh file \"" << pfile << "\"!");
+  }
+  return std::make_unique<mfem::ParMesh>(comm, fi);
+}
+
+void WritePartitionedMesh(const std::string &path, const mfem::ParMesh &mesh)
+{
+  if (mesh.Nonconforming())
+  {
+    Mpi::Warning(mesh.GetComm(),
+                 "Nonconforming meshes are not supported for partitioned mesh export!\n");
+    return;
+  }
+  if (Mpi::Root(mesh.GetComm()) && !std::filesystem::exists(path))
+  {
+    std::filesystem::create_directories(path);
+  }
+  Mpi::Barrier(mesh.GetComm());
+  std::string pfile = GetPartitionedMeshFilename(path, Mpi::Rank(mesh.GetComm()));
+  std::ofstream fo(pfile);
+  if (!fo.good())
+  {
+    MFEM_ABORT("Unable to open partitioned mesh file \"" << pfile << "\" for writing!");
+  }
+  fo.precision(MSH_FLT_PRECISION);
+  mesh.ParPrint(fo);
+}
+
 }  // namespace
 
 }  // namespace palace
@@ -4,7 +4,9 @@
 #ifndef PALACE_GEO_DATA_HPP
 #define PALACE_GEO_DATA_HPP
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 #include <mpi.h>
 
@@ -31,11 +33,11 @@ namespace mesh
 // Functions for mesh related functionality.
 //
 
-// Read and partition a serial mesh from file, returning a pointer to the new parallel mesh
-// object, which should be destroyed by the user.
-std::unique_ptr<mfem::ParMesh> ReadMesh(MPI_Comm comm, const IoData &iodata, bool reorder,
-                                        bool clean, bool add_bdr, bool unassembled,
-                                        Timer &timer);
+// Read and partition a serial mesh from file, or read a previously partitioned mesh in
+// parallel, returning a pointer to the new parallel mesh object, which should be destroyed
+// by the user.
+std::unique_ptr<mfem::ParMesh> ReadMesh(MPI_Comm comm, const IoData &iodata, bool clean,
+                                        bool add_bdr, bool unassembled, Timer &timer);
 
 // Refine the provided mesh according to the data in the input file. If levels of refinement
 // are requested, the refined meshes are stored in order of increased refinement. Ownership
@@ -43,6 +45,53 @@ std::unique_ptr<mfem::ParMesh> ReadMesh(MPI_Comm comm, const IoData &iodata, boo
 // The fine mesh hierarchy is owned by the user.
 void RefineMesh(const IoData &iodata, std::vector<std::unique_ptr<mfem::ParMesh>> &mesh);
 
+// Refine the finest mesh for adaptive mesh refinement, marking the elements with the
+// largest squared error indicators which together contain the requested fraction of the
+// total (Dörfler marking). When the mesh hierarchy is used for geometric multigrid, the
+// refined mesh is appended as a new level. Otherwise, the mesh is refined in place and, if
+// nonconforming, rebalanced across processes. The optional update function is called after
+// each change to the finest mesh (including when a new level is appended), for example to
+// update finite element spaces and grid functions defined on it. Returns false if no
+// elements were marked for refinement.
+bool AdaptMesh(const IoData &iodata, const mfem::Vector &indicators,
+               std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+               const std::function<void()> &update = {});
+
+// Print information about the (nondimensionalized) mesh hierarchy.
+void PrintMeshInfo(const IoData &iodata,
+                   const std::vector<std::unique_ptr<mfem::ParMesh>> &mesh);
+
+//
+// Cache for the partitioned parallel mesh, stored with one file per process, for reuse by
+// subsequent simulations with the same mesh file, number of processes, and mesh
+// refinement settings. The refined mesh is cached, except when the mesh hierarchy for
+// geometric multigrid contains multiple levels, in which case the coarse mesh is cached
+// and the refinement is repeated (the transfer operators between levels rely on the
+// refinement history, which is not saved).
+//
+class MeshCache
+{
+private:
+  // Cache directory and the settings which determine the cached mesh.
+  std::string path, key;
+
+public:
+  // The settings are recorded on construction, which should happen before the inputs are
+  // nondimensionalized.
+  MeshCache(MPI_Comm comm, const IoData &iodata);
+
+  // Load the cached mesh into the empty mesh hierarchy, if it exists and was created with
+  // the same settings. The characteristic length is restored so that the subsequent
+  // nondimensionalization matches the simulation which created the cache. Returns true if
+  // the loaded mesh has already been refined.
+  bool Load(MPI_Comm comm, IoData &iodata,
+            std::vector<std::unique_ptr<mfem::ParMesh>> &mesh, Timer &timer) const;
+
+  // Save the mesh after nondimensionalization and refinement.
+  void Save(const IoData &iodata, const std::vector<std::unique_ptr<mfem::ParMesh>> &mesh,
+            Timer &timer) const;
+};
+
 // Helper function to convert a set of attribute numbers to a marker array. The marker array
 // will be of size max_attr and it will contain only zeroes and ones. Ones indicate which
 // attribute numbers are present in the attrs array. In the special case when attrs has a
@@ -319,6 +319,14 @@ void IoData::CheckConfiguration()
       solver.linear.ksp_initial_guess = 0;
     }
   }
+  if (solver.linear.mat_complex)
+  {
+    MFEM_VERIFY(problem.type == config::ProblemData::Type::DRIVEN,
+                "Complex-valued preconditioning is only available for driven problems!");
+    MFEM_VERIFY(solver.linear.mat_shifted <= 0,
+                "Complex-valued preconditioning is incompatible with \"UsePCShifted\"!");
+    solver.linear.mat_shifted = 0;
+  }
   if (solver.linear.mat_shifted < 0)
   {
     solver.linear.mat_shifted = 0;  // Default false for most cases
@@ -400,6 +408,13 @@ void IoData::NondimensionalizeInputs(mfem::ParMesh &mesh)
                    Divides);
   }
 
+  // Field output regions.
+  {
+    auto &output = problem.field_output;
+    std::transform(output.bbmin.begin(), output.bbmin.end(), output.bbmin.begin(), Divides);
+    std::transform(output.bbmax.begin(), output.bbmax.end(), output.bbmax.begin(), Divides);
+  }
+
   // Materials: conductivity and London penetration depth.
   for (auto &data : domains.materials)
   {
@@ -415,6 +430,16 @@ void IoData::NondimensionalizeInputs(mfem::ParMesh &mesh)
     data.z /= Lc / model.L0;
   }
 
+  // Sampling region coordinates.
+  for (auto &[idx, data] : domains.postpro.sampling)
+  {
+    std::transform(data.origin.begin(), data.origin.end(), data.origin.begin(), Divides);
+    for (auto &axis : data.axes)
+    {
+      std::transform(axis.begin(), axis.end(), axis.begin(), Divides);
+    }
+  }
+
   // Finite conductivity boundaries.
   for (auto &data : boundaries.conductivity)
   {
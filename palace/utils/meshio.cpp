@@ -3,6 +3,9 @@
 
 #include "meshio.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 #include <mfem.hpp>
@@ -222,6 +225,63 @@ static void GetLineNastran(std::ifstream &input, std::string &str)
   }
 }
 
+// Parse a number from a null-terminated string of whitespace separated numbers and advance
+// the string pointer past it. Avoids the overhead of string streams. Conversion failures
+// are reported through the valid flag rather than aborting, since these are called from
+// within OpenMP parallel regions.
+static double ParseDouble(const char *&str, bool &valid)
+{
+  char *end;
+  const double d = std::strtod(str, &end);
+  valid = valid && (end != str);
+  str = end;
+  return d;
+}
+
+static int ParseInt(const char *&str, bool &valid)
+{
+  char *end;
+  const long i = std::strtol(str, &end, 10);
+  valid = valid && (end != str);
+  str = end;
+  return static_cast<int>(i);
+}
+
+// Parse the next n non-empty lines of a COMSOL text file, calling the provided function
+// with the contents and (zero-based) index of each line. Lines are read serially in
+// batches and the lines of each batch are parsed in parallel when OpenMP is enabled. The
+// function clears the provided flag for a line which fails to parse.
+template <typename T>
+static void ParseLinesComsol(std::ifstream &input, int n, T &&ParseLine)
+{
+  constexpr int BATCH_SIZE = 1 << 16;
+  std::vector<std::string> lines(std::min(n, BATCH_SIZE));
+  int i = 0;
+  while (i < n)
+  {
+    const int batch = std::min(n - i, BATCH_SIZE);
+    int j = 0;
+    while (j < batch)
+    {
+      GetLineComsol(input, lines[j]);
+      if (!lines[j].empty())
+      {
+        j++;
+      }
+    }
+    bool valid = true;
+#if defined(MFEM_USE_OPENMP)
+#pragma omp parallel for schedule(static) reduction(&& : valid)
+#endif
+    for (int k = 0; k < batch; k++)
+    {
+      ParseLine(lines[k].c_str(), i + k, valid);
+    }
+    MFEM_VERIFY(valid, "Invalid number conversion parsing mesh file!");
+    i += batch;
+  }
+}
+
 // COMSOL strings are parsed as an integer length followed by array of integers for the
 // string characters.
 template <bool Binary>
@@ -250,30 +310,19 @@ void ReadStringComsol<false>(std::istream &input, std::string &str)
 }
 
 // Nastran has a special floating point format: "-7.-1" instead of "-7.E-01" or "2.3+2"
-// instead of "2.3E+02".
+// instead of "2.3E+02". Parsing stops at an exponent sign without a preceding 'E', in
+// which case the number is parsed again with the 'E' inserted (without throwing, which is
+// slow when the format is used for every coordinate).
 static double ConvertDoubleNastran(const std::string &str)
 {
-  double d;
-  try
+  const char *start = str.c_str();
+  char *end;
+  double d = std::strtod(start, &end);
+  MFEM_VERIFY(end != start, "Invalid number conversion parsing Nastran mesh!");
+  if (*end == '+' || *end == '-')
   {
-    d = std::stod(str);
-  }
-  catch (const std::invalid_argument &ia)
-  {
-    const std::size_t start = str.find_first_not_of(' ');
-    MFEM_VERIFY(start != std::string::npos,
-                "Invalid number conversion parsing Nastran mesh!")
-    std::string fstr = str.substr(start);
-    std::size_t pos = fstr.find('+', 1);  // Skip leading +/- sign
-    if (pos != std::string::npos)
-    {
-      fstr.replace(pos, 1, "E+");
-    }
-    else if ((pos = fstr.find('-', 1)) != std::string::npos)
-    {
-      fstr.replace(pos, 1, "E-");
-    }
-    d = std::stod(fstr);
+    const std::string fstr = std::string(start, end) + 'E' + end;
+    d = std::strtod(fstr.c_str(), nullptr);
   }
   return d;
 }
@@ -417,14 +466,163 @@ static void WriteGmsh(std::ostream &buffer, const std::vector<double> &node_coor
   buffer << "$EndElements\n";
 }
 
+// Get the MFEM geometry type for a linear Gmsh element type, or -1 for high-order element
+// types.
+static int ElemGeomGmsh(const int type)
+{
+  switch (type)
+  {
+    case 1:
+      return mfem::Geometry::SEGMENT;
+    case 2:
+      return mfem::Geometry::TRIANGLE;
+    case 3:
+      return mfem::Geometry::SQUARE;
+    case 4:
+      return mfem::Geometry::TETRAHEDRON;
+    case 5:
+      return mfem::Geometry::CUBE;
+    case 6:
+      return mfem::Geometry::PRISM;
+    case 7:
+      return mfem::Geometry::PYRAMID;
+    case 15:
+      return mfem::Geometry::POINT;
+  }
+  return -1;
+}
+
+static std::unique_ptr<mfem::Mesh>
+BuildMesh(const std::vector<double> &node_coords, const std::vector<int> &node_tags,
+          const std::unordered_map<int, std::vector<int>> &elem_nodes)
+{
+  // Meshes with high-order elements are converted to Gmsh format in memory and read by
+  // MFEM, which handles the construction of the curved mesh nodes.
+  int dim = 0;
+  for (const auto &[elem_type, nodes] : elem_nodes)
+  {
+    const int geom = ElemGeomGmsh(elem_type);
+    if (geom < 0)
+    {
+      std::stringstream fi(std::stringstream::in | std::stringstream::out);
+      fi << std::scientific;
+      fi.precision(std::numeric_limits<double>::max_digits10);
+      WriteGmsh(fi, node_coords, node_tags, elem_nodes);
+      return std::make_unique<mfem::Mesh>(fi, 1, 1, true);
+    }
+    dim = std::max(dim, mfem::Geometry::Dimension[geom]);
+  }
+  MFEM_VERIFY(dim > 0, "No mesh elements parsed from mesh file!");
+
+  // Otherwise, construct the linear mesh directly from the parsed nodes and elements.
+  // Following MFEM's Gmsh reader, elements of the highest dimension are the domain
+  // elements, elements of one lower dimension are boundary elements, and the space
+  // dimension is determined from the extents of the node coordinates.
+  const int num_nodes = (int)node_coords.size() / 3;
+  int sdim = 0;
+  {
+    for (int d = 0; d < 3; d++)
+    {
+      double min = mfem::infinity(), max = -mfem::infinity();
+      for (int i = 0; i < num_nodes; i++)
+      {
+        min = std::min(min, node_coords[3 * i + d]);
+        max = std::max(max, node_coords[3 * i + d]);
+      }
+      if (max > min)
+      {
+        sdim = d + 1;
+      }
+    }
+    sdim = std::max(sdim, dim);
+  }
+
+  // Map node tags to vertex indices, when the tags are not contiguous starting at 1.
+  std::vector<int> tag_to_vertex;
+  if (!node_tags.empty())
+  {
+    MFEM_VERIFY(node_tags.size() == (std::size_t)num_nodes, "Invalid size for node tags!");
+    MFEM_VERIFY(*std::min_element(node_tags.begin(), node_tags.end()) >= 0,
+                "Invalid negative node tag found in mesh nodes!");
+    tag_to_vertex.resize(*std::max_element(node_tags.begin(), node_tags.end()) + 1, -1);
+    for (int i = 0; i < num_nodes; i++)
+    {
+      tag_to_vertex[node_tags[i]] = i;
+    }
+  }
+  // Returns -1 for element node tags which do not correspond to any mesh node.
+  auto Vertex = [&tag_to_vertex, num_nodes](int tag)
+  {
+    if (tag_to_vertex.empty())
+    {
+      return (tag >= 1 && tag <= num_nodes) ? tag - 1 : -1;
+    }
+    return (tag >= 0 && tag < (int)tag_to_vertex.size()) ? tag_to_vertex[tag] : -1;
+  };
+
+  int ne = 0, nbe = 0;
+  for (const auto &[elem_type, nodes] : elem_nodes)
+  {
+    const int geom_dim = mfem::Geometry::Dimension[ElemGeomGmsh(elem_type)];
+    const int num_elem = (int)nodes.size() / (ElemNumNodes[elem_type - 1] + 1);
+    ne += (geom_dim == dim) ? num_elem : 0;
+    nbe += (geom_dim == dim - 1) ? num_elem : 0;
+  }
+  auto mesh = std::make_unique<mfem::Mesh>(dim, num_nodes, ne, nbe, sdim);
+  for (int i = 0; i < num_nodes; i++)
+  {
+    mesh->AddVertex(&node_coords[3 * i]);
+  }
+  for (const auto &[elem_type, nodes] : elem_nodes)
+  {
+    const int geom = ElemGeomGmsh(elem_type);
+    const int geom_dim = mfem::Geometry::Dimension[geom];
+    if (geom_dim != dim && geom_dim != dim - 1)
+    {
+      continue;
+    }
+    const int &num_elem_nodes = ElemNumNodes[elem_type - 1];
+    const int num_elem = (int)nodes.size() / (num_elem_nodes + 1);
+    std::vector<int> verts(num_elem_nodes);
+    for (int i = 0; i < num_elem; i++)
+    {
+      const int *data = &nodes[i * (num_elem_nodes + 1)];
+      for (int j = 0; j < num_elem_nodes; j++)
+      {
+        verts[j] = Vertex(data[1 + j]);
+        MFEM_VERIFY(verts[j] >= 0,
+                    "Element node tag " << data[1 + j] << " not found in mesh nodes!");
+      }
+      mfem::Element *el = mesh->NewElement(geom);
+      el->SetVertices(verts.data());
+      el->SetAttribute(data[0]);
+      if (geom_dim == dim)
+      {
+        mesh->AddElement(el);
+      }
+      else
+      {
+        mesh->AddBdrElement(el);
+      }
+    }
+  }
+  mesh->RemoveUnusedVertices();
+  mesh->FinalizeTopology();
+  mesh->Finalize(true, true);
+  return mesh;
+}
+
 }  // namespace
 
 namespace mesh
 {
 
-void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
+// Read a COMSOL format mesh. Stores the node coordinates (always 3D) and for each element
+// of each Gmsh type: [geometry tag, [node tags]]. Node tags are contiguous starting at 1.
+static void ReadMeshComsol(const std::string &filename, std::vector<double> &node_coords,
+                           std::vector<int> &node_tags,
+                           std::unordered_map<int, std::vector<int>> &elem_nodes)
 {
-  // Read a COMSOL format mesh.
   const int comsol_bin = !filename.compare(filename.length() - 7, 7, ".mphbin") ||
                          !filename.compare(filename.length() - 7, 7, ".MPHBIN");
   MFEM_VERIFY(!filename.compare(filename.length() - 7, 7, ".mphtxt") ||
@@ -670,31 +868,31 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
   }
 
   // Parse mesh nodes.
-  std::vector<double> node_coords;
+  node_tags.clear();
   {
-    node_coords.resize(3 * num_nodes,
+    node_coords.assign(3 * num_nodes,
                        0.0);  // Gmsh nodes are always 3D, so initialize to 0.0 in case
                               // z-coordinate isn't set
-    int i = 0;
     if (!comsol_bin)
     {
-      while (i < num_nodes)
-      {
-        GetLineComsol(input, line);
-        if (!line.empty())
-        {
-          std::istringstream sline(line);
-          for (int j = 0; j < sdim; j++)
-          {
-            sline >> node_coords[3 * i + j];
-          }
-          i++;
-        }
-      }
+      ParseLinesComsol(input, num_nodes,
+                       [&node_coords, sdim](const char *str, int i, bool &valid)
+                       {
+                         for (int j = 0; j < sdim; j++)
+                         {
+                           node_coords[3 * i + j] = ParseDouble(str, valid);
+                         }
+                       });
+    }
+    else if (sdim == 3)
+    {
+      input.read(reinterpret_cast<char *>(node_coords.data()),
+                 (std::streamsize)(3 * num_nodes * sizeof(double)));
     }
     else
     {
       // Don't read as a single block in case sdim < 3.
+      int i = 0;
       while (i < num_nodes)
       {
         input.read(reinterpret_cast<char *>(node_coords.data() + 3 * i),
@@ -705,7 +903,7 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
   }
 
   // Parse mesh elements. Store for each element of each type: [geometry tag, [node tags]].
-  std::unordered_map<int, std::vector<int>> elem_nodes;
+  elem_nodes.clear();
   {
     int num_elem_types = -1;
     if (!comsol_bin)
@@ -775,26 +973,22 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
             }
 
             // Parse all element nodes.
-            int i = 0;
-            while (i < num_elem)
-            {
-              GetLineComsol(input, line);
-              if (!line.empty())
-              {
-                if (!skip_type)
+            const int *perm = (!skip_type) ? ElemNodesComsol[elem_type - 1] : nullptr;
+            ParseLinesComsol(
+                input, num_elem,
+                [data, perm, num_elem_nodes, nodes_start](const char *str, int i,
+                                                          bool &valid)
                 {
-                  std::istringstream isline(line);
-                  for (int j = 0; j < num_elem_nodes; j++)
+                  if (data)
                   {
-                    // Permute and reset to 1-based node tags.
-                    const int &p = ElemNodesComsol[elem_type - 1][j];
-                    isline >> (*data)[i * (num_elem_nodes + 1) + 1 + p];
-                    (*data)[i * (num_elem_nodes + 1) + 1 + p] += (1 - nodes_start);
+                    for (int j = 0; j < num_elem_nodes; j++)
+                    {
+                      // Permute and reset to 1-based node tags.
+                      (*data)[i * (num_elem_nodes + 1) + 1 + perm[j]] =
+                          ParseInt(str, valid) + (1 - nodes_start);
+                    }
                   }
-                }
-                i++;
-              }
-            }
+                });
           }
           else if (num_elem_geom < 0)
           {
@@ -814,23 +1008,18 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
             // Parse all element geometry tags (stored at beginning of element nodes). For
             // geometric entites in < 3D, the exported COMSOL tags are 0-based and need
             // correcting to 1-based for Gmsh.
-            int i = 0;
             const int geom_start =
                 (elem_type < 4 || (elem_type > 7 && elem_type < 11)) ? 1 : 0;
-            while (i < num_elem)
-            {
-              GetLineComsol(input, line);
-              if (!line.empty())
-              {
-                if (!skip_type)
-                {
-                  std::istringstream ssline(line);
-                  ssline >> (*data)[i * (num_elem_nodes + 1)];
-                  (*data)[i * (num_elem_nodes + 1)] += geom_start;
-                }
-                i++;
-              }
-            }
+            ParseLinesComsol(input, num_elem,
+                             [data, num_elem_nodes, geom_start](const char *str, int i,
+                                                                bool &valid)
+                             {
+                               if (data)
+                               {
+                                 (*data)[i * (num_elem_nodes + 1)] =
+                                     ParseInt(str, valid) + geom_start;
+                               }
+                             });
 
             // Debug
             // std::cout << "Finished parsing " << num_elem
@@ -870,22 +1059,25 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
           data = &elem_nodes[elem_type];
           data->resize(num_elem * (num_elem_nodes + 1));  // Node tags + geometry tag
         }
-        int i = 0;
-        std::vector<int> nodes(num_elem_nodes);
-        while (i < num_elem)
+        // Read the element nodes as a single block, then permute.
+        std::vector<int> nodes((std::size_t)num_elem * num_elem_nodes);
+        input.read(reinterpret_cast<char *>(nodes.data()),
+                   (std::streamsize)(nodes.size() * sizeof(int)));
+        if (!skip_type)
         {
-          input.read(reinterpret_cast<char *>(nodes.data()),
-                     (std::streamsize)(num_elem_nodes * sizeof(int)));
-          if (!skip_type)
+          const int *perm = ElemNodesComsol[elem_type - 1];
+#if defined(MFEM_USE_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+          for (int i = 0; i < num_elem; i++)
           {
             for (int j = 0; j < num_elem_nodes; j++)
             {
               // Permute and reset to 1-based node tags.
-              const int &p = ElemNodesComsol[elem_type - 1][j];
-              (*data)[i * (num_elem_nodes + 1) + 1 + p] = nodes[j] + (1 - nodes_start);
+              (*data)[i * (num_elem_nodes + 1) + 1 + perm[j]] =
+                  nodes[i * num_elem_nodes + j] + (1 - nodes_start);
             }
           }
-          i++;
         }
 
         // Parse element geometry tags.
@@ -893,17 +1085,16 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
         MFEM_VERIFY(num_elem_geom == num_elem,
                     "COMSOL mesh file should have geometry tags for all elements!");
 
-        i = 0;
         const int geom_start = (elem_type < 4 || (elem_type > 7 && elem_type < 11)) ? 1 : 0;
-        int geom_tag;
-        while (i < num_elem)
+        nodes.resize(num_elem);
+        input.read(reinterpret_cast<char *>(nodes.data()),
+                   (std::streamsize)(num_elem * sizeof(int)));
+        if (!skip_type)
         {
-          input.read(reinterpret_cast<char *>(&geom_tag), sizeof(int));
-          if (!skip_type)
+          for (int i = 0; i < num_elem; i++)
           {
-            (*data)[i * (num_elem_nodes + 1)] = geom_tag + geom_start;
+            (*data)[i * (num_elem_nodes + 1)] = nodes[i] + geom_start;
           }
-          i++;
         }
 
         // Debug
@@ -919,15 +1110,15 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
     }
   }
 
-  // Finalize input, write the Gmsh mesh.
   input.close();
-  std::vector<int> dummy;
-  WriteGmsh(buffer, node_coords, dummy, elem_nodes);
 }
 
-void ConvertMeshNastran(const std::string &filename, std::ostream &buffer)
+// Read a Nastran/BDF format mesh. Stores the node coordinates and tags, and for each
+// element of each Gmsh type: [geometry tag, [node tags]].
+static void ReadMeshNastran(const std::string &filename, std::vector<double> &node_coords,
+                            std::vector<int> &node_tags,
+                            std::unordered_map<int, std::vector<int>> &elem_nodes)
 {
-  // Read a Nastran/BDF format mesh.
   MFEM_VERIFY(!filename.compare(filename.length() - 4, 4, ".nas") ||
                   !filename.compare(filename.length() - 4, 4, ".NAS") ||
                   !filename.compare(filename.length() - 4, 4, ".bdf") ||
@@ -957,9 +1148,9 @@ void ConvertMeshNastran(const std::string &filename, std::ostream &buffer)
 
   // Parse mesh nodes and elements. It is expected that node tags start at 1 and are
   // contiguous. Store for each element of each type: [geometry tag, [node tags]].
-  std::vector<double> node_coords;
-  std::vector<int> node_tags;
-  std::unordered_map<int, std::vector<int>> elem_nodes;
+  node_coords.clear();
+  node_tags.clear();
+  elem_nodes.clear();
   int elem_type;
   while (true)
   {
@@ -1128,11 +1319,45 @@ void ConvertMeshNastran(const std::string &filename, std::ostream &buffer)
     }
   }
 
-  // Finalize input, write the Gmsh mesh.
   input.close();
+}
+
+void ConvertMeshComsol(const std::string &filename, std::ostream &buffer)
+{
+  std::vector<double> node_coords;
+  std::vector<int> node_tags;
+  std::unordered_map<int, std::vector<int>> elem_nodes;
+  ReadMeshComsol(filename, node_coords, node_tags, elem_nodes);
   WriteGmsh(buffer, node_coords, node_tags, elem_nodes);
 }
 
+void ConvertMeshNastran(const std::string &filename, std::ostream &buffer)
+{
+  std::vector<double> node_coords;
+  std::vector<int> node_tags;
+  std::unordered_map<int, std::vector<int>> elem_nodes;
+  ReadMeshNastran(filename, node_coords, node_tags, elem_nodes);
+  WriteGmsh(buffer, node_coords, node_tags, elem_nodes);
+}
+
+std::unique_ptr<mfem::Mesh> LoadMeshComsol(const std::string &filename)
+{
+  std::vector<double> node_coords;
+  std::vector<int> node_tags;
+  std::unordered_map<int, std::vector<int>> elem_nodes;
+  ReadMeshComsol(filename, node_coords, node_tags, elem_nodes);
+  return BuildMesh(node_coords, node_tags, elem_nodes);
+}
+
+std::unique_ptr<mfem::Mesh> LoadMeshNastran(const std::string &filename)
+{
+  std::vector<double> node_coords;
+  std::vector<int> node_tags;
+  std::unordered_map<int, std::vector<int>> elem_nodes;
+  ReadMeshNastran(filename, node_coords, node_tags, elem_nodes);
+  return BuildMesh(node_coords, node_tags, elem_nodes);
+}
+
 }  // namespace mesh
 
 }  // namespace palace
@@ -5,8 +5,16 @@
 #define PALACE_MESH_IO_HPP
 
 #include <iostream>
+#include <memory>
 #include <string>
 
+namespace mfem
+{
+
+class Mesh;
+
+}  // namespace mfem
+
 namespace palace::mesh
 {
 
@@ -22,6 +30,15 @@ void ConvertMeshComsol(const std::string &filename, std::ostream &buffer);
 // Convert an ASCII NASTRAN (.nas/.bdf) mesh to Gmsh v2.2.
 void ConvertMeshNastran(const std::string &filename, std::ostream &buffer);
 
+//
+// Functions for reading COMSOL and Nastran meshes into a serial MFEM mesh. Meshes with
+// linear elements are constructed directly from the parsed nodes and elements, while
+// meshes with high-order elements are converted to Gmsh format in memory and read by MFEM.
+//
+
+std::unique_ptr<mfem::Mesh> LoadMeshComsol(const std::string &filename);
+std::unique_ptr<mfem::Mesh> LoadMeshNastran(const std::string &filename);
+
 }  // namespace palace::mesh
 
 #endif  // PALACE_MESH_IO_HPP
@@ -4,9 +4,10 @@
 #ifndef PALACE_MFEM_COEFFICIENTS_HPP
 #define PALACE_MFEM_COEFFICIENTS_HPP
 
+#include <algorithm>
 #include <complex>
-#include <map>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <mfem.hpp>
@@ -15,6 +16,137 @@
 namespace palace
 {
 
+//
+// Fixed-size kernels for the small sdim x sdim material property tensors and field vectors
+// which are evaluated at every quadrature point. Matrices are stored column-major as for
+// mfem::DenseMatrix.
+//
+
+namespace fixed
+{
+
+// y = A x.
+template <int Dim>
+inline void Mult(const double *A, const double *x, double *y)
+{
+  for (int i = 0; i < Dim; i++)
+  {
+    y[i] = A[i] * x[0];
+  }
+  for (int j = 1; j < Dim; j++)
+  {
+    for (int i = 0; i < Dim; i++)
+    {
+      y[i] += A[j * Dim + i] * x[j];
+    }
+  }
+}
+
+// y += a A x.
+template <int Dim>
+inline void AddMult(const double *A, const double *x, double a, double *y)
+{
+  for (int j = 0; j < Dim; j++)
+  {
+    const double ax = a * x[j];
+    for (int i = 0; i < Dim; i++)
+    {
+      y[i] += A[j * Dim + i] * ax;
+    }
+  }
+}
+
+// xᵀ y.
+template <int Dim>
+inline double Dot(const double *x, const double *y)
+{
+  double res = x[0] * y[0];
+  for (int i = 1; i < Dim; i++)
+  {
+    res += x[i] * y[i];
+  }
+  return res;
+}
+
+// xᵀ A x.
+template <int Dim>
+inline double InnerProduct(const double *A, const double *x)
+{
+  double res = 0.0;
+  for (int j = 0; j < Dim; j++)
+  {
+    res += x[j] * Dot<Dim>(A + j * Dim, x);
+  }
+  return res;
+}
+
+}  // namespace fixed
+
+// Calls f(std::integral_constant<int, Dim>()) for the given spatial dimension, in order to
+// dispatch onto implementations templated on the dimension.
+template <typename F>
+inline auto DispatchSpaceDimension(int dim, F &&f)
+{
+  switch (dim)
+  {
+    case 1:
+      return f(std::integral_constant<int, 1>());
+    case 2:
+      return f(std::integral_constant<int, 2>());
+    case 3:
+      break;
+    default:
+      MFEM_ABORT("Unsupported spatial dimension " << dim << "!");
+  }
+  return f(std::integral_constant<int, 3>());
+}
+
+//
+// Precomputed face data for the local boundary elements of a mesh, used by the boundary
+// coefficients below to look up the elements neighboring a boundary element. The face,
+// orientation, shared face index, and neighboring elements of each boundary element, along
+// with the vector pointing into the first neighboring element, are computed once on
+// construction and stored in flat arrays indexed by boundary element. The unit normal is
+// also stored for boundary elements with a constant Jacobian.
+//
+class BdrFaceGeometry
+{
+private:
+  mfem::ParMesh &mesh;
+
+  // Face index and orientation of each boundary element relative to its face, and index of
+  // the face in the list of shared faces (-1 if the face is not shared).
+  std::vector<int> face, orientation, shared_face;
+
+  // Neighboring elements of each boundary element. The second element is -1 for a true
+  // one-sided boundary, and face-neighbor elements on shared faces are numbered after the
+  // local elements.
+  std::vector<int> elem1, elem2;
+
+  // Vector pointing from the center of the face into element 1, and unit normal for
+  // boundary elements with a constant Jacobian (zero otherwise), stored with the spatial
+  // dimension as the fastest index.
+  std::vector<double> C1, normal;
+  std::vector<bool> affine;
+
+public:
+  BdrFaceGeometry(mfem::ParMesh &msh);
+
+  mfem::ParMesh &GetMesh() const { return mesh; }
+
+  int GetFace(int be) const { return face[be]; }
+  int GetOrientation(int be) const { return orientation[be]; }
+  int GetSharedFace(int be) const { return shared_face[be]; }
+  int GetElement1(int be) const { return elem1[be]; }
+  int GetElement2(int be) const { return elem2[be]; }
+  const double *GetC1(int be) const { return C1.data() + be * mesh.SpaceDimension(); }
+
+  // Get the unit normal of the boundary element with transformation T at the provided
+  // integration point, using the stored value if the normal is constant.
+  void GetNormal(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
+                 mfem::Vector &nor) const;
+};
+
 //
 // Derived coefficients which compute single values on internal boundaries where a possibly
 // discontinuous function is given as an input grid function. These are all cheap to
@@ -31,7 +163,7 @@ private:
 
 protected:
   mfem::ParMesh &mesh;
-  const std::map<int, int> &local_to_shared;
+  const BdrFaceGeometry &bdr_geom;
 
   void GetElementTransformations(mfem::ElementTransformation &T,
                                  const mfem::IntegrationPoint &ip,
@@ -40,15 +172,44 @@ protected:
                                  mfem::Vector *C1 = nullptr);
 
 public:
-  BdrGridFunctionCoefficient(mfem::ParMesh &msh, const std::map<int, int> &l2s)
-    : mesh(msh), local_to_shared(l2s)
+  BdrGridFunctionCoefficient(mfem::ParMesh &msh, const BdrFaceGeometry &geom)
+    : mesh(msh), bdr_geom(geom)
   {
+    MFEM_VERIFY(&mesh == &bdr_geom.GetMesh(),
+                "Invalid face data for BdrGridFunctionCoefficient!");
   }
 
   static void GetNormal(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
                         mfem::Vector &normal);
 };
 
+// Helper for precomputing surface integrals of grid functions on boundaries, evaluating the
+// neighboring elements in the same way as the boundary coefficients below but for all of
+// their shape functions at once. DOFs of face-neighbor elements on shared faces are
+// numbered after the local DOFs.
+class BdrGridFunctionQuadrature : public BdrGridFunctionCoefficient
+{
+public:
+  using BdrGridFunctionCoefficient::BdrGridFunctionCoefficient;
+
+  // Calls f(be, T, w, nor, C1, T1, T2) at each quadrature point of the local boundary
+  // elements with attributes in the given marker, where T is the boundary element
+  // transformation, w the quadrature weight, nor the unit normal, C1 the vector pointing
+  // into neighboring element 1, and T1 (T2) the transformations of the neighboring elements
+  // (T2 is nullptr for a one-sided boundary). The quadrature rule is the default one for a
+  // linear form on the boundary elements of the given space.
+  template <typename F>
+  void ForEachPoint(const mfem::ParFiniteElementSpace &fespace,
+                    const mfem::Array<int> &attr_marker, F &&f);
+
+  // Computes the vector shape functions at the current integration point of the element
+  // with the given transformation, along with its DOFs.
+  static mfem::DofTransformation *
+  GetElementVShape(const mfem::ParFiniteElementSpace &fespace,
+                   mfem::ElementTransformation &T, mfem::DenseMatrix &vshape,
+                   mfem::Array<int> &vdofs);
+};
+
 // Computes surface current J_s = n x H on boundaries from B as a vector grid function
 // where n is an inward normal (computes -n x H for outward normal n). For a two-sided
 // internal boundary, the contributions from both sides add.
@@ -58,42 +219,40 @@ class BdrCurrentVectorCoefficient : public mfem::VectorCoefficient,
 private:
   const mfem::ParGridFunction &B;
   const MaterialOperator &mat_op;
-  mutable mfem::Vector C1, W, VU, VL, nor;
 
 public:
   BdrCurrentVectorCoefficient(const mfem::ParGridFunction &gf, const MaterialOperator &op,
-                              const std::map<int, int> &l2s)
+                              const BdrFaceGeometry &geom)
     : mfem::VectorCoefficient(gf.ParFESpace()->GetParMesh()->SpaceDimension()),
-      BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s), B(gf), mat_op(op),
-      C1(gf.VectorDim()), W(gf.VectorDim()), VU(gf.VectorDim()), VL(gf.VectorDim()),
-      nor(gf.VectorDim())
+      BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom), B(gf), mat_op(op)
   {
+    MFEM_VERIFY(vdim == 3, "BdrCurrentVectorCoefficient expects a mesh in 3D space!");
   }
 
   void Eval(mfem::Vector &V, mfem::ElementTransformation &T,
             const mfem::IntegrationPoint &ip) override
   {
     // Get neighboring elements.
-    MFEM_VERIFY(vdim == 3, "BdrJVectorCoefficient expects a mesh in 3D space!");
+    double C1_data[3], W_data[3], VU[3], nor[3];
+    mfem::Vector C1(C1_data, 3), W(W_data, 3), N(nor, 3);
     mfem::ElementTransformation *T1, *T2;
     GetElementTransformations(T, ip, T1, T2, &C1);
 
     // For interior faces, compute J_s = -n x H = -n x μ⁻¹(B1 - B2), where B1 (B2) is B in
     // el1 (el2) and n points out from el1.
     B.GetVectorValue(*T1, T1->GetIntPoint(), W);
-    mat_op.GetInvPermeability(T1->Attribute).Mult(W, VU);
+    fixed::Mult<3>(mat_op.GetInvPermeability(T1->Attribute).Data(), W_data, VU);
     if (T2)
     {
       // Double-sided, not a true boundary.
       B.GetVectorValue(*T2, T2->GetIntPoint(), W);
-      mat_op.GetInvPermeability(T2->Attribute).Mult(W, VL);
-      VU -= VL;
+      fixed::AddMult<3>(mat_op.GetInvPermeability(T2->Attribute).Data(), W_data, -1.0, VU);
     }
 
     // Orient with normal pointing into el1.
-    GetNormal(T, ip, nor);
+    bdr_geom.GetNormal(T, ip, N);
     V.SetSize(vdim);
-    if (C1 * nor < 0.0)
+    if (fixed::Dot<3>(C1_data, nor) < 0.0)
     {
       V[0] = -nor[1] * VU[2] + nor[2] * VU[1];
       V[1] = -nor[2] * VU[0] + nor[0] * VU[2];
@@ -116,37 +275,51 @@ class BdrChargeCoefficient : public mfem::Coefficient, public BdrGridFunctionCoe
 private:
   const mfem::ParGridFunction &E;
   const MaterialOperator &mat_op;
-  mutable mfem::Vector C1, W, VU, VL, nor;
 
-public:
-  BdrChargeCoefficient(const mfem::ParGridFunction &gf, const MaterialOperator &op,
-                       const std::map<int, int> &l2s)
-    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s),
-      E(gf), mat_op(op), C1(gf.VectorDim()), W(gf.VectorDim()), VU(gf.VectorDim()),
-      VL(gf.VectorDim()), nor(gf.VectorDim())
-  {
-  }
+  // Implementation of Eval for the spatial dimension of the mesh, resolved on construction.
+  double (BdrChargeCoefficient::*eval)(mfem::ElementTransformation &,
+                                       const mfem::IntegrationPoint &);
 
-  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  template <int Dim>
+  double EvalDim(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
   {
     // Get neighboring elements.
+    double C1_data[Dim], W_data[Dim], VU[Dim], nor[Dim];
+    mfem::Vector C1(C1_data, Dim), W(W_data, Dim), N(nor, Dim);
     mfem::ElementTransformation *T1, *T2;
     GetElementTransformations(T, ip, T1, T2, &C1);
 
     // For interior faces, compute D ⋅ n = ε (E1 - E2) ⋅ n, where E1 (E2) is E in el1 (el2)
     // to get a single-valued function.
     E.GetVectorValue(*T1, T1->GetIntPoint(), W);
-    mat_op.GetPermittivityReal(T1->Attribute).Mult(W, VU);
+    fixed::Mult<Dim>(mat_op.GetPermittivityReal(T1->Attribute).Data(), W_data, VU);
     if (T2)
     {
       E.GetVectorValue(*T2, T2->GetIntPoint(), W);
-      mat_op.GetPermittivityReal(T2->Attribute).Mult(W, VL);
-      VU -= VL;
+      fixed::AddMult<Dim>(mat_op.GetPermittivityReal(T2->Attribute).Data(), W_data, -1.0,
+                          VU);
     }
 
     // Orient with normal pointing into el1.
-    GetNormal(T, ip, nor);
-    return (C1 * nor < 0.0) ? -(VU * nor) : VU * nor;
+    bdr_geom.GetNormal(T, ip, N);
+    const double VUn = fixed::Dot<Dim>(VU, nor);
+    return (fixed::Dot<Dim>(C1_data, nor) < 0.0) ? -VUn : VUn;
+  }
+
+public:
+  BdrChargeCoefficient(const mfem::ParGridFunction &gf, const MaterialOperator &op,
+                       const BdrFaceGeometry &geom)
+    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom),
+      E(gf), mat_op(op)
+  {
+    eval = DispatchSpaceDimension(
+        mesh.SpaceDimension(), [](auto dim)
+        { return &BdrChargeCoefficient::EvalDim<decltype(dim)::value>; });
+  }
+
+  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  {
+    return (this->*eval)(T, ip);
   }
 };
 
@@ -158,19 +331,17 @@ class BdrFluxCoefficient : public mfem::Coefficient, public BdrGridFunctionCoeff
 private:
   const mfem::ParGridFunction &B;
   const mfem::Vector dir;
-  mutable mfem::Vector V, VL, nor;
 
-public:
-  BdrFluxCoefficient(const mfem::ParGridFunction &gf, mfem::Vector d,
-                     const std::map<int, int> &l2s)
-    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s),
-      B(gf), dir(std::move(d)), V(gf.VectorDim()), VL(gf.VectorDim()), nor(gf.VectorDim())
-  {
-  }
+  // Implementation of Eval for the spatial dimension of the mesh, resolved on construction.
+  double (BdrFluxCoefficient::*eval)(mfem::ElementTransformation &,
+                                     const mfem::IntegrationPoint &);
 
-  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  template <int Dim>
+  double EvalDim(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
   {
     // Get neighboring elements.
+    double V_data[Dim], VL_data[Dim], nor[Dim];
+    mfem::Vector V(V_data, Dim), VL(VL_data, Dim), N(nor, Dim);
     mfem::ElementTransformation *T1, *T2;
     GetElementTransformations(T, ip, T1, T2);
 
@@ -181,13 +352,34 @@ public:
     if (T2)
     {
       B.GetVectorValue(*T2, T2->GetIntPoint(), VL);
-      V += VL;
-      V *= 0.5;
+      for (int i = 0; i < Dim; i++)
+      {
+        V_data[i] = 0.5 * (V_data[i] + VL_data[i]);
+      }
     }
 
     // Orient sign with the global direction.
-    GetNormal(T, ip, nor);
-    return (dir * nor < 0.0) ? -(V * nor) : V * nor;
+    bdr_geom.GetNormal(T, ip, N);
+    const double Vn = fixed::Dot<Dim>(V_data, nor);
+    return (fixed::Dot<Dim>(dir.GetData(), nor) < 0.0) ? -Vn : Vn;
+  }
+
+public:
+  BdrFluxCoefficient(const mfem::ParGridFunction &gf, mfem::Vector d,
+                     const BdrFaceGeometry &geom)
+    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom),
+      B(gf), dir(std::move(d))
+  {
+    MFEM_VERIFY(dir.Size() == mesh.SpaceDimension(),
+                "Invalid direction vector dimension for BdrFluxCoefficient!");
+    eval = DispatchSpaceDimension(
+        mesh.SpaceDimension(), [](auto dim)
+        { return &BdrFluxCoefficient::EvalDim<decltype(dim)::value>; });
+  }
+
+  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  {
+    return (this->*eval)(T, ip);
   }
 };
 
@@ -216,12 +408,18 @@ private:
   const MaterialOperator &mat_op;
   const double ts, epsilon;
   const mfem::Vector side;
-  mutable mfem::Vector C1, V, nor;
 
+  // Implementation of Eval for the spatial dimension of the mesh, resolved on construction.
+  double (DielectricInterfaceCoefficient::*eval)(mfem::ElementTransformation &,
+                                                 const mfem::IntegrationPoint &);
+
+  template <int Dim>
   int Initialize(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
-                 mfem::Vector &V)
+                 double *V_data)
   {
     // Get neighboring elements.
+    double C1_data[Dim];
+    mfem::Vector C1(C1_data, Dim), V(V_data, Dim);
     mfem::ElementTransformation *T1, *T2;
     GetElementTransformations(T, ip, T1, T2, &C1);
 
@@ -244,7 +442,7 @@ private:
       E.GetVectorValue(*T1, T1->GetIntPoint(), V);
       return T1->Attribute;
     }
-    if (C1 * side < 0.0)
+    if (fixed::Dot<Dim>(C1_data, side.GetData()) < 0.0)
     {
       // Get solution in el2.
       E.GetVectorValue(*T2, T2->GetIntPoint(), V);
@@ -255,74 +453,102 @@ private:
     return T1->Attribute;
   }
 
+  template <int Dim>
+  double EvalDim(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+  {
+    MFEM_ABORT("DielectricInterfaceCoefficient::Eval() is not implemented for this "
+               "interface type!");
+    return 0.0;
+  }
+
 public:
   DielectricInterfaceCoefficient(const mfem::ParGridFunction &gf,
                                  const MaterialOperator &op, double ti, double ei,
-                                 mfem::Vector s, const std::map<int, int> &l2s)
-    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s),
-      E(gf), mat_op(op), ts(ti), epsilon(ei), side(std::move(s)), C1(gf.VectorDim()),
-      V(gf.VectorDim()), nor(gf.VectorDim())
+                                 mfem::Vector s, const BdrFaceGeometry &geom)
+    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom),
+      E(gf), mat_op(op), ts(ti), epsilon(ei), side(std::move(s))
   {
+    MFEM_VERIFY(!side.Size() || side.Size() == mesh.SpaceDimension(),
+                "Invalid side vector dimension for DielectricInterfaceCoefficient!");
+    eval = DispatchSpaceDimension(
+        mesh.SpaceDimension(),
+        [](auto dim)
+        {
+          return &DielectricInterfaceCoefficient::template EvalDim<decltype(dim)::value>;
+        });
   }
 
   double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
   {
-    MFEM_ABORT("DielectricInterfaceCoefficient::Eval() is not implemented for this "
-               "interface type!");
-    return 0.0;
+    return (this->*eval)(T, ip);
   }
 };
 
 template <>
-inline double DielectricInterfaceCoefficient<DielectricInterfaceType::MA>::Eval(
+template <int Dim>
+inline double DielectricInterfaceCoefficient<DielectricInterfaceType::MA>::EvalDim(
     mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
 {
   // Get single-sided solution and neighboring element attribute.
-  Initialize(T, ip, V);
-  GetNormal(T, ip, nor);
+  double V[Dim], nor[Dim];
+  mfem::Vector N(nor, Dim);
+  Initialize<Dim>(T, ip, V);
+  bdr_geom.GetNormal(T, ip, N);
 
   // Metal-air interface: 0.5 * t / ϵ_MA * |E_n|² .
-  double Vn = V * nor;
+  const double Vn = fixed::Dot<Dim>(V, nor);
   return 0.5 * ts / epsilon * (Vn * Vn);
 }
 
 template <>
-inline double DielectricInterfaceCoefficient<DielectricInterfaceType::MS>::Eval(
+template <int Dim>
+inline double DielectricInterfaceCoefficient<DielectricInterfaceType::MS>::EvalDim(
     mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
 {
   // Get single-sided solution and neighboring element attribute.
-  int attr = Initialize(T, ip, V);
-  GetNormal(T, ip, nor);
+  double V[Dim], nor[Dim];
+  mfem::Vector N(nor, Dim);
+  const int attr = Initialize<Dim>(T, ip, V);
+  bdr_geom.GetNormal(T, ip, N);
 
   // Metal-substrate interface: 0.5 * t * (ϵ_S)² / ϵ_MS * |E_n|² .
-  const double Vn = V * nor;
-  const double epsilon_S = mat_op.GetPermittivityReal(attr).InnerProduct(nor, nor);
+  const double Vn = fixed::Dot<Dim>(V, nor);
+  const double epsilon_S =
+      fixed::InnerProduct<Dim>(mat_op.GetPermittivityReal(attr).Data(), nor);
   return 0.5 * ts * std::pow(epsilon_S, 2) / epsilon * (Vn * Vn);
 }
 
 template <>
-inline double DielectricInterfaceCoefficient<DielectricInterfaceType::SA>::Eval(
+template <int Dim>
+inline double DielectricInterfaceCoefficient<DielectricInterfaceType::SA>::EvalDim(
     mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
 {
   // Get single-sided solution and neighboring element attribute.
-  Initialize(T, ip, V);
-  GetNormal(T, ip, nor);
+  double V[Dim], nor[Dim];
+  mfem::Vector N(nor, Dim);
+  Initialize<Dim>(T, ip, V);
+  bdr_geom.GetNormal(T, ip, N);
 
   // Substrate-air interface: 0.5 * t * (ϵ_SA * |E_t|² + 1 / ϵ_MS * |E_n|²) .
-  double Vn = V * nor;
-  add(V, -Vn, nor, V);
-  return 0.5 * ts * (epsilon * (V * V) + (Vn * Vn) / epsilon);
+  const double Vn = fixed::Dot<Dim>(V, nor);
+  for (int i = 0; i < Dim; i++)
+  {
+    V[i] -= Vn * nor[i];
+  }
+  return 0.5 * ts * (epsilon * fixed::Dot<Dim>(V, V) + (Vn * Vn) / epsilon);
 }
 
 template <>
-inline double DielectricInterfaceCoefficient<DielectricInterfaceType::DEFAULT>::Eval(
+template <int Dim>
+inline double DielectricInterfaceCoefficient<DielectricInterfaceType::DEFAULT>::EvalDim(
     mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
 {
   // Get single-sided solution and neighboring element attribute.
-  Initialize(T, ip, V);
+  double V[Dim];
+  Initialize<Dim>(T, ip, V);
 
   // No specific interface, use full field evaluation: 0.5 * t * ϵ * |E|² .
-  return 0.5 * ts * epsilon * (V * V);
+  return 0.5 * ts * epsilon * fixed::Dot<Dim>(V, V);
 }
 
 // Returns the property value of the material for the given index. When called on a
@@ -376,75 +602,82 @@ public:
   {
   }
 
-  void Eval(mfem::DenseMatrix &K, mfem::ElementTransformation &T,
-            const mfem::IntegrationPoint &ip) override
+  int GetAttributeMax() const { return mat_op.GetAttributeMax(); }
+
+  // Evaluate the (scaled) material property for the given domain attribute.
+  void Eval(mfem::DenseMatrix &K, int attr) const
   {
     MFEM_ABORT("MaterialPropertyCoefficient::Eval() is not implemented for this "
                "material property type!");
   }
+
+  void Eval(mfem::DenseMatrix &K, mfem::ElementTransformation &T,
+            const mfem::IntegrationPoint &ip) override
+  {
+    Eval(K, GetAttribute(T));
+  }
 };
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::INV_PERMEABILITY>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetInvPermeability(GetAttribute(T));
+  K = mat_op.GetInvPermeability(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_REAL>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetPermittivityReal(GetAttribute(T));
+  K = mat_op.GetPermittivityReal(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_IMAG>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetPermittivityImag(GetAttribute(T));
+  K = mat_op.GetPermittivityImag(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::PERMITTIVITY_ABS>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetPermittivityAbs(GetAttribute(T));
+  K = mat_op.GetPermittivityAbs(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::CONDUCTIVITY>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetConductivity(GetAttribute(T));
+  K = mat_op.GetConductivity(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::INV_LONDON_DEPTH>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetInvLondonDepth(GetAttribute(T));
+  K = mat_op.GetInvLondonDepth(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::INV_Z0>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  K = mat_op.GetInvImpedance(GetAttribute(T));
+  K = mat_op.GetInvImpedance(attr);
   K *= coef;
 }
 
 template <>
 inline void MaterialPropertyCoefficient<MaterialPropertyType::INV_PERMEABILITY_C0>::Eval(
-    mfem::DenseMatrix &K, mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
+    mfem::DenseMatrix &K, int attr) const
 {
-  const int attr = GetAttribute(T);
   K.SetSize(height, width);
   Mult(mat_op.GetInvPermeability(attr), mat_op.GetLightSpeed(attr), K);
   K *= coef;
@@ -477,8 +710,12 @@ private:
           GridFunctionType;
   const GridFunctionType &U;
   const MaterialOperator &mat_op;
-  mutable mfem::Vector V;
 
+  // Implementation of Eval for the spatial dimension of the mesh, resolved on construction.
+  double (EnergyDensityCoefficient::*eval)(mfem::ElementTransformation &,
+                                           const mfem::IntegrationPoint &);
+
+  template <int Dim>
   double GetLocalEnergyDensity(mfem::ElementTransformation &T,
                                const mfem::IntegrationPoint &ip, int attr)
   {
@@ -488,20 +725,13 @@ private:
     return 0.0;
   }
 
-public:
-  EnergyDensityCoefficient(const GridFunctionType &gf, const MaterialOperator &op,
-                           const std::map<int, int> &l2s)
-    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s),
-      U(gf), mat_op(op), V(gf.ParFESpace()->GetParMesh()->SpaceDimension())
-  {
-  }
-
-  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  template <int Dim>
+  double EvalDim(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip)
   {
     if (T.ElementType == mfem::ElementTransformation::ELEMENT)
     {
       T.SetIntPoint(&ip);
-      return GetLocalEnergyDensity(T, ip, mesh.GetAttribute(T.ElementNo));
+      return GetLocalEnergyDensity<Dim>(T, ip, mesh.GetAttribute(T.ElementNo));
     }
     if (T.ElementType == mfem::ElementTransformation::BDR_ELEMENT)
     {
@@ -514,19 +744,36 @@ public:
       if (T2 &&
           mat_op.GetLightSpeedMax(T2->Attribute) < mat_op.GetLightSpeedMin(T1->Attribute))
       {
-        return GetLocalEnergyDensity(*T2, T2->GetIntPoint(), T2->Attribute);
+        return GetLocalEnergyDensity<Dim>(*T2, T2->GetIntPoint(), T2->Attribute);
       }
       else
       {
-        return GetLocalEnergyDensity(*T1, T1->GetIntPoint(), T1->Attribute);
+        return GetLocalEnergyDensity<Dim>(*T1, T1->GetIntPoint(), T1->Attribute);
       }
     }
     MFEM_ABORT("Unsupported element type in EnergyDensityCoefficient!");
     return 0.0;
   }
+
+public:
+  EnergyDensityCoefficient(const GridFunctionType &gf, const MaterialOperator &op,
+                           const BdrFaceGeometry &geom)
+    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom),
+      U(gf), mat_op(op)
+  {
+    eval = DispatchSpaceDimension(
+        mesh.SpaceDimension(), [](auto dim)
+        { return &EnergyDensityCoefficient::template EvalDim<decltype(dim)::value>; });
+  }
+
+  double Eval(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip) override
+  {
+    return (this->*eval)(T, ip);
+  }
 };
 
 template <>
+template <int Dim>
 inline double
 EnergyDensityCoefficient<EnergyDensityType::ELECTRIC, EnergyDensityValueType::COMPLEX>::
     GetLocalEnergyDensity(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
@@ -534,67 +781,87 @@ EnergyDensityCoefficient<EnergyDensityType::ELECTRIC, EnergyDensityValueType::CO
 {
   // Only the real part of the permittivity contributes to the energy (imaginary part
   // cancels out in the inner product due to symmetry).
+  double V_data[Dim];
+  mfem::Vector V(V_data, Dim);
+  const double *epsilon = mat_op.GetPermittivityReal(attr).Data();
   U.real().GetVectorValue(T, ip, V);
-  double res = mat_op.GetPermittivityReal(attr).InnerProduct(V, V);
+  double res = fixed::InnerProduct<Dim>(epsilon, V_data);
   U.imag().GetVectorValue(T, ip, V);
-  res += mat_op.GetPermittivityReal(attr).InnerProduct(V, V);
+  res += fixed::InnerProduct<Dim>(epsilon, V_data);
   return 0.5 * res;
 }
 
 template <>
+template <int Dim>
 inline double
 EnergyDensityCoefficient<EnergyDensityType::ELECTRIC, EnergyDensityValueType::REAL>::
     GetLocalEnergyDensity(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
                           int attr)
 {
+  double V_data[Dim];
+  mfem::Vector V(V_data, Dim);
   U.GetVectorValue(T, ip, V);
-  return 0.5 * mat_op.GetPermittivityReal(attr).InnerProduct(V, V);
+  return 0.5 * fixed::InnerProduct<Dim>(mat_op.GetPermittivityReal(attr).Data(), V_data);
 }
 
 template <>
+template <int Dim>
 inline double EnergyDensityCoefficient<EnergyDensityType::ELECTRIC_LOSS,
                                        EnergyDensityValueType::COMPLEX>::
     GetLocalEnergyDensity(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
                           int attr)
 {
+  double V_data[Dim];
+  mfem::Vector V(V_data, Dim);
+  const double *epsilon = mat_op.GetPermittivityImag(attr).Data();
   U.real().GetVectorValue(T, ip, V);
-  double res = mat_op.GetPermittivityImag(attr).InnerProduct(V, V);
+  double res = fixed::InnerProduct<Dim>(epsilon, V_data);
   U.imag().GetVectorValue(T, ip, V);
-  res += mat_op.GetPermittivityImag(attr).InnerProduct(V, V);
+  res += fixed::InnerProduct<Dim>(epsilon, V_data);
   return -0.5 * res;
 }
 
 template <>
+template <int Dim>
 inline double
 EnergyDensityCoefficient<EnergyDensityType::ELECTRIC_LOSS, EnergyDensityValueType::REAL>::
     GetLocalEnergyDensity(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
                           int attr)
 {
+  double V_data[Dim];
+  mfem::Vector V(V_data, Dim);
   U.GetVectorValue(T, ip, V);
-  return -0.5 * mat_op.GetPermittivityImag(attr).InnerProduct(V, V);
+  return -0.5 * fixed::InnerProduct<Dim>(mat_op.GetPermittivityImag(attr).Data(), V_data);
 }
 
 template <>
+template <int Dim>
 inline double
 EnergyDensityCoefficient<EnergyDensityType::MAGNETIC, EnergyDensityValueType::COMPLEX>::
     GetLocalEnergyDensity(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
                           int attr)
 {
+  double V_data[Dim];
+  mfem::Vector V(V_data, Dim);
+  const double *muinv = mat_op.GetInvPermeability(attr).Data();
   U.real().GetVectorValue(T, ip, V);
-  double res = mat_op.GetInvPermeability(attr).InnerProduct(V, V);
+  double res = fixed::InnerProduct<Dim>(muinv, V_data);
   U.imag().GetVectorValue(T, ip, V);
-  res += mat_op.GetInvPermeability(attr).InnerProduct(V, V);
+  res += fixed::InnerProduct<Dim>(muinv, V_data);
   return 0.5 * res;
 }
 
 template <>
+template <int Dim>
 inline double
 EnergyDensityCoefficient<EnergyDensityType::MAGNETIC, EnergyDensityValueType::REAL>::
     GetLocalEnergyDensity(mfem::ElementTransformation &T, const mfem::IntegrationPoint &ip,
                           int attr)
 {
+  double V_data[Dim];
+  mfem::Vector V(V_data, Dim);
   U.GetVectorValue(T, ip, V);
-  return 0.5 * mat_op.GetInvPermeability(attr).InnerProduct(V, V);
+  return 0.5 * fixed::InnerProduct<Dim>(mat_op.GetInvPermeability(attr).Data(), V_data);
 }
 
 // Returns the local field evaluated on a boundary element. For internal boundary elements,
@@ -609,9 +876,9 @@ private:
 
 public:
   BdrFieldVectorCoefficient(const mfem::ParGridFunction &gf, const MaterialOperator &op,
-                            const std::map<int, int> &l2s)
+                            const BdrFaceGeometry &geom)
     : mfem::VectorCoefficient(gf.ParFESpace()->GetParMesh()->SpaceDimension()),
-      BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s), U(gf), mat_op(op)
+      BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom), U(gf), mat_op(op)
   {
   }
 
@@ -644,8 +911,8 @@ private:
 
 public:
   BdrFieldCoefficient(const mfem::ParGridFunction &gf, const MaterialOperator &op,
-                      const std::map<int, int> &l2s)
-    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), l2s),
+                      const BdrFaceGeometry &geom)
+    : mfem::Coefficient(), BdrGridFunctionCoefficient(*gf.ParFESpace()->GetParMesh(), geom),
       U(gf), mat_op(op)
   {
   }
@@ -670,6 +937,91 @@ public:
   }
 };
 
+inline BdrFaceGeometry::BdrFaceGeometry(mfem::ParMesh &msh) : mesh(msh)
+{
+  // Construct shared face mapping, and make sure the face-neighbor elements are available
+  // for the numbering of the neighboring elements on shared faces.
+  mesh.ExchangeFaceNbrData();
+  std::vector<int> local_to_shared(mesh.GetNumFaces(), -1);
+  for (int i = 0; i < mesh.GetNSharedFaces(); i++)
+  {
+    local_to_shared[mesh.GetSharedFace(i)] = i;
+  }
+
+  // Boundary elements with a constant Jacobian are the straight-sided simplices of a mesh
+  // without high-order nodes.
+  const int nbe = mesh.GetNBE(), ne = mesh.GetNE(), sdim = mesh.SpaceDimension();
+  const bool linear = (mesh.GetNodes() == nullptr);
+  face.resize(nbe);
+  orientation.resize(nbe);
+  shared_face.resize(nbe);
+  elem1.resize(nbe);
+  elem2.resize(nbe);
+  C1.resize(nbe * sdim);
+  normal.resize(nbe * sdim, 0.0);
+  affine.resize(nbe);
+  double CF_data[3];
+  mfem::Vector CF(CF_data, sdim);
+  for (int be = 0; be < nbe; be++)
+  {
+    int i, o;
+    int iel1, iel2, info1, info2;
+    mesh.GetBdrElementFace(be, &i, &o);
+    mesh.GetFaceElements(i, &iel1, &iel2);
+    mesh.GetFaceInfos(i, &info1, &info2);
+    face[be] = i;
+    orientation[be] = o;
+    elem1[be] = iel1;
+    if (info2 >= 0 && iel2 < 0)
+    {
+      // Face is shared with another subdomain.
+      shared_face[be] = local_to_shared[i];
+      elem2[be] = ne - 1 - iel2;
+    }
+    else
+    {
+      // Face is either internal to the subdomain, or a true one-sided boundary.
+      shared_face[be] = -1;
+      elem2[be] = (info2 >= 0) ? iel2 : -1;
+    }
+
+    // Vector from the center of the face to the center of element 1.
+    mfem::Vector C(C1.data() + be * sdim, sdim);
+    mfem::ElementTransformation &TF = *mesh.GetFaceTransformation(i);
+    TF.Transform(mfem::Geometries.GetCenter(mesh.GetFaceGeometry(i)), CF);
+    mfem::ElementTransformation &T1 = *mesh.GetElementTransformation(iel1);
+    T1.Transform(mfem::Geometries.GetCenter(mesh.GetElementGeometry(iel1)), C);
+    C -= CF;  // Points into element 1 from the face
+
+    const mfem::Geometry::Type geom = mesh.GetBdrElementGeometry(be);
+    affine[be] =
+        linear && (geom == mfem::Geometry::SEGMENT || geom == mfem::Geometry::TRIANGLE);
+    if (affine[be])
+    {
+      mfem::Vector nor(normal.data() + be * sdim, sdim);
+      BdrGridFunctionCoefficient::GetNormal(*mesh.GetBdrElementTransformation(be),
+                                            mfem::Geometries.GetCenter(geom), nor);
+    }
+  }
+}
+
+inline void BdrFaceGeometry::GetNormal(mfem::ElementTransformation &T,
+                                       const mfem::IntegrationPoint &ip,
+                                       mfem::Vector &nor) const
+{
+  MFEM_ASSERT(T.ElementType == mfem::ElementTransformation::BDR_ELEMENT,
+              "Unexpected element type in BdrFaceGeometry::GetNormal!");
+  if (!affine[T.ElementNo])
+  {
+    BdrGridFunctionCoefficient::GetNormal(T, ip, nor);
+    return;
+  }
+  const int sdim = T.GetSpaceDim();
+  nor.SetSize(sdim);
+  std::copy(normal.data() + T.ElementNo * sdim, normal.data() + (T.ElementNo + 1) * sdim,
+            nor.GetData());
+}
+
 // From mfem::GridFunction::GetVectorValue.
 inline mfem::IntegrationPoint
 BdrGridFunctionCoefficient::be_to_bfe(mfem::Geometry::Type geom, int o,
@@ -733,43 +1085,27 @@ inline void BdrGridFunctionCoefficient::GetElementTransformations(
   MFEM_VERIFY(T.ElementType == mfem::ElementTransformation::BDR_ELEMENT,
               "Unexpected element type in BdrGridFunctionCoefficient!");
   MFEM_VERIFY(&mesh == T.mesh, "Invalid mesh for BdrGridFunctionCoefficient!");
-  int i, o;
-  int iel1, iel2, info1, info2;
-  mesh.GetBdrElementFace(T.ElementNo, &i, &o);
-  mesh.GetFaceElements(i, &iel1, &iel2);
-  mesh.GetFaceInfos(i, &info1, &info2);
-
-  mfem::FaceElementTransformations *FET;
-  if (info2 >= 0 && iel2 < 0)
-  {
-    // Face is shared with another subdomain.
-    const int &ishared = local_to_shared.at(i);
-    FET = mesh.GetSharedFaceTransformations(ishared);
-  }
-  else
-  {
-    // Face is either internal to the subdomain, or a true one-sided boundary.
-    FET = mesh.GetFaceElementTransformations(i);
-  }
+  const int be = T.ElementNo;
+  const int ishared = bdr_geom.GetSharedFace(be);
+  mfem::FaceElementTransformations *FET =
+      (ishared >= 0) ? mesh.GetSharedFaceTransformations(ishared)
+                     : mesh.GetFaceElementTransformations(bdr_geom.GetFace(be));
 
   // Boundary elements and boundary faces may have different orientations so adjust the
   // integration point if necessary. See mfem::GridFunction::GetValue and GetVectorValue.
-  mfem::IntegrationPoint fip = be_to_bfe(FET->GetGeometryType(), o, ip);
+  mfem::IntegrationPoint fip =
+      be_to_bfe(FET->GetGeometryType(), bdr_geom.GetOrientation(be), ip);
   FET->SetAllIntPoints(&fip);
   T1 = &FET->GetElement1Transformation();
-  T2 = (info2 >= 0) ? &FET->GetElement2Transformation() : nullptr;
+  T2 = (bdr_geom.GetElement2(be) >= 0) ? &FET->GetElement2Transformation() : nullptr;
 
   // If desired, get vector pointing from center of boundary element into element 1 for
   // orientations.
   if (C1)
   {
-    mfem::Vector CF(T.GetSpaceDim());
-    mfem::ElementTransformation &TF = *mesh.GetFaceTransformation(i);
-    TF.Transform(mfem::Geometries.GetCenter(mesh.GetFaceGeometry(i)), CF);
-
-    C1->SetSize(T.GetSpaceDim());
-    T1->Transform(mfem::Geometries.GetCenter(T1->GetGeometryType()), *C1);
-    *C1 -= CF;  // Points into element 1 from the face
+    const int sdim = T.GetSpaceDim();
+    C1->SetSize(sdim);
+    std::copy(bdr_geom.GetC1(be), bdr_geom.GetC1(be) + sdim, C1->GetData());
   }
 }
 
@@ -784,6 +1120,65 @@ inline void BdrGridFunctionCoefficient::GetNormal(mfem::ElementTransformation &T
   normal /= normal.Norml2();
 }
 
+template <typename F>
+inline void
+BdrGridFunctionQuadrature::ForEachPoint(const mfem::ParFiniteElementSpace &fespace,
+                                        const mfem::Array<int> &attr_marker, F &&f)
+{
+  double nor_data[3], C1_data[3];
+  mfem::Vector nor(nor_data, mesh.SpaceDimension()), C1(C1_data, mesh.SpaceDimension());
+  for (int be = 0; be < mesh.GetNBE(); be++)
+  {
+    const int attr = mesh.GetBdrAttribute(be);
+    if (attr > attr_marker.Size() || !attr_marker[attr - 1])
+    {
+      continue;
+    }
+    const mfem::FiniteElement &fe = *fespace.GetBE(be);
+    mfem::ElementTransformation &T = *mesh.GetBdrElementTransformation(be);
+    const mfem::IntegrationRule &ir =
+        mfem::IntRules.Get(fe.GetGeomType(), 2 * fe.GetOrder() + T.OrderW());
+    for (int q = 0; q < ir.GetNPoints(); q++)
+    {
+      const mfem::IntegrationPoint &ip = ir.IntPoint(q);
+      mfem::ElementTransformation *T1, *T2;
+      GetElementTransformations(T, ip, T1, T2, &C1);
+      T.SetIntPoint(&ip);
+      bdr_geom.GetNormal(T, ip, nor);
+      f(be, T, ip.weight * T.Weight(), nor_data, C1_data, *T1, T2);
+    }
+  }
+}
+
+inline mfem::DofTransformation *
+BdrGridFunctionQuadrature::GetElementVShape(const mfem::ParFiniteElementSpace &fespace,
+                                            mfem::ElementTransformation &T,
+                                            mfem::DenseMatrix &vshape,
+                                            mfem::Array<int> &vdofs)
+{
+  const int ne = fespace.GetParMesh()->GetNE();
+  const mfem::FiniteElement *fe;
+  mfem::DofTransformation *doftrans;
+  if (T.ElementNo < ne)
+  {
+    fe = fespace.GetFE(T.ElementNo);
+    doftrans = fespace.GetElementVDofs(T.ElementNo, vdofs);
+  }
+  else
+  {
+    const int offset = fespace.GetVSize();
+    fe = fespace.GetFaceNbrFE(T.ElementNo - ne);
+    doftrans = fespace.GetFaceNbrElementVDofs(T.ElementNo - ne, vdofs);
+    for (auto &vdof : vdofs)
+    {
+      vdof = (vdof >= 0) ? vdof + offset : vdof - offset;
+    }
+  }
+  vshape.SetSize(fe->GetDof(), T.GetSpaceDim());
+  fe->CalcVShape(T, vshape);
+  return doftrans;
+}
+
 // Wraps a mfem::MatrixCoefficient to compute a scalar coefficient as nᵀ M n. Only works
 // for square matrix coefficients of size equal to the spatial dimension.
 class NormalProjectedCoefficient : public mfem::Coefficient
@@ -856,6 +1251,74 @@ public:
   }
 };
 
+// Piecewise constant matrix-valued coefficient stored as a flattened table of height x
+// width matrices indexed by attribute, which is evaluated with a single lookup. Attributes
+// without an entry evaluate to zero.
+class PWConstMatrixCoefficient : public mfem::MatrixCoefficient
+{
+private:
+  // Column-major entries of the matrix for attribute i are stored contiguously at offset
+  // (i - 1) * height * width.
+  std::vector<double> table;
+
+  double *GetData(int attr)
+  {
+    const std::size_t n = height * width;
+    if (table.size() < attr * n)
+    {
+      table.resize(attr * n, 0.0);
+    }
+    return table.data() + (attr - 1) * n;
+  }
+
+public:
+  PWConstMatrixCoefficient(int d) : mfem::MatrixCoefficient(d) {}
+  PWConstMatrixCoefficient(int h, int w) : mfem::MatrixCoefficient(h, w) {}
+
+  bool empty() const { return table.empty(); }
+
+  // Add coef * K to the value for the given attribute.
+  void AddValue(int attr, double coef, const mfem::DenseMatrix &K)
+  {
+    MFEM_VERIFY(K.Height() == height && K.Width() == width,
+                "Invalid DenseMatrix dimensions for PWConstMatrixCoefficient!");
+    double *data = GetData(attr);
+    const double *KD = K.Data();
+    for (int i = 0; i < height * width; i++)
+    {
+      data[i] += coef * KD[i];
+    }
+  }
+
+  // Add coef * I to the value for the given attribute.
+  void AddValue(int attr, double coef)
+  {
+    double *data = GetData(attr);
+    for (int i = 0; i < std::min(height, width); i++)
+    {
+      data[i * height + i] += coef;
+    }
+  }
+
+  void Eval(mfem::DenseMatrix &K, int attr) const
+  {
+    const std::size_t n = height * width;
+    K.SetSize(height, width);
+    if (table.size() < attr * n)
+    {
+      K = 0.0;
+      return;
+    }
+    K = table.data() + (attr - 1) * n;
+  }
+
+  void Eval(mfem::DenseMatrix &K, mfem::ElementTransformation &T,
+            const mfem::IntegrationPoint &ip) override
+  {
+    Eval(K, T.Attribute);
+  }
+};
+
 class SumCoefficient : public mfem::Coefficient
 {
 private:
@@ -980,11 +1443,25 @@ public:
   }
 };
 
+// Sum of matrix-valued coefficients, each optionally restricted to a set of attributes.
+// Piecewise constant contributions (material properties on domain elements, and constant
+// or piecewise constant scalar coefficients restricted to a set of attributes) are
+// collapsed into attribute-indexed tables when added, so the common case of a sum of
+// material properties costs a single lookup per evaluation. All other coefficients are
+// evaluated individually.
 class SumMatrixCoefficient : public mfem::MatrixCoefficient
 {
 private:
   std::vector<std::pair<std::unique_ptr<mfem::MatrixCoefficient>, const mfem::Array<int> *>>
       c;
+
+  // Tabulated contributions for domain and boundary elements. Material property
+  // coefficients are only tabulated for domain elements since on boundary elements they
+  // take the value from the neighboring element, so they are also stored in c_mat for
+  // evaluation on boundary elements.
+  PWConstMatrixCoefficient pwc, bdr_pwc;
+  std::vector<std::pair<std::unique_ptr<mfem::MatrixCoefficient>, const mfem::Array<int> *>>
+      c_mat;
   mutable mfem::DenseMatrix M;
 
   void AddCoefficient(std::unique_ptr<mfem::MatrixCoefficient> &&coef,
@@ -1004,11 +1481,51 @@ private:
                    marker);
   }
 
+  template <MaterialPropertyType Type>
+  void AddCoefficient(std::unique_ptr<MaterialPropertyCoefficient<Type>> &&coef,
+                      const mfem::Array<int> *marker)
+  {
+    MFEM_VERIFY(coef->GetHeight() == height && coef->GetWidth() == width,
+                "Invalid MatrixCoefficient dimensions for SumMatrixCoefficient!");
+    int attr_max = coef->GetAttributeMax();
+    if (marker)
+    {
+      attr_max = std::min(attr_max, marker->Size());
+    }
+    for (int attr = 1; attr <= attr_max; attr++)
+    {
+      if (!marker || (*marker)[attr - 1])
+      {
+        coef->Eval(M, attr);
+        pwc.AddValue(attr, 1.0, M);
+      }
+    }
+    c_mat.emplace_back(std::move(coef), marker);
+  }
+
+  template <typename F>
+  void AddPWConstCoefficient(int attr_max, const F &coef, const mfem::Array<int> &marker)
+  {
+    MFEM_VERIFY(width == height, "Scalar coefficients can only be added to square "
+                                 "SumMatrixCoefficient objects!");
+    for (int attr = 1; attr <= std::min(attr_max, marker.Size()); attr++)
+    {
+      if (marker[attr - 1])
+      {
+        pwc.AddValue(attr, coef(attr));
+        bdr_pwc.AddValue(attr, coef(attr));
+      }
+    }
+  }
+
 public:
-  SumMatrixCoefficient(int d) : mfem::MatrixCoefficient(d), M(d) {}
-  SumMatrixCoefficient(int h, int w) : mfem::MatrixCoefficient(h, w), M(h, w) {}
+  SumMatrixCoefficient(int d) : mfem::MatrixCoefficient(d), pwc(d), bdr_pwc(d), M(d) {}
+  SumMatrixCoefficient(int h, int w)
+    : mfem::MatrixCoefficient(h, w), pwc(h, w), bdr_pwc(h, w), M(h, w)
+  {
+  }
 
-  bool empty() const { return c.empty(); }
+  bool empty() const { return c.empty() && c_mat.empty() && pwc.empty(); }
 
   void AddCoefficient(std::unique_ptr<mfem::MatrixCoefficient> &&coef)
   {
@@ -1032,6 +1549,33 @@ public:
     AddCoefficient(std::move(coef), &marker);
   }
 
+  template <MaterialPropertyType Type>
+  void AddCoefficient(std::unique_ptr<MaterialPropertyCoefficient<Type>> &&coef)
+  {
+    AddCoefficient(std::move(coef), nullptr);
+  }
+
+  template <MaterialPropertyType Type>
+  void AddCoefficient(std::unique_ptr<MaterialPropertyCoefficient<Type>> &&coef,
+                      const mfem::Array<int> &marker)
+  {
+    AddCoefficient(std::move(coef), &marker);
+  }
+
+  void AddCoefficient(std::unique_ptr<mfem::ConstantCoefficient> &&coef,
+                      const mfem::Array<int> &marker)
+  {
+    AddPWConstCoefficient(
+        marker.Size(), [&coef](int) { return coef->constant; }, marker);
+  }
+
+  void AddCoefficient(std::unique_ptr<mfem::PWConstCoefficient> &&coef,
+                      const mfem::Array<int> &marker)
+  {
+    AddPWConstCoefficient(
+        coef->GetNConst(), [&coef](int attr) { return (*coef)(attr); }, marker);
+  }
+
   void SetTime(double t) override
   {
     mfem::MatrixCoefficient::SetTime(t);
@@ -1044,8 +1588,22 @@ public:
   void Eval(mfem::DenseMatrix &K, mfem::ElementTransformation &T,
             const mfem::IntegrationPoint &ip) override
   {
-    K.SetSize(height, width);
-    K = 0.0;
+    if (T.ElementType == mfem::ElementTransformation::ELEMENT)
+    {
+      pwc.Eval(K, T.Attribute);
+    }
+    else
+    {
+      bdr_pwc.Eval(K, T.Attribute);
+      for (auto &[coef, marker] : c_mat)
+      {
+        if (!marker || (*marker)[T.Attribute - 1])
+        {
+          coef->Eval(M, T, ip);
+          K += M;
+        }
+      }
+    }
     for (auto &[coef, marker] : c)
     {
       if (!marker || (*marker)[T.Attribute - 1])
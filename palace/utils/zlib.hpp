@@ -4,6 +4,7 @@
 #ifndef PALACE_ZLIB_HPP
 #define PALACE_ZLIB_HPP
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -22,9 +23,14 @@ namespace palace::utils
 // String compression using zlib (https://panthema.net/2007/0328-ZLibString.html).
 //
 
+// Compression levels, equivalent to Z_BEST_SPEED and Z_BEST_COMPRESSION, which are also
+// defined when zlib is not available.
+inline constexpr int ZLIB_BEST_SPEED = 1, ZLIB_BEST_COMPRESSION = 9;
+
 // Compress a STL string using zlib with given compression level and return the binary
-// data.
-std::string CompressString(const std::string &str, int level = Z_BEST_COMPRESSION)
+// data. Without zlib, the string is returned unchanged.
+inline std::string CompressString(const std::string &str,
+                                  int level = ZLIB_BEST_COMPRESSION)
 {
 #if defined(MFEM_USE_ZLIB)
   z_stream zs;
@@ -72,7 +78,7 @@ std::string CompressString(const std::string &str, int level = Z_BEST_COMPRESSIO
 }
 
 // Decompress an STL string using zlib and return the original data.
-std::string DecompressString(const std::string &str)
+inline std::string DecompressString(const std::string &str)
 {
 #if defined(MFEM_USE_ZLIB)
   z_stream zs;